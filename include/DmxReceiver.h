@@ -0,0 +1,104 @@
+/*
+  DmxReceiver.h
+  Realtime E1.31 (sACN) and Art-Net receiver.
+
+  DMX universes received over UDP are mapped onto the LEDs in order:
+  universe firstUniverse carries LEDs 0-169 as r, g, b channel triplets,
+  the next universe LEDs 170-339, and so on. E1.31 is received as
+  unicast on port 5568, Art-Net (ArtDmx) on port 6454.
+
+  Only the packet headers are copied out of the UDP receive buffer; the
+  channel data is read straight into a slot of a small ring of frames,
+  the jitter buffer. A frame is complete once every universe has been
+  received, or when a universe repeats before that (sources that skip
+  unchanged universes). Completed frames are played out one per source
+  frame period, estimated from their arrival times, after DMX_JITTER_DEPTH
+  frames have been buffered, so arrival jitter does not show on the strip.
+
+  When the source sends synchronisation packets (ArtSync, or E1.31 data
+  carrying a synchronisation address followed by the matching sync
+  packet) a frame is only complete when its sync packet arrives, and it
+  is shown at once, bypassing the jitter delay, so that every controller
+  listening to the same sync latches the same frame. Without a sync
+  packet for DMX_SYNC_TIMEOUT_MS the receiver falls back to free running.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <FastLED.h>
+
+#define DMX_ARTNET_PORT 6454
+#define DMX_E131_PORT 5568
+#define DMX_LEDS_PER_UNIVERSE 170 // 510 of the 512 channels
+#define DMX_MAX_UNIVERSES 32
+
+#ifndef DMX_JITTER_SLOTS
+#define DMX_JITTER_SLOTS 3 // frames held: one being received, the rest queued
+#endif
+#ifndef DMX_JITTER_DEPTH
+#define DMX_JITTER_DEPTH 1 // queued frames before playout starts
+#endif
+#ifndef DMX_SYNC_TIMEOUT_MS
+#define DMX_SYNC_TIMEOUT_MS 4000
+#endif
+#ifndef DMX_MAX_PACKETS
+#define DMX_MAX_PACKETS 8 // packets received per handle() call
+#endif
+
+enum DmxProtocol : uint8_t
+{
+  DMX_OFF,
+  DMX_ARTNET,
+  DMX_E131
+};
+
+class DmxReceiver
+{
+public:
+  DmxReceiver() : frames(0), overruns(0), underruns(0), syncs(0), _protocol(DMX_OFF), _ring(nullptr) {}
+  ~DmxReceiver() { end(); }
+
+  bool begin(DmxProtocol protocol, uint16_t count, uint16_t firstUniverse = 1);
+  void end();
+  bool active() const { return _protocol != DMX_OFF; }
+  DmxProtocol protocol() const { return _protocol; }
+
+  // Receive the pending packets into the jitter buffer.
+  void handle();
+
+  // Copy the frame that is due, if any, into leds. Returns true when
+  // leds was changed.
+  bool render(CRGB *leds);
+
+  uint32_t frames;    // frames completed
+  uint32_t overruns;  // queued frames dropped because the buffer was full
+  uint32_t underruns; // playout stalls on an empty buffer
+  uint32_t syncs;     // sync packets received
+
+private:
+  bool _receiveArtnet(int size);
+  bool _receiveE131(int size);
+  void _receiveUniverse(uint16_t universe, uint16_t channels);
+  void _complete(bool synced);
+  CRGB *_slot(uint8_t i) const { return _ring + (size_t)((_read + i) % DMX_JITTER_SLOTS) * _count; }
+
+  WiFiUDP _udp;
+  DmxProtocol _protocol;
+  CRGB *_ring;
+  uint16_t _count;
+  uint16_t _firstUniverse;
+  uint8_t _universes;
+  uint32_t _received; // universes of the frame being received
+
+  uint8_t _read;   // oldest queued frame
+  uint8_t _queued; // completed frames; the slot after them is being received
+  bool _latch;     // a synced frame is waiting to be shown
+  bool _playing;
+
+  uint16_t _syncAddress; // E1.31 synchronisation universe announced by the source
+  uint32_t _lastSync;
+  uint32_t _lastFrame;
+  uint32_t _period; // source frame period in ms, smoothed
+  uint32_t _nextPlay;
+};
@@ -0,0 +1,54 @@
+/*
+  ResponseWriter.h
+  Append-only HTTP response writer backed by a fixed arena.
+
+  Handlers print into a statically allocated buffer instead of building
+  a String with repeated += concatenation. When the arena fills up it is
+  sent to the client as one HTTP chunk and reused, so the response size
+  is not limited by the arena and no heap block is ever allocated for
+  the body. Only one response is built at a time (the web server is
+  single threaded), so a single shared arena is enough.
+*/
+#pragma once
+
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP8266)
+#include <ESP8266WebServer.h>
+typedef ESP8266WebServer WiFiWebServer;
+#elif defined(ARDUINO_ARCH_ESP32)
+#include <WebServer.h>
+typedef WebServer WiFiWebServer;
+#endif
+
+#ifndef RESPONSE_ARENA_SIZE
+#define RESPONSE_ARENA_SIZE 256 // bytes buffered before a chunk is sent
+#endif
+
+class ResponseWriter : public Print
+{
+public:
+  explicit ResponseWriter(WiFiWebServer &server) : _server(server), _len(0), _started(false) {}
+  ~ResponseWriter() { end(); }
+
+  // Send the status line and headers. The body length is unknown, so
+  // HTTP/1.1 clients get a chunked body and HTTP/1.0 clients a body
+  // terminated by closing the connection.
+  void begin(int code, const char *contentType);
+  void begin(int code, const __FlashStringHelper *contentType);
+
+  // Flush the remaining arena contents and terminate the response.
+  void end();
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t size) override;
+  using Print::write;
+
+private:
+  void _flush();
+
+  WiFiWebServer &_server;
+  size_t _len;
+  bool _started;
+
+  static char _arena[RESPONSE_ARENA_SIZE];
+};
@@ -0,0 +1,73 @@
+/*
+  SparseUpdate.h
+  UDP listener for partial LED updates.
+
+  A controller on the network can change just the LEDs it animates
+  instead of shipping whole frames. Each datagram is written straight
+  from the UDP receive buffer into leds[] between two frames, so the
+  next FastLED.show() sends it. All fields are little endian:
+
+    offset  size  field
+    0       2     magic "LS"
+    2       1     version (1)
+    3       1     flags, reserved (0)
+    4       2     sequence number
+    6       ...   records, until the end of the datagram
+
+  Records:
+
+    0x01 RANGE  start:u16 count:u16 then count * (r, g, b)
+    0x02 RUN    start:u16 count:u16 r g b   (count LEDs of one colour)
+
+  Datagrams carrying a sequence number that is not newer than the last
+  accepted one are dropped as stale, which discards reordered and
+  duplicated packets. After SPARSE_RESYNC_MS without an accepted packet
+  any sequence number is accepted again, so a restarted sender is picked
+  up. A record that would run past the end of leds[] ends the datagram.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <FastLED.h>
+
+#ifndef SPARSE_UDP_PORT
+#define SPARSE_UDP_PORT 21325
+#endif
+#ifndef SPARSE_RESYNC_MS
+#define SPARSE_RESYNC_MS 2000
+#endif
+#ifndef SPARSE_MAX_PACKETS
+#define SPARSE_MAX_PACKETS 8 // datagrams applied per handle() call
+#endif
+
+#define SPARSE_VERSION 1
+#define SPARSE_RECORD_RANGE 0x01
+#define SPARSE_RECORD_RUN 0x02
+
+class SparseUpdate
+{
+public:
+  SparseUpdate() : accepted(0), stale(0), malformed(0), _leds(nullptr), _count(0), _seq(0), _synced(false), _lastAccept(0) {}
+
+  bool begin(CRGB *leds, uint16_t count, uint16_t port = SPARSE_UDP_PORT);
+  void end() { _udp.stop(); }
+
+  // Apply the pending datagrams. Returns true when leds[] was changed.
+  bool handle();
+
+  uint32_t accepted;  // datagrams applied
+  uint32_t stale;     // datagrams dropped for their sequence number
+  uint32_t malformed; // datagrams with a bad header or record
+
+private:
+  bool _apply(int size);
+  bool _read16(uint16_t &v);
+
+  WiFiUDP _udp;
+  CRGB *_leds;
+  uint16_t _count;
+  uint16_t _seq;
+  bool _synced;
+  uint32_t _lastAccept;
+};
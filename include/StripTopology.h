@@ -0,0 +1,134 @@
+/*
+  StripTopology.h
+  Runtime description of the LED strips attached to the controller.
+
+  The topology is read from a JSON file on the filesystem at boot, e.g.
+
+    {
+      "segments": [
+        { "pin": 2, "count": 60, "chipset": "WS2812B", "order": "GRB" },
+        { "pin": 2, "count": 30 },
+        { "pin": 1, "count": 144, "chipset": "SK6812" }
+      ]
+    }
+
+  Pins use the FastLED numbering of the board (Dn on a D1 mini). Segments
+  that share a pin are chained on the same data line and driven by a
+  single controller, so they must use the same chipset and colour order;
+  "chipset" and "order" may be omitted on the later segments of a pin.
+  The LED buffer is allocated once with the exact total length, and
+  segments sharing a pin are laid out contiguously in it.
+
+  With "parallel": true each segment is instead one lane of the ESP8266
+  block clockless controller, and all lanes are clocked out at the same
+  time, dividing the transmit time of a long run by the lane count:
+
+    {
+      "parallel": true,
+      "segments": [
+        { "count": 150 },
+        { "count": 150, "reverse": true },
+        { "count": 120 }
+      ]
+    }
+
+  Lanes are fixed by the hardware to GPIO12, 13, 14, 15, 4 and 5, in that
+  order, so the MAX7219 matrix has to be moved off GPIO12-14 first, and
+  "pin" is ignored. Patterns keep addressing one contiguous leds[] of the
+  total length; before each frame it is scattered into the lane buffer
+  through the per-lane index map, which also pads short lanes and
+  reverses lanes wired from their far end. When every lane is present,
+  full length and forward the map is the identity and leds[] is sent as
+  is. The block controller lives in IRAM, so it is only built when
+  TOPOLOGY_PARALLEL_LANES is set.
+*/
+#pragma once
+
+#include <FastLED.h>
+#include <FS.h>
+
+#ifndef TOPOLOGY_PATH
+#define TOPOLOGY_PATH "/topology.json"
+#endif
+#ifndef TOPOLOGY_MAX_SEGMENTS
+#define TOPOLOGY_MAX_SEGMENTS 8
+#endif
+#ifndef TOPOLOGY_MAX_LEDS
+#define TOPOLOGY_MAX_LEDS 1024
+#endif
+#ifndef TOPOLOGY_JSON_SIZE
+#define TOPOLOGY_JSON_SIZE 1024
+#endif
+#ifndef TOPOLOGY_PARALLEL_LANES
+#define TOPOLOGY_PARALLEL_LANES 0 // lanes of the block controller, 0 leaves it out
+#endif
+#ifndef TOPOLOGY_PARALLEL_ORDER
+#define TOPOLOGY_PARALLEL_ORDER GRB
+#endif
+
+enum StripChipset : uint8_t
+{
+  STRIP_WS2812B,
+  STRIP_WS2811,
+  STRIP_SK6812,
+  STRIP_UNKNOWN
+};
+
+struct StripSegment
+{
+  uint8_t chipset; // StripChipset
+  uint8_t pin;     // FastLED data pin
+  EOrder order;
+  uint16_t offset; // first index of the segment in the LED buffer
+  uint16_t count;
+  bool reverse; // parallel lanes only: index 0 is at the far end of the lane
+};
+
+class StripTopology
+{
+public:
+  StripTopology() : _leds(nullptr), _lanes(nullptr), _count(0), _laneLength(0), _segments(0), _parallel(false) {}
+
+  // Replace the description with a single segment.
+  void reset(uint8_t chipset, uint8_t pin, EOrder order, uint16_t count);
+
+  // Read the segment list from a JSON file. On failure the current
+  // description is left untouched.
+  bool load(FS &fs, const char *path = TOPOLOGY_PATH);
+
+  // Allocate the LED buffer and register one controller per data pin.
+  // Everything is validated before anything is allocated or registered,
+  // so a failed begin() leaves FastLED untouched and can be retried with
+  // another description. Only one begin() may succeed.
+  bool begin();
+
+  CRGB *leds() const { return _leds; }
+  uint16_t count() const { return _count; }
+  uint8_t segments() const { return _segments; }
+  const StripSegment &segment(uint8_t i) const { return _segment[i]; }
+  bool parallel() const { return _parallel; }
+
+  // Position of a leds[] index in the lane buffer (parallel output), or
+  // the index itself otherwise.
+  uint16_t physicalIndex(uint16_t i) const;
+
+  // Copy leds[] into the lane buffer; called by the parallel controller
+  // before each frame. Returns the buffer to send.
+  const CRGB *scatter(const CRGB *data) const;
+
+  static uint8_t chipsetFromName(const char *name);
+  static bool orderFromName(const char *name, EOrder &order);
+
+private:
+  bool _append(StripSegment *list, uint8_t &n, uint8_t chipset, uint8_t pin, EOrder order, uint16_t count);
+  void _layout();
+  bool _beginParallel();
+
+  CRGB *_leds;
+  CRGB *_lanes; // lane buffer, TOPOLOGY_PARALLEL_LANES * _laneLength
+  uint16_t _count;
+  uint16_t _laneLength;
+  uint8_t _segments;
+  bool _parallel;
+  StripSegment _segment[TOPOLOGY_MAX_SEGMENTS];
+};
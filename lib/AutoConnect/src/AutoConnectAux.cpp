@@ -158,6 +158,7 @@ AutoConnectAux::AutoConnectAux(const String& uri, const String& title, const boo
   _uri = uri;
   transferEncoding(PageBuilder::TransferEncoding_t::AUTOCONNECT_HTTP_TRANSFER);
   enableCORS(CORS);
+  _indexElements();
 }
 
 /**
@@ -166,6 +167,7 @@ AutoConnectAux::AutoConnectAux(const String& uri, const String& title, const boo
  */
 AutoConnectAux::~AutoConnectAux() {
   _addonElm.clear();
+  _addonHash.clear();
 }
 
 /**
@@ -184,6 +186,7 @@ AutoConnectElement& AutoConnectAux::_nullElement() {
  */
 void AutoConnectAux::add(AutoConnectElement& addon) {
   _addonElm.push_back(addon);
+  _addonHash.push_back(_hashName(addon.name.c_str()));
   AC_DBG("%s placed on %s\n", addon.name.length() ? addon.name.c_str() : "*noname", uri());
 }
 
@@ -225,18 +228,21 @@ void AutoConnectAux::fetchElement(void) {
  * @return A pointer to the registered AutoConnectElement.
  */
 AutoConnectElement* AutoConnectAux::getElement(const char* name) {
-  for (AutoConnectElement& elm : _addonElm) {
-    if (elm.name.length() == strlen(name)) {
-      const char* p = name;
-      const char* elmName = elm.name.c_str();
-      while (tolower(*p++) == tolower(*elmName++)) {
-        if (!*p)
-          return &elm;
-      }
+  const size_t  len = strlen(name);
+  AutoConnectElement* elm = _findElement(_hashName(name), [&](const String& elmName) {
+    if (elmName.length() != len)
+      return false;
+    const char* p = name;
+    const char* q = elmName.c_str();
+    while (*p && tolower(*p) == tolower(*q)) {
+      p++;
+      q++;
     }
-  }
-  AC_DBG("Element<%s> not registered\n", name);
-  return nullptr;
+    return !*p;
+  });
+  if (!elm)
+    AC_DBG("Element<%s> not registered\n", name);
+  return elm;
 }
 
 /**
@@ -245,18 +251,22 @@ AutoConnectElement* AutoConnectAux::getElement(const char* name) {
  * @return A pointer to the registered AutoConnectElement.
  */
 AutoConnectElement* AutoConnectAux::getElement(const __FlashStringHelper* name) {
-  for (AutoConnectElement& elm : _addonElm) {
-    if (elm.name.length() == strlen_P(reinterpret_cast<PGM_P>(name))) {
-      PGM_P p = reinterpret_cast<PGM_P>(name);
-      const char* elmName = elm.name.c_str();
-      while (tolower(pgm_read_byte(p++)) == tolower(*elmName++)) {
-        if (!pgm_read_byte(p))
-          return &elm;
-      }
+  PGM_P pName = reinterpret_cast<PGM_P>(name);
+  const size_t  len = strlen_P(pName);
+  AutoConnectElement* elm = _findElement(_hashName(pName, true), [&](const String& elmName) {
+    if (elmName.length() != len)
+      return false;
+    PGM_P p = pName;
+    const char* q = elmName.c_str();
+    while (pgm_read_byte(p) && tolower(pgm_read_byte(p)) == tolower(*q)) {
+      p++;
+      q++;
     }
-  }
-  AC_DBG("Element<%s> not registered\n", String(name).c_str());
-  return nullptr;
+    return !pgm_read_byte(p);
+  });
+  if (!elm)
+    AC_DBG("Element<%s> not registered\n", String(name).c_str());
+  return elm;
 }
 
 /**
@@ -265,13 +275,69 @@ AutoConnectElement* AutoConnectAux::getElement(const __FlashStringHelper* name)
  * @return A pointer to the registered AutoConnectElement.
  */
 AutoConnectElement* AutoConnectAux::getElement(const String& name) {
-  for (AutoConnectElement& elm : _addonElm)
-    if (elm.name.equalsIgnoreCase(name))
+  AutoConnectElement* elm = _findElement(_hashName(name.c_str()), [&](const String& elmName) {
+    return elmName.equalsIgnoreCase(name);
+  });
+  if (!elm)
+    AC_DBG("Element<%s> not registered\n", name.c_str());
+  return elm;
+}
+
+/**
+ * Find an element through the name index. Only the elements whose
+ * name hash matches are compared by the name. The elements can be
+ * renamed or rearranged via getElements after they are placed, so
+ * a missed lookup falls back to the comparison of all names and
+ * rebuilds the index when it finds the element in that way.
+ * @param  hash   The name hash to be found.
+ * @param  match  A function that compares the element name.
+ * @return A pointer to the registered AutoConnectElement.
+ */
+AutoConnectElement* AutoConnectAux::_findElement(const uint32_t hash, std::function<bool(const String&)> match) {
+  if (_addonHash.size() != _addonElm.size())
+    _indexElements();
+  for (size_t n = 0; n < _addonHash.size(); n++) {
+    if (_addonHash[n] == hash) {
+      AutoConnectElement& elm = _addonElm[n];
+      if (match(elm.name))
+        return &elm;
+    }
+  }
+  for (AutoConnectElement& elm : _addonElm) {
+    if (match(elm.name)) {
+      _indexElements();
       return &elm;
-  AC_DBG("Element<%s> not registered\n", name.c_str());
+    }
+  }
   return nullptr;
 }
 
+/**
+ * Rebuild the name index of the placed elements.
+ */
+void AutoConnectAux::_indexElements(void) {
+  _addonHash.clear();
+  _addonHash.reserve(_addonElm.size());
+  for (AutoConnectElement& elm : _addonElm)
+    _addonHash.push_back(_hashName(elm.name.c_str()));
+}
+
+/**
+ * Calculate the FNV-1a hash of an element name ignoring the case.
+ * @param  name     An element name.
+ * @param  progmem  The name is stored in PROGMEM.
+ * @return The name hash.
+ */
+uint32_t AutoConnectAux::_hashName(const char* name, const bool progmem) {
+  uint32_t  hash = 2166136261UL;
+  char  c;
+  while ((c = progmem ? pgm_read_byte(name) : *name)) {
+    hash = (hash ^ (uint8_t)tolower(c)) * 16777619UL;
+    name++;
+  }
+  return hash;
+}
+
 /**
  * Validate all AutoConnectInputs value.
  * @return true  Validation successfull
@@ -314,7 +380,9 @@ bool AutoConnectAux::release(const String& name) {
     [&](std::reference_wrapper<AutoConnectElement> const elm) {
       return elm.get().name.equalsIgnoreCase(name);
     });
-  return _addonElm.erase(itr, _addonElm.end()) != _addonElm.end();
+  const bool  rc = _addonElm.erase(itr, _addonElm.end()) != _addonElm.end();
+  _indexElements();
+  return rc;
 }
 
 /**
@@ -728,18 +796,18 @@ PageElement* AutoConnectAux::_setupPage(const String& uri) {
       elm->setMold(FPSTR(_PAGE_AUX));
 
       if (_responsive) {
-        elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_HEAD, mother, std::placeholders::_1));
+        elm->addToken(FPSTR("HEAD"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_ELM_HTML_HEAD));
         elm->addToken(FPSTR("AUX_TITLE"), std::bind(&AutoConnectAux::_injectTitle, this, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_BASE, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_UL"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_UL, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_INPUT_BUTTON"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_INPUT_BUTTON, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_INPUT_TEXT"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_INPUT_TEXT, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_LUXBAR_BODY, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_LUXBAR_HEADER, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_LUXBAR_BGR, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_LUXBAR_ANI, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_LUXBAR_MEDIA, mother, std::placeholders::_1));
-        elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_CSS_LUXBAR_ITEM, mother, std::placeholders::_1));
+        elm->addToken(FPSTR("CSS_BASE"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_BASE));
+        elm->addToken(FPSTR("CSS_UL"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_UL));
+        elm->addToken(FPSTR("CSS_INPUT_BUTTON"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_INPUT_BUTTON));
+        elm->addToken(FPSTR("CSS_INPUT_TEXT"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_INPUT_TEXT));
+        elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_LUXBAR_BODY));
+        elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_LUXBAR_HEADER));
+        elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_LUXBAR_BGR));
+        elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_LUXBAR_ANI));
+        elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_LUXBAR_MEDIA));
+        elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(AutoConnectExt<AutoConnectConfigExt>::_CSS_LUXBAR_ITEM));
         elm->addToken(FPSTR("AUX_CSS"), std::bind(&AutoConnectAux::_insertStyle, this, std::placeholders::_1));
         elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_MENU_PRE, mother, std::placeholders::_1));
         elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectExt<AutoConnectConfigExt>::_token_MENU_LIST, mother, std::placeholders::_1));
@@ -917,6 +985,125 @@ void AutoConnectAux::_storeElements(WebServer* webServer) {
   AC_DBG_DUMB(", elements stored\n");
 }
 
+/**
+ * Load the page and its elements from the table precompiled by
+ * auxtable/auxtable.py instead of parsing JSON, so it needs no
+ * JsonDocument. Attributes other than the value and the peculiar of
+ * each element are the defaults of the element class, as well as when
+ * they are omitted in JSON.
+ * @param  page  The page attributes, which can be stored in PROGMEM.
+ * @return true  The page successfully loaded.
+ * @return false The page contains an element that cannot be placed
+ * from the table.
+ */
+bool AutoConnectAux::load(const ACPage_t& page) {
+  bool  rc = true;
+
+  // The table is read through pgm_read_* so that it can be placed in
+  // PROGMEM, which the ESP8266 cannot access by bytes.
+  _uri = String(FPSTR(pgm_read_ptr(&page.uri)));
+  _title = String(FPSTR(pgm_read_ptr(&page.title)));
+  _menu = pgm_read_byte(&page.menu);
+  _httpAuth = static_cast<AC_AUTH_t>(pgm_read_dword(&page.auth));
+  const ACElementProp_t*  element = reinterpret_cast<const ACElementProp_t*>(pgm_read_ptr(&page.element));
+  const size_t  elements = pgm_read_dword(&page.elements);
+  for (size_t n = 0; n < elements; n++) {
+    AutoConnectElement* elm = _createElement(element[n]);
+    if (elm)
+      add(*elm);
+    else {
+      AC_DBG("%s unknown element type\n", String(FPSTR(pgm_read_ptr(&element[n].name))).c_str());
+      rc = false;
+    }
+  }
+  return rc;
+}
+
+/**
+ * Create an instance from the precompiled AutoConnectElement. The
+ * peculiar is the action of AutoConnectButton, the label of
+ * AutoConnectCheckbox, AutoConnectFile and AutoConnectInput, the range
+ * of AutoConnectRange as "min,max,step", the uri of AutoConnectSubmit
+ * and the style of AutoConnectText.
+ * @param  prop  The element attributes, which can be stored in PROGMEM.
+ * @return A pointer of created AutoConnectElement instance.
+ */
+AutoConnectElement* AutoConnectAux::_createElement(const ACElementProp_t& prop) {
+  AutoConnectElement* elm = nullptr;
+  PGM_P valueP = reinterpret_cast<PGM_P>(pgm_read_ptr(&prop.value));
+  PGM_P peculiarP = reinterpret_cast<PGM_P>(pgm_read_ptr(&prop.peculiar));
+  const String  value = valueP ? String(FPSTR(valueP)) : String("");
+  const String  peculiar = peculiarP ? String(FPSTR(peculiarP)) : String("");
+
+  switch (static_cast<ACElement_t>(pgm_read_dword(&prop.type))) {
+  case AC_Element:
+    elm = new AutoConnectElement;
+    break;
+  case AC_Button: {
+    AutoConnectButton*  cert_elm = new AutoConnectButton;
+    cert_elm->action = peculiar;
+    elm = cert_elm;
+    break;
+  }
+  case AC_Checkbox: {
+    AutoConnectCheckbox*  cert_elm = new AutoConnectCheckbox;
+    cert_elm->label = peculiar;
+    elm = cert_elm;
+    break;
+  }
+  case AC_File: {
+    AutoConnectFile*  cert_elm = new AutoConnectFile;
+    cert_elm->label = peculiar;
+    elm = cert_elm;
+    break;
+  }
+  case AC_Input: {
+    AutoConnectInput*  cert_elm = new AutoConnectInput;
+    cert_elm->label = peculiar;
+    elm = cert_elm;
+    break;
+  }
+  case AC_Range: {
+    AutoConnectRange*  cert_elm = new AutoConnectRange;
+    cert_elm->value = value.toInt();
+    int  sep = peculiar.indexOf(',');
+    if (sep >= 0) {
+      cert_elm->min = peculiar.substring(0, sep).toInt();
+      String  rest = peculiar.substring(sep + 1);
+      sep = rest.indexOf(',');
+      cert_elm->max = rest.substring(0, sep).toInt();
+      if (sep >= 0)
+        cert_elm->step = rest.substring(sep + 1).toInt();
+    }
+    elm = cert_elm;
+    break;
+  }
+  case AC_Style:
+    elm = new AutoConnectStyle;
+    break;
+  case AC_Submit: {
+    AutoConnectSubmit*  cert_elm = new AutoConnectSubmit;
+    cert_elm->uri = peculiar;
+    elm = cert_elm;
+    break;
+  }
+  case AC_Text: {
+    AutoConnectText*  cert_elm = new AutoConnectText;
+    cert_elm->style = peculiar;
+    elm = cert_elm;
+    break;
+  }
+  default:
+    // AutoConnectRadio and AutoConnectSelect have attributes that the
+    // table cannot hold.
+    return nullptr;
+  }
+  elm->name = String(FPSTR(pgm_read_ptr(&prop.name)));
+  if (valueP && elm->typeOf() != AC_Range)
+    elm->value = value;
+  return elm;
+}
+
 #ifdef AUTOCONNECT_USE_JSON
 
 /**
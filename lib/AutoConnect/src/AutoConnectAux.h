@@ -91,22 +91,6 @@ class AutoConnectAux : public PageBuilder {
   }
   AutoConnectAux& referer(void);
 
-#ifdef AUTOCONNECT_USE_JSON
-  bool  load(PGM_P in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);                       /**< Load whole elements to AutoConnectAux Page */
-  bool  load(const __FlashStringHelper* in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);  /**< Load whole elements to AutoConnectAux Page */
-  bool  load(const String& in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);               /**< Load whole elements to AutoConnectAux Page */
-  bool  load(Stream& in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);                     /**< Load whole elements to AutoConnectAux Page */
-  bool  loadElement(PGM_P in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);   /**< Load specified element */
-  bool  loadElement(PGM_P in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);  /**< Load any specified elements */
-  bool  loadElement(const __FlashStringHelper* in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);  /**< Load specified element */
-  bool  loadElement(const __FlashStringHelper* in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE); /**< Load any specified elements */
-  bool  loadElement(const String& in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE); /**< Load specified element */
-  bool  loadElement(const String& in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);/**< Load any specified elements */
-  bool  loadElement(Stream& in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);       /**< Load specified element */
-  bool  loadElement(Stream& in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);      /**< Load any specified elements */
-  size_t  saveElement(Stream& out, std::vector<String> const& names = {});  /**< Write elements of AutoConnectAux to the stream */
-#endif // !AUTOCONNECT_USE_JSON
-
   // Attribute definition of the element to be placed on the update page.
   typedef struct {
     const ACElement_t type;
@@ -121,8 +105,28 @@ class AutoConnectAux : public PageBuilder {
     const char*  title;     /**< Menu title of update page */
     const bool   menu;      /**< Whether to display in menu */
     const ACElementProp_t* element;
+    const size_t elements;  /**< Number of the elements, required by load */
+    const AC_AUTH_t auth;   /**< Applying HTTP authentication */
   } ACPage_t;
 
+  bool  load(const ACPage_t& page);                                     /**< Load whole elements from the precompiled page */
+
+#ifdef AUTOCONNECT_USE_JSON
+  bool  load(PGM_P in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);                       /**< Load whole elements to AutoConnectAux Page */
+  bool  load(const __FlashStringHelper* in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);  /**< Load whole elements to AutoConnectAux Page */
+  bool  load(const String& in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);               /**< Load whole elements to AutoConnectAux Page */
+  bool  load(Stream& in, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);                     /**< Load whole elements to AutoConnectAux Page */
+  bool  loadElement(PGM_P in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);   /**< Load specified element */
+  bool  loadElement(PGM_P in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);  /**< Load any specified elements */
+  bool  loadElement(const __FlashStringHelper* in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);  /**< Load specified element */
+  bool  loadElement(const __FlashStringHelper* in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE); /**< Load any specified elements */
+  bool  loadElement(const String& in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE); /**< Load specified element */
+  bool  loadElement(const String& in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);/**< Load any specified elements */
+  bool  loadElement(Stream& in, const String& name = String(""), const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);       /**< Load specified element */
+  bool  loadElement(Stream& in, std::vector<String> const& names, const size_t docSize = AUTOCONNECT_JSONDOCUMENT_SIZE);      /**< Load any specified elements */
+  size_t  saveElement(Stream& out, std::vector<String> const& names = {});  /**< Write elements of AutoConnectAux to the stream */
+#endif // !AUTOCONNECT_USE_JSON
+
  protected:
   void  upload(const String& requestUri, const HTTPUpload& upload);     /**< Uploader wrapper */
   void  _concat(AutoConnectAux& aux);                                   /**< Make up chain of AutoConnectAux */
@@ -141,6 +145,10 @@ class AutoConnectAux : public PageBuilder {
   template<typename T>
   bool  _isCompatible(const AutoConnectElement* element) const;         /**< Validate a type of AutoConnectElement entity conformity */
   static AutoConnectElement&  _nullElement(void);                       /**< A static returning value as invalid */
+  AutoConnectElement* _createElement(const ACElementProp_t& prop);      /**< Create an AutoConnectElement instance from the precompiled element */
+  AutoConnectElement* _findElement(const uint32_t hash, std::function<bool(const String&)> match); /**< Find an element through the name index */
+  void  _indexElements(void);                                           /**< Rebuild the name index */
+  static uint32_t _hashName(const char* name, const bool progmem = false);  /**< Case-insensitive hash of an element name */
 
 #ifdef AUTOCONNECT_USE_JSON
   bool  _load(JsonObject& in);                                          /**< Load all elements from JSON object */
@@ -217,6 +225,7 @@ class AutoConnectAux : public PageBuilder {
   uint16_t  _contains;                        /**< Bitmask the type of elements this page contains */
   AC_AUTH_t _httpAuth = AC_AUTH_NONE;         /**< Applying HTTP authentication */
   AutoConnectElementVT  _addonElm;            /**< A vector set of AutoConnectElements placed on this auxiliary page */
+  std::vector<uint32_t> _addonHash;           /**< Name hashes of _addonElm in the same order */
   AutoConnectAux*       _next = nullptr;      /**< Auxiliary pages chain list */
   AutoConnectExt<AutoConnectConfigExt>* _ac = nullptr;  /**< Hosted AutoConnect instance */
   AuxHandlerFunctionT   _handler;             /**< User sketch callback function when AutoConnectAux page requested. */
@@ -43,6 +43,7 @@ class AutoConnectConfigBase {
     autoRise(true),
     autoReset(true),
     autoReconnect(false),
+    fastReconnect(false),
     immediateStart(false),
     retainPortal(false),
     preserveAPMode(false),
@@ -86,6 +87,7 @@ class AutoConnectConfigBase {
     autoRise(true),
     autoReset(true),
     autoReconnect(false),
+    fastReconnect(false),
     immediateStart(false),
     retainPortal(false),
     preserveAPMode(false),
@@ -129,6 +131,7 @@ class AutoConnectConfigBase {
     autoRise = o.autoRise;
     autoReset = o.autoReset;
     autoReconnect = o.autoReconnect;
+    fastReconnect = o.fastReconnect;
     immediateStart = o.immediateStart;
     retainPortal = o.retainPortal;
     preserveAPMode = o.preserveAPMode;
@@ -171,6 +174,7 @@ class AutoConnectConfigBase {
   bool      autoRise;           /**< Automatic starting the captive portal */
   bool      autoReset;          /**< Reset ESP8266 module automatically when WLAN disconnected. */
   bool      autoReconnect;      /**< Automatic reconnect with past SSID */
+  bool      fastReconnect;      /**< Connect to the last AP cached in the RTC memory before scanning */
   bool      immediateStart;     /**< Skips WiFi.begin(), start portal immediately */
   bool      retainPortal;       /**< Even if the captive portal times out, it maintains the portal state. */
   bool      preserveAPMode;     /**< Keep existing AP WiFi mode if captive portal won't be started. */
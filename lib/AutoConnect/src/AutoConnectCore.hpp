@@ -34,6 +34,7 @@ using WebServer = ESP8266WebServer;
 #include "AutoConnectPage.h"
 #include "AutoConnectCredential.h"
 #include "AutoConnectTicker.h"
+#include "AutoConnectFastReconnect.h"
 #include "AutoConnectConfigBase.h"
 
 template<typename T>
@@ -45,6 +46,7 @@ class AutoConnectCore {
     AC_AUTORECONNECT  = 0x02, /**< .... ..1.  The autoReconnect was applied. */
     AC_TIMEOUT        = 0x04, /**< .... .1..  Connection timeout. */
     AC_INTERRUPT      = 0x08, /**< .... 1...  Connection interrupted due to an indication with the exit. */
+    AC_FASTRECONNECT  = 0x10, /**< ...1 ....  Connected to the cached access point without scanning. */
     AC_CAPTIVEPORTAL  = 0x40, /**< .1.. ....  Captive portal is available. */
     AC_INPROGRESS     = 0x80  /**< 1... ....  WiFi.begin in progress. */
   } AC_PORTALSTATE_t;         /**< AutoConnect::begin and handleClient status of the portal during the period. */
@@ -64,6 +66,7 @@ class AutoConnectCore {
   bool  getCurrentCredential(station_config_t* staConfig);
   uint16_t  getEEPROMUsedSize(void);
   void  handleClient(void);
+  uint32_t  handleClientMaxTime(const bool reset = false);
   void  handleRequest(void);
   void  home(const String& uri);
   WebServer& host(void);
@@ -89,6 +92,15 @@ class AutoConnectCore {
     AC_RECONNECT_SET,
     AC_RECONNECT_RESET
   } AC_STARECONNECT_t;
+  typedef enum {
+    AC_STEP_IDLE,           /**< No operation in progress */
+    AC_STEP_RELEASING,      /**< Waiting for the station to leave the AP before connecting */
+    AC_STEP_CONNECTING,     /**< WiFi.begin issued, waiting for the link */
+    AC_STEP_LEAVING,        /**< Connection failed, waiting for the station to leave */
+    AC_STEP_DISCONNECTING,  /**< Waiting for the station to disconnect */
+    AC_STEP_FLUSHING,       /**< Waiting for the response to flush before the reset */
+    AC_STEP_RESETTING       /**< Waiting for the reset */
+  } AC_STEP_t;              /**< Step of the operation which handleRequest advances */
   typedef enum {
     AC_SEEKMODE_ANY,
     AC_SEEKMODE_NEWONE,
@@ -99,15 +111,17 @@ class AutoConnectCore {
   bool  _configAP(void);
   bool  _configSTA(const IPAddress& ip, const IPAddress& gateway, const IPAddress& netmask, const IPAddress& dns1, const IPAddress& dns2);
   String _getBootUri(void);
+  bool  _fastReconnect(unsigned long timeout);
   bool  _getConfigSTA(station_config_t* config);
   bool  _loadAvailCredential(const char* ssid, const AC_PRINCIPLE_t principle = AC_PRINCIPLE_RECENT, const bool excludeCurrent = false);
   bool  _loadCurrentCredential(char* ssid, char* password, const AC_PRINCIPLE_t principle, const bool excludeCurrent);
+  bool  _loadFastReconnect(AutoConnectFastReconnect::AC_FASTRECONNECT_t* cache);
   void  _restoreSTA(const station_config_t& staConfig);
   bool  _seekCredential(const AC_PRINCIPLE_t principle, const AC_SEEKMODE_t mode);
   void  _startWebServer(void);
   void  _startDNSServer(void);
   void  _stopDNSServer(void);
-  void  _stopPortal(void);
+  void  _stopPortal(const bool flush = true);
   bool  _classifyHandle(HTTPMethod mothod, String uri);
   void  _handleNotFound(void);
   void  _purgePages(void);
@@ -127,6 +141,10 @@ class AutoConnectCore {
   bool  _isPersistent(void);
   void  _softAP(void);
   wl_status_t _waitForConnect(unsigned long timeout);
+  void  _startConnect(void);
+  bool  _pollConnect(unsigned long timeout, wl_status_t* wifiStatus);
+  void  _endConnect(void);
+  void  _leaveSTA(const bool wifiOff, const bool clearConfig);
   void  _waitForEndTransmission(void);
   void  _setReconnect(const AC_STARECONNECT_t order);
 
@@ -172,7 +190,13 @@ class AutoConnectCore {
   bool  _rfConnect = false;     /**< URI /connect requested */
   bool  _rfDisconnect = false;  /**< URI /disc requested */
   bool  _rfReset = false;       /**< URI /reset requested */
+  bool  _rfCachedLease = false; /**< The fast reconnect applied the cached lease statically */
   wl_status_t   _rsConnect;     /**< connection result */
+  AC_STEP_t     _step = AC_STEP_IDLE; /**< Operation in progress by handleRequest */
+  unsigned long _stepPeriod;    /**< millis() at the start of the current step */
+  unsigned long _connectTick;   /**< millis() of the last progress output while connecting */
+  String        _connectSSID;   /**< SSID of the connection attempt for whileConnecting */
+  uint32_t      _handleClientMax = 0; /**< Longest handleClient duration [us] */
 #ifdef ARDUINO_ARCH_ESP32
   WiFiEventId_t _disconnectEventId = -1;  /**< STA disconnection event handler registered id  */
 #endif
@@ -216,20 +240,7 @@ class AutoConnectCore {
   static const char _PAGE_404[] PROGMEM;
 
   /** Token handlers for PageBuilder */
-  String _token_CSS_BASE(PageArgument& args);
-  String _token_CSS_ICON_LOCK(PageArgument& args);
   String _token_CSS_ICON_TRASH(PageArgument& args);
-  String _token_CSS_INPUT_BUTTON(PageArgument& args);
-  String _token_CSS_INPUT_TEXT(PageArgument& args);
-  String _token_CSS_LUXBAR_BODY(PageArgument& args);
-  String _token_CSS_LUXBAR_HEADER(PageArgument& args);
-  String _token_CSS_LUXBAR_BGR(PageArgument& args);
-  String _token_CSS_LUXBAR_ANI(PageArgument& args);
-  String _token_CSS_LUXBAR_MEDIA(PageArgument& args);
-  String _token_CSS_LUXBAR_ITEM(PageArgument& args);
-  String _token_CSS_SPINNER(PageArgument& args);
-  String _token_CSS_TABLE(PageArgument& args);
-  String _token_CSS_UL(PageArgument& args);
   String _token_MENU_AUX(PageArgument& args);
   String _token_MENU_LIST(PageArgument& args);
   String _token_MENU_POST(PageArgument& args);
@@ -246,7 +257,6 @@ class AutoConnectCore {
   String _token_FLASH_SIZE(PageArgument& args);
   String _token_FREE_HEAP(PageArgument& args);
   String _token_GATEWAY(PageArgument& args);
-  String _token_HEAD(PageArgument& args);
   String _token_HIDDEN_COUNT(PageArgument& args);
   String _token_LIST_SSID(PageArgument& args);
   String _token_LOCAL_IP(PageArgument& args);
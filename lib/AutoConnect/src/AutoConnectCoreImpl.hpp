@@ -121,6 +121,14 @@ bool AutoConnectCore<T>::begin(const char* ssid, const char* passphrase, unsigne
     delay(100);
   }
 
+  // Build the directory of the saved credentials once. The lookups of
+  // all credential instances share it until an entry is saved, deleted
+  // or restored.
+  {
+    AutoConnectCredential credt(_apConfig.boundaryOffset);
+    credt.index();
+  }
+
   // Set host name
   if (_apConfig.hostName.length())
     SET_HOSTNAME(_apConfig.hostName.c_str());
@@ -138,6 +146,12 @@ bool AutoConnectCore<T>::begin(const char* ssid, const char* passphrase, unsigne
     cs = false;
     AC_DBG("Start the portal immediately\n");
   }
+  // Connect directly to the access point of the last connection, the
+  // regular sequence follows if it fails.
+  else if (_apConfig.fastReconnect && !(ssid && strlen(ssid)) && _fastReconnect(timeout)) {
+    cs = true;
+    _rfAdHocBegin = false;
+  }
   else {
     station_config_t  current;
     // Restore current STA configuration
@@ -397,6 +411,20 @@ bool AutoConnectCore<T>::_configSTA(const IPAddress& ip, const IPAddress& gatewa
  */
 template<typename T>
 void AutoConnectCore<T>::disconnect(const bool wifiOff, const bool clearConfig) {
+  _leaveSTA(wifiOff, clearConfig);
+  while (WiFi.status() == WL_CONNECTED)
+    delay(1);
+  _portalStatus &= ~AC_ESTABLISHED;
+}
+
+/**
+ * Issue the station disconnection without waiting for it to complete.
+ * The caller watches WiFi.status to know when the station has left.
+ * @param  wifiOff      If true, stops WiFi station.
+ * @param  clearConfig  If true, clears the station configuration.
+ */
+template<typename T>
+void AutoConnectCore<T>::_leaveSTA(const bool wifiOff, const bool clearConfig) {
   WiFi.mode(WIFI_STA);
 
 #if defined(ARDUINO_ARCH_ESP8266)
@@ -415,10 +443,6 @@ void AutoConnectCore<T>::disconnect(const bool wifiOff, const bool clearConfig)
 #elif defined(ARDUINO_ARCH_ESP32)
   WiFi.disconnect(wifiOff, clearConfig);
 #endif
-
-  while (WiFi.status() == WL_CONNECTED)
-    delay(1);
-  _portalStatus &= ~AC_ESTABLISHED;
 }
 
 /**
@@ -532,6 +556,8 @@ uint16_t AutoConnectCore<T>::getEEPROMUsedSize(void) {
  */
 template<typename T>
 void AutoConnectCore<T>::handleClient(void) {
+  const unsigned long  st = micros();
+
   // Is there DNS Server process next request?
   if (_dnsServer)
     _dnsServer->processNextRequest();
@@ -540,6 +566,23 @@ void AutoConnectCore<T>::handleClient(void) {
     _webServer->handleClient();
 
   handleRequest();
+
+  const uint32_t  et = micros() - st;
+  if (et > _handleClientMax)
+    _handleClientMax = et;
+}
+
+/**
+ * Returns the longest time spent in a single handleClient call.
+ * @param  reset  If true, restarts the measurement after returning.
+ * @return The maximum duration in microseconds.
+ */
+template<typename T>
+uint32_t AutoConnectCore<T>::handleClientMaxTime(const bool reset) {
+  const uint32_t  mt = _handleClientMax;
+  if (reset)
+    _handleClientMax = 0;
+  return mt;
 }
 
 /**
@@ -577,7 +620,7 @@ void AutoConnectCore<T>::handleRequest(void) {
     // AutoConnectConfig::reconnectInterval allows a dynamic connection
     // to a known access point without blocking the execution of
     // Sketch's loop function.
-    if (_apConfig.autoReconnect && _apConfig.reconnectInterval > 0) {
+    if (_apConfig.autoReconnect && _apConfig.reconnectInterval > 0 && _step == AC_STEP_IDLE) {
       int8_t  sc = WiFi.scanComplete();
 
       // Scan has not triggered then starts asynchrony scan and repeats at
@@ -587,10 +630,19 @@ void AutoConnectCore<T>::handleRequest(void) {
         if (millis() - _attemptPeriod > ((unsigned long)_apConfig.reconnectInterval * AUTOCONNECT_UNITTIME * 1000)) {
           disconnect(false, false);
           _portalStatus &= ~(AC_AUTORECONNECT | AC_INTERRUPT | ~0xf);
-          int8_t  sn = WiFi.scanNetworks(true, true);
-          AC_DBG("autoReconnect %s\n", sn == WIFI_SCAN_RUNNING ? "running" : "failed");
+          AutoConnectFastReconnect::AC_FASTRECONNECT_t  cache;
+          if (_apConfig.fastReconnect && !_rfAdHocBegin && _loadFastReconnect(&cache)) {
+            // Try the cached access point before scanning.
+            AC_DBG("autoReconnect %s cached\n", cache.ssid);
+            _portalStatus |= AC_AUTORECONNECT | AC_FASTRECONNECT;
+            _rfConnect = true;
+          }
+          else {
+            int8_t  sn = WiFi.scanNetworks(true, true);
+            AC_DBG("autoReconnect %s\n", sn == WIFI_SCAN_RUNNING ? "running" : "failed");
+            (void)(sn);
+          }
           _attemptPeriod = millis();
-          (void)(sn);
         }
       }
 
@@ -613,10 +665,23 @@ void AutoConnectCore<T>::handleRequest(void) {
     _attemptPeriod = millis();
 
   // Handling processing requests to AutoConnect.
-  if (_rfConnect) {
-    // Leave from the AP currently.
+  // A request proceeds in steps, each handleRequest call advances the
+  // current step without waiting so that the sketch loop keeps running
+  // during the connection attempt.
+  if (_rfConnect && _step == AC_STEP_IDLE) {
+    _rfConnect = false;
+
+    // Leave from the AP currently. The attempt begins at the next step
+    // once the station has left.
     if (WiFi.status() == WL_CONNECTED)
-      disconnect(true, true);
+      _leaveSTA(true, true);
+    _step = AC_STEP_RELEASING;
+    _stepPeriod = millis();
+  }
+
+  if (_step == AC_STEP_RELEASING && (WiFi.status() != WL_CONNECTED || millis() - _stepPeriod > 3000)) {
+    _portalStatus &= ~AC_ESTABLISHED;
+    _step = AC_STEP_IDLE;
 
     // Leave current AP, reconfigure station
     _configSTA(_apConfig.staip, _apConfig.staGateway, _apConfig.staNetmask, _apConfig.dns1, _apConfig.dns2);
@@ -638,16 +703,28 @@ void AutoConnectCore<T>::handleRequest(void) {
 
     // Establish a WiFi connection with the access point.
     _portalStatus &= ~AC_TIMEOUT;
-    if (WiFi.begin(ssid_c, password_c, ch) != WL_CONNECT_FAILED) {
+    // The cached access point is reached by its BSSID, which is not
+    // persisted in the station configuration.
+    const uint8_t*  bssid = nullptr;
+    if (_portalStatus & AC_FASTRECONNECT) {
+      bssid = _credential.bssid;
+      WiFi.persistent(false);
+    }
+    bool  bs = WiFi.begin(ssid_c, password_c, ch, bssid) != WL_CONNECT_FAILED;
+    if (bssid)
+      WiFi.persistent(true);
+    if (bs) {
       _portalStatus |= AC_INPROGRESS;
-      // Wait for the connection attempt to complete and send a response
-      // page to notify the connection result.
-      // End the current session to complete a response page transmission.
-      _rsConnect = _waitForConnect(_apConfig.beginTimeout);
-      do {
-        _webServer->handleClient();
-      } while (_webServer->client());
+      // The connection attempt completes at the following steps.
+      _startConnect();
+      _step = AC_STEP_CONNECTING;
+    }
+    else
+      _redirectURI = String(F(AUTOCONNECT_URI_ONFAIL));
+  }
 
+  if (_step == AC_STEP_CONNECTING) {
+    if (_pollConnect(_apConfig.beginTimeout, &_rsConnect)) {
       if (_rsConnect == WL_CONNECTED) {
         // WLAN successfully connected then release the DNS server.
         // Also, stop WIFI_AP if retainPortal not specified.
@@ -672,87 +749,92 @@ void AutoConnectCore<T>::handleRequest(void) {
           _setReconnect(AC_RECONNECT_SET);
         }
         // WiFi linked up, but IP does not bind.
-        else
+        else {
           _rsConnect = WL_CONNECT_FAILED;
+          _redirectURI = String(F(AUTOCONNECT_URI_ONFAIL));
+        }
 
         // Activate AutoConnectUpdate if it is attached and incorporate
         // it into the AutoConnect menu.
         _enableUpdate();
+        _endConnect();
       }
       else {
         _currentHostIP = WiFi.softAPIP();
         _redirectURI = String(F(AUTOCONNECT_URI_ONFAIL));
-        // Leave station connection completely
-        wl_status_t wl = WiFi.status();
-        unsigned long tm = millis();
-        while (wl != WL_IDLE_STATUS && wl != WL_DISCONNECTED && wl != WL_NO_SSID_AVAIL) {
-          if (millis() - tm > 3000)
-            break;
-          delay(1);
-          yield();
-          wl = WiFi.status();
-        }
-        AC_DBG("Quit connecting, status(%d)\n", wl);
+        // Leave station connection completely at the next step.
+        _step = AC_STEP_LEAVING;
+        _stepPeriod = millis();
       }
+    }
+  }
 
-      // It will automatically save the credential which was able to
-      // establish current connection.
-      // AC_SAVECREDENTIAL_ALWAYS is an option to intentionally register
-      // an unconnected credential. This option allows the storage of a
-      // credential regardless of the established WIFI connection.
-      if (_apConfig.autoSave == AC_SAVECREDENTIAL_ALWAYS ||
-          ((_rsConnect == WL_CONNECTED) & (_apConfig.autoSave == AC_SAVECREDENTIAL_AUTO))) {
-        AutoConnectCredential credit(_apConfig.boundaryOffset);
-        if (credit.save(&_credential)) {
-          AC_DBG("%.*s credential saved\n", sizeof(_credential.ssid), reinterpret_cast<const char*>(_credential.ssid));
-        }
-        else {
-          AC_DBG("credential %.*s save failed\n", sizeof(_credential.ssid), reinterpret_cast<const char*>(_credential.ssid));
-        }
+  if (_step == AC_STEP_LEAVING) {
+    wl_status_t wl = WiFi.status();
+    if (wl == WL_IDLE_STATUS || wl == WL_DISCONNECTED || wl == WL_NO_SSID_AVAIL || millis() - _stepPeriod > 3000) {
+      AC_DBG("Quit connecting, status(%d)\n", wl);
+
+      // The cached access point has gone, the next attempt will scan.
+      if (_portalStatus & AC_FASTRECONNECT) {
+        AutoConnectFastReconnect::clear();
+        _portalStatus &= ~AC_FASTRECONNECT;
+        _connectCh = 0;
       }
+      _endConnect();
     }
-    _rfConnect = false;
   }
 
-  if (_rfReset) {
-    // Reset or disconnect by portal operation result
-    _stopPortal();
-    AC_DBG("Reset\n");
-    delay(1000);
-    SOFT_RESET();
-    delay(1000);
+  if (_rfReset && _step == AC_STEP_IDLE) {
+    // Reset or disconnect by portal operation result.
+    // Let the response flush before stopping the portal.
+    if (_webServer)
+      _webServer->client().stop();
+    _step = AC_STEP_FLUSHING;
+    _stepPeriod = millis();
   }
 
-  if (_rfDisconnect) {
+  if (_rfDisconnect && _step == AC_STEP_IDLE) {
     // Response for disconnection request is not completed while
     // the session exists.
     if (!_webServer->client()) {
       // Disconnect from the current AP.
-      disconnect(false, true);
-      while (WiFi.status() == WL_CONNECTED) {
-        delay(10);
-        yield();
-      }
-      AC_DBG("Disconnected ");
-      if ((WiFi.getMode() & WIFI_AP) && !_apConfig.retainPortal) {
-        _stopPortal();
-      }
-      else {
-        if (_dnsServer)
-          AC_DBG_DUMB("- Portal maintained");
-        AC_DBG_DUMB("\n");
-      }
-      // Reset disconnection request
-      _rfDisconnect = false;
+      _leaveSTA(false, true);
+      _step = AC_STEP_DISCONNECTING;
+    }
+  }
 
-      if (_apConfig.autoReset) {
-        delay(1000);
-        SOFT_RESET();
-        delay(1000);
-      }
+  if (_step == AC_STEP_DISCONNECTING && WiFi.status() != WL_CONNECTED) {
+    _portalStatus &= ~AC_ESTABLISHED;
+    AC_DBG("Disconnected ");
+    if ((WiFi.getMode() & WIFI_AP) && !_apConfig.retainPortal) {
+      // The session has already ended, nothing to flush.
+      _stopPortal(false);
+    }
+    else {
+      if (_dnsServer)
+        AC_DBG_DUMB("- Portal maintained");
+      AC_DBG_DUMB("\n");
     }
+    // Reset disconnection request
+    _rfDisconnect = false;
+    _step = AC_STEP_IDLE;
+
+    if (_apConfig.autoReset) {
+      _step = AC_STEP_RESETTING;
+      _stepPeriod = millis();
+    }
+  }
+
+  if (_step == AC_STEP_FLUSHING && millis() - _stepPeriod > 1000) {
+    _stopPortal(false);
+    AC_DBG("Reset\n");
+    _step = AC_STEP_RESETTING;
+    _stepPeriod = millis();
   }
 
+  if (_step == AC_STEP_RESETTING && millis() - _stepPeriod > 1000)
+    SOFT_RESET();
+
   // Handle the update behaviors for attached AutoConnectUpdate.
   // Indicate that not disturb the ticker cycle during OTA.
   // It will be set to true during OTA in progress due to subsequent
@@ -785,6 +867,29 @@ void AutoConnectCore<T>::handleRequest(void) {
   }
 }
 
+/**
+ * Finish the connection attempt requested by the portal. It will
+ * automatically save the credential which was able to establish current
+ * connection.
+ */
+template<typename T>
+void AutoConnectCore<T>::_endConnect(void) {
+  // AC_SAVECREDENTIAL_ALWAYS is an option to intentionally register
+  // an unconnected credential. This option allows the storage of a
+  // credential regardless of the established WIFI connection.
+  if (_apConfig.autoSave == AC_SAVECREDENTIAL_ALWAYS ||
+      ((_rsConnect == WL_CONNECTED) & (_apConfig.autoSave == AC_SAVECREDENTIAL_AUTO))) {
+    AutoConnectCredential credit(_apConfig.boundaryOffset);
+    if (credit.save(&_credential)) {
+      AC_DBG("%.*s credential saved\n", sizeof(_credential.ssid), reinterpret_cast<const char*>(_credential.ssid));
+    }
+    else {
+      AC_DBG("credential %.*s save failed\n", sizeof(_credential.ssid), reinterpret_cast<const char*>(_credential.ssid));
+    }
+  }
+  _step = AC_STEP_IDLE;
+}
+
 /**
  * Put a user site's home URI.
  * The URI specified by home is linked from "HOME" in the AutoConnect
@@ -946,6 +1051,96 @@ bool AutoConnectCore<T>::_loadAvailCredential(const char* ssid, const AC_PRINCIP
   return false;
 }
 
+/**
+ * Load the access point cached by the last established connection and
+ * the saved credential of its SSID, which allows connecting with the
+ * BSSID and the channel without scanning.
+ * @param  cache  A pointer to the cache record to be loaded.
+ * @return true   The cache and its credential were loaded.
+ */
+template<typename T>
+bool AutoConnectCore<T>::_loadFastReconnect(AutoConnectFastReconnect::AC_FASTRECONNECT_t* cache) {
+  if (!AutoConnectFastReconnect::load(cache))
+    return false;
+
+  AutoConnectCredential credential(_apConfig.boundaryOffset);
+  if (credential.load(cache->ssid, &_credential) < 0) {
+    // The credential has been deleted since.
+    AutoConnectFastReconnect::clear();
+    return false;
+  }
+  memcpy(_credential.bssid, cache->bssid, sizeof(station_config_t::bssid));
+  _connectCh = cache->channel;
+  return true;
+}
+
+/**
+ * Connect to the access point cached by the last established connection
+ * with its BSSID and channel, skipping the scan. When the connection
+ * was configured by DHCP, the cached lease is applied statically to skip
+ * DHCP as well, up to AUTOCONNECT_FASTRECONNECT_LEASEREUSE times in a
+ * row. The attempt is limited by AUTOCONNECT_FASTRECONNECT_TIMEOUT and on
+ * failure the cache is discarded.
+ * @param  timeout  A time out value in milliseconds of AutoConnect::begin.
+ * @return true   Connection established.
+ */
+template<typename T>
+bool AutoConnectCore<T>::_fastReconnect(unsigned long timeout) {
+  AutoConnectFastReconnect::AC_FASTRECONNECT_t  cache;
+
+  if (!_loadFastReconnect(&cache))
+    return false;
+
+  // The station may be linked already with the cached access point.
+  if (WiFi.status() == WL_CONNECTED && WiFi.BSSID() && !memcmp(WiFi.BSSID(), cache.bssid, sizeof(station_config_t::bssid))) {
+    _portalStatus |= AC_ESTABLISHED | AC_FASTRECONNECT;
+    return true;
+  }
+
+  // The static IPs of the credential take precedence over the lease.
+  if (_credential.dhcp == (uint8_t)STA_STATIC && !_apConfig.preserveIP)
+    _restoreSTA(_credential);
+  // An aged lease is renewed by letting DHCP run for this connection.
+  if ((uint32_t)_apConfig.staip == 0UL && cache.lease && cache.leaseReuse < AUTOCONNECT_FASTRECONNECT_LEASEREUSE) {
+    if (!_configSTA(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.netmask), IPAddress(cache.dns1), IPAddress(cache.dns2)))
+      return false;
+    _rfCachedLease = true;
+  }
+  else if (!_configSTA(_apConfig.staip, _apConfig.staGateway, _apConfig.staNetmask, _apConfig.dns1, _apConfig.dns2))
+    return false;
+
+  char  ssid_c[sizeof(station_config_t::ssid) + 1];
+  char  password_c[sizeof(station_config_t::password) + 1];
+  *ssid_c = '\0';
+  strncat(ssid_c, reinterpret_cast<const char*>(_credential.ssid), sizeof(ssid_c) - 1);
+  *password_c = '\0';
+  strncat(password_c, reinterpret_cast<const char*>(_credential.password), sizeof(password_c) - 1);
+  const char* psk = strlen(password_c) ? password_c : nullptr;
+
+  // The BSSID is not persisted, a later WiFi.begin with no arguments
+  // still connects to any access point of the SSID.
+  WiFi.persistent(false);
+  AC_DBG("WiFi.begin(%s%s%s) ch(%d) cached", ssid_c, psk == nullptr ? "" : ",", psk == nullptr ? "" : psk, (int)cache.channel);
+  bool  cs = WiFi.begin(ssid_c, psk, cache.channel, cache.bssid) != WL_CONNECT_FAILED;
+  if (cs) {
+    _portalStatus |= AC_INPROGRESS;
+    cs = _waitForConnect(timeout && timeout < AUTOCONNECT_FASTRECONNECT_TIMEOUT ? timeout : AUTOCONNECT_FASTRECONNECT_TIMEOUT) == WL_CONNECTED;
+  }
+  if (cs)
+    _portalStatus |= AC_FASTRECONNECT;
+  else {
+    // Leave the cached access point, then the regular sequence scans.
+    AutoConnectFastReconnect::clear();
+    _rfCachedLease = false;
+    _connectCh = 0;
+    disconnect(false, false);
+    WiFi.begin(ssid_c, psk, 0, nullptr, false);
+    _portalStatus &= ~(AC_TIMEOUT | AC_INPROGRESS);
+  }
+  WiFi.persistent(true);
+  return cs;
+}
+
 /**
  * Restore station IP settings to the current STA settings.
  * The restored settings will be used for WiFi.config parameters during
@@ -979,7 +1174,7 @@ bool AutoConnectCore<T>::_seekCredential(const AC_PRINCIPLE_t principle, const A
   int32_t minRSSI = -120;         // Min value to find the strongest RSSI.
 
   // Seek SSID
-  const char* currentSSID = WiFi.SSID().c_str();
+  const String  currentSSID = WiFi.SSID();
   for (uint8_t n = 0; n < WiFi.scanComplete(); n++) {
     if (mode == AC_SEEKMODE_CURRENT) {
       // It finds a specific access point that matches the SSID
@@ -990,34 +1185,37 @@ bool AutoConnectCore<T>::_seekCredential(const AC_PRINCIPLE_t principle, const A
     else {
       // Seek valid configuration according to the WiFi connection principle.
       // Verify that an available SSIDs meet AC_PRINCIPLE_t requirements.
-      for (uint8_t i = 0; i < credential.entries(); i++) {
-        credential.load(i, &_credential);
-        // The access point collation key is determined at compile time
-        // according to the AUTOCONNECT_APKEY_SSID definition, which is
-        // either BSSID or SSID.
-        if (_isValidAP(_credential, n)) {
-          if ((mode == AC_SEEKMODE_NEWONE) && (strlen(currentSSID) > 0))
-            continue;
-          if ((int32_t)WiFi.RSSI(n) < _apConfig.minRSSI) {
-            // Excepts SSID that has weak RSSI under the lower limit.
-            AC_DBG("%s:%ddBm, rejected\n", reinterpret_cast<const char*>(_credential.ssid), (int)WiFi.RSSI(n));
-            continue;
-          }
-          // Determine valid credential
-          switch (principle) {
-          case AC_PRINCIPLE_RECENT:
-            // By BSSID, exit to keep the credential just loaded.
-            _restoreSTA(_credential);
-            return true;
-
-          case AC_PRINCIPLE_RSSI:
-            // Verify that most strong radio signal.
-            // Continue seeking to find the strongest WIFI signal SSID.
-            if ((int32_t)WiFi.RSSI(n) > minRSSI) {
-              minRSSI = WiFi.RSSI(n);
-              memcpy(&validConfig, &_credential, sizeof(station_config_t));
-            }
-            break;
+      // The access point collation key is determined at compile time
+      // according to the AUTOCONNECT_APKEY_SSID definition, which is
+      // either BSSID or SSID. The credential store looks up the entry
+      // through the shared directory built at begin instead of loading
+      // every entry.
+#if defined(AUTOCONNECT_APKEY_SSID)
+      const uint8_t*  bssid = nullptr;
+#else
+      const uint8_t*  bssid = WiFi.BSSID(n);
+#endif
+      if (credential.seek(WiFi.SSID(n).c_str(), bssid, &_credential) >= 0) {
+        if ((mode == AC_SEEKMODE_NEWONE) && (currentSSID.length() > 0))
+          continue;
+        if ((int32_t)WiFi.RSSI(n) < _apConfig.minRSSI) {
+          // Excepts SSID that has weak RSSI under the lower limit.
+          AC_DBG("%s:%ddBm, rejected\n", reinterpret_cast<const char*>(_credential.ssid), (int)WiFi.RSSI(n));
+          continue;
+        }
+        // Determine valid credential
+        switch (principle) {
+        case AC_PRINCIPLE_RECENT:
+          // By BSSID, exit to keep the credential just loaded.
+          _restoreSTA(_credential);
+          return true;
+
+        case AC_PRINCIPLE_RSSI:
+          // Verify that most strong radio signal.
+          // Continue seeking to find the strongest WIFI signal SSID.
+          if ((int32_t)WiFi.RSSI(n) > minRSSI) {
+            minRSSI = WiFi.RSSI(n);
+            memcpy(&validConfig, &_credential, sizeof(station_config_t));
           }
           break;
         }
@@ -1139,14 +1337,17 @@ void AutoConnectCore<T>::_stopDNSServer(void) {
 /**
  * Disconnect from the AP and stop the AutoConnect portal.
  * Stops DNS server and flush tcp sending.
+ * @param  flush  If true, waits for the tcp sending to be flushed. The
+ * handleRequest steps pass false as they have already waited for it.
  */
 template<typename T>
-void AutoConnectCore<T>::_stopPortal(void) {
+void AutoConnectCore<T>::_stopPortal(const bool flush) {
   _stopDNSServer();
 
   if (_webServer) {
     _webServer->client().stop();
-    delay(1000);
+    if (flush)
+      delay(1000);
   }
 
   _setReconnect(AC_RECONNECT_RESET);
@@ -1216,7 +1417,7 @@ void AutoConnectCore<T>::_handleNotFound(void) {
     else {
       String html404;
       PageElement*  page404 = new PageElement(FPSTR(_PAGE_404));
-      page404->addToken(F("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
+      page404->addToken(F("HEAD"), FPSTR(_ELM_HTML_HEAD));
       page404->build(html404);
       delete page404;
       _webServer->sendHeader(String(F("Cache-Control")), String(F("no-cache, no-store, must-revalidate")), true);
@@ -1322,6 +1523,7 @@ String AutoConnectCore<T>::_induceConnect(PageArgument& args) {
   }
 
   // Turn on the trigger to start WiFi.begin().
+  _portalStatus &= ~AC_FASTRECONNECT;
   _rfConnect = true;
 
 // Since v0.9.7, the redirect method changed from a 302 response to the
@@ -1347,10 +1549,15 @@ String AutoConnectCore<T>::_induceConnect(PageArgument& args) {
 /**
  * Responds response as redirect to the connection result page.
  * A destination as _redirectURI is indicated by loop to establish connection.
+ * While the attempt is still in progress, it lets the connecting page
+ * through, which polls this URI again after AUTOCONNECT_RESPONSE_WAITTIME.
  */
 template<typename T>
 String AutoConnectCore<T>::_invokeResult(PageArgument& args) {
   AC_UNUSED(args);
+  if (_rfConnect || _step == AC_STEP_RELEASING || _step == AC_STEP_CONNECTING)
+    return _emptyString;
+
   String redirect = String(F("http://"));
 
 #if defined(ARDUINO_ARCH_ESP32) || (ARDUINO_ESP8266_MAJOR >= 3 && ARDUINO_ESP8266_MINOR >= 1 && ARDUINO_ESP8266_REVISION >= 0)
@@ -1365,8 +1572,8 @@ String AutoConnectCore<T>::_invokeResult(PageArgument& args) {
   // This is the specification as before.
   redirect += _currentHostIP.toString();
 #endif
-  // Request re-query due to attempt connection not completed
-  redirect += _redirectURI.length() ? _redirectURI : String(F(AUTOCONNECT_URI_RESULT));
+  // No outcome remains without an attempt, such as a revisit.
+  redirect += _redirectURI.length() ? _redirectURI : String(F(AUTOCONNECT_URI_ONFAIL));
   // Redirect to result page
   _webServer->sendHeader(String(F("Location")), redirect, true);
   _webServer->send(302, String(F("text/plain")), _emptyString);
@@ -1547,59 +1754,83 @@ unsigned int AutoConnectCore<T>::_toWiFiQuality(int32_t rssi) {
 template<typename T>
 wl_status_t AutoConnectCore<T>::_waitForConnect(unsigned long timeout) {
   wl_status_t wifiStatus;
+
+  _startConnect();
+  while (!_pollConnect(timeout, &wifiStatus))
+    yield();
+  return wifiStatus;
+}
+
+/**
+ * Start the time measurement of the connection attempt issued by
+ * WiFi.begin. The attempt advances with _pollConnect.
+ */
+template<typename T>
+void AutoConnectCore<T>::_startConnect(void) {
   station_config_t  appliedConfig;
-  const unsigned long wt = millis();
-  unsigned long pt = wt;
-  bool  exitInterrupt = false;
 
   // Obtain the connecting SSID to pass to whileConnect exit.
   _getConfigSTA(&appliedConfig);
   *(reinterpret_cast<char*>(appliedConfig.ssid) + sizeof station_config_t::ssid) = '\0';
-  String  appliedSSID = String(reinterpret_cast<char*>(appliedConfig.ssid));
+  _connectSSID = String(reinterpret_cast<char*>(appliedConfig.ssid));
+  _stepPeriod = millis();
+  _connectTick = _stepPeriod;
+}
 
-  // Connection waiting
-  while ((wifiStatus = WiFi.status()) != WL_CONNECTED) {
-    yield();
-    unsigned long ct = millis();
-    if (timeout) {
-      if (ct - wt > timeout) {
-        _portalStatus |= AC_TIMEOUT;
-        break;
-      }
-    }
-    if (_whileConnecting) {
-      if ((exitInterrupt = !_whileConnecting(appliedSSID))) {
-        _portalStatus |= AC_INTERRUPT;
-        AC_DBG_DUMB("interrupted\n");
-        break;
-      }
-    }
-    if (ct - pt > 300) {
-      AC_DBG_DUMB("%c", '.');
-      pt = millis();
-    }
-  }
-  // Fix the connection state.
-  _portalStatus &= ~AC_INPROGRESS;
-  if (wifiStatus == WL_CONNECTED) {
-    _portalStatus |= AC_ESTABLISHED;
-    AC_DBG_DUMB("established");
-    IPAddress localIP = WiFi.localIP();
+/**
+ * Examine the connection attempt once without waiting.
+ * @param  timeout  Expiration time by millisecond unit from _startConnect.
+ * @param  wifiStatus A pointer to store the current WiFi status.
+ * @return true   The attempt is settled, wifiStatus has the result.
+ * @return false  The attempt is still in progress.
+ */
+template<typename T>
+bool AutoConnectCore<T>::_pollConnect(unsigned long timeout, wl_status_t* wifiStatus) {
+  *wifiStatus = WiFi.status();
+  if (*wifiStatus == WL_CONNECTED) {
     // The esp8266 station reconnection has a problem and can not get
     // the IP probably. We have to wait until we get the IP.
-    while ((uint32_t)localIP == 0UL) {
-      delay(10);
-      localIP = WiFi.localIP();
+    IPAddress localIP = WiFi.localIP();
+    if ((uint32_t)localIP == 0UL)
+      return false;
+
+    _portalStatus |= AC_ESTABLISHED;
+    AC_DBG_DUMB("established IP:%s\n", localIP.toString().c_str());
+    // Cache the access point for the next boot. A lease applied from the
+    // cache was not negotiated, so it is only counted and not saved anew.
+    if (_apConfig.fastReconnect) {
+      if (_rfCachedLease)
+        AutoConnectFastReconnect::reuseLease();
+      else
+        AutoConnectFastReconnect::save((uint32_t)_apConfig.staip == 0UL);
     }
-    AC_DBG_DUMB(" IP:%s\n", localIP.toString().c_str());
+    _rfCachedLease = false;
     if (_onConnectExit)
       _onConnectExit(localIP);
   }
-  else if (!exitInterrupt) {
-    AC_DBG_DUMB("timeout\n");
+  else {
+    unsigned long ct = millis();
+    if (timeout && ct - _stepPeriod > timeout) {
+      _portalStatus |= AC_TIMEOUT;
+      AC_DBG_DUMB("timeout\n");
+    }
+    else if (_whileConnecting && !_whileConnecting(_connectSSID)) {
+      _portalStatus |= AC_INTERRUPT;
+      AC_DBG_DUMB("interrupted\n");
+    }
+    else {
+      if (ct - _connectTick > 300) {
+        AC_DBG_DUMB("%c", '.');
+        _connectTick = ct;
+      }
+      return false;
+    }
   }
+
+  // Fix the connection state.
+  _portalStatus &= ~AC_INPROGRESS;
   _attemptPeriod = millis();  // Save to measure the interval between an autoReconnect.
-  return wifiStatus;
+  return true;
 }
 
 /**
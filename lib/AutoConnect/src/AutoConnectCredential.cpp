@@ -7,10 +7,67 @@
  *	@copyright	MIT license.
  */
 
+#include <new>
 #include "AutoConnectCredential.h"
 
+/**
+ *  Find the first saved entry that matches an access point. An entry
+ *  saved with a BSSID matches the access point with that BSSID, other
+ *  entries match by the SSID. If the bssid is null, all the entries
+ *  match by the SSID.
+ *  @param  ssid    SSID of the access point.
+ *  @param  bssid   BSSID of the access point, or nullptr.
+ *  @param  config  A station_config structure pointer to load the entry.
+ *  @retval The entry number. If the number less than 0, no entry matched.
+ */
+int8_t AutoConnectCredentialBase::seek(const char* ssid, const uint8_t* bssid, station_config_t* config) {
+  for (uint8_t i = 0; i < entries(); i++) {
+    if (load(i, config) && _matchAP(*config, ssid, bssid))
+      return i;
+  }
+  return -1;
+}
+
+/**
+ *  Determine whether the BSSID is saved, an unsaved BSSID is all zero.
+ *  @param  bssid   BSSID of the entry.
+ *  @retval true    The BSSID is saved.
+ */
+bool AutoConnectCredentialBase::_hasBSSID(const uint8_t* bssid) {
+  for (uint8_t i = 0; i < sizeof(station_config_t::bssid); i++) {
+    if (bssid[i])
+      return true;
+  }
+  return false;
+}
+
+/**
+ *  Collate a saved entry with an access point as described with seek.
+ *  @param  config  The saved entry.
+ *  @param  ssid    SSID of the access point.
+ *  @param  bssid   BSSID of the access point, or nullptr.
+ *  @retval true    The entry matches the access point.
+ */
+bool AutoConnectCredentialBase::_matchAP(const station_config_t& config, const char* ssid, const uint8_t* bssid) {
+  if (bssid && _hasBSSID(config.bssid))
+    return !memcmp(config.bssid, bssid, sizeof(station_config_t::bssid));
+  return !strcmp(reinterpret_cast<const char*>(config.ssid), ssid);
+}
+
 #if AC_CREDENTIAL_PREFERENCES == 0
 
+/**
+ *  FNV-1a hash folded to 16 bits, for the directory of the entries.
+ */
+static uint16_t _hashCredt(const uint8_t* key, size_t len) {
+  uint32_t  h = 2166136261UL;
+  while (len--) {
+    h ^= *key++;
+    h *= 16777619UL;
+  }
+  return static_cast<uint16_t>(h ^ (h >> 16));
+}
+
 #define AC_HEADERSIZE ((int)(_offset + sizeof(AC_IDENTIFIER) - 1 + sizeof(uint8_t) + sizeof(uint16_t)))
 /**
  *  AutoConnectCredential constructor takes the available count of saved
@@ -49,6 +106,13 @@ AutoConnectCredential::AutoConnectCredential(uint16_t offset) {
   _allocateEntry();
 }
 
+uint16_t  AutoConnectCredential::_slotSize = 0;
+uint16_t  AutoConnectCredential::_dirOffset = 0;
+uint8_t   AutoConnectCredential::_dirEntries = 0;
+uint16_t  AutoConnectCredential::_dirContainSize = 0;
+std::unique_ptr<AutoConnectCredential::AC_CREDTINDEX_t[]> AutoConnectCredential::_dir;
+std::unique_ptr<uint16_t[]> AutoConnectCredential::_slots;
+
 void AutoConnectCredential::_allocateEntry(void) {
   char    id_c[sizeof(AC_IDENTIFIER) - 1];
 
@@ -127,6 +191,9 @@ bool AutoConnectCredential::del(const char* ssid) {
     rc = _eeprom->commit();
     delay(10);
     _eeprom->end();
+
+    // The entries are renumbered, rebuild the directory on the next lookup.
+    _dropIndex();
   }
   return rc;
 }
@@ -143,6 +210,20 @@ bool AutoConnectCredential::del(const char* ssid) {
 int8_t AutoConnectCredential::load(const char* ssid, station_config_t* config) {
   int8_t  entry = -1;
 
+  // Probe the SSID hash table, and verify the SSID of the entries with
+  // the same hash.
+  if (_index()) {
+    const uint16_t  hash = _hashCredt(reinterpret_cast<const uint8_t*>(ssid), strlen(ssid));
+    const uint16_t  mask = _slotSize - 1;
+    for (uint16_t s = hash & mask; _slots[s]; s = (s + 1) & mask) {
+      const uint8_t e = _slots[s] - 1;
+      if (_dir[e].hash == hash && load(static_cast<int8_t>(e), config) && !strcmp(ssid, reinterpret_cast<const char*>(config->ssid)))
+        return static_cast<int8_t>(e);
+    }
+    return entry;
+  }
+
+  // Without the directory, walk the entries in EEPROM.
   _dp = AC_HEADERSIZE;
   if (_entries) {
     _eeprom->begin(AC_HEADERSIZE + _containSize);
@@ -168,6 +249,15 @@ int8_t AutoConnectCredential::load(const char* ssid, station_config_t* config) {
  *          false   The number is not available.
  */
 bool AutoConnectCredential::load(int8_t entry, station_config_t* config) {
+  if (entry >= 0 && entry < _entries && _index()) {
+    // The directory has the entry address.
+    _dp = _dir[entry].addr;
+    _eeprom->begin(AC_HEADERSIZE + _containSize);
+    _retrieveEntry(config);
+    _eeprom->end();
+    return true;
+  }
+
   _dp = AC_HEADERSIZE;
   if (_entries && entry < _entries) {
     _eeprom->begin(AC_HEADERSIZE + _containSize);
@@ -181,6 +271,47 @@ bool AutoConnectCredential::load(int8_t entry, station_config_t* config) {
   }
 }
 
+/**
+ *  Find the first saved entry that matches an access point, as described
+ *  with AutoConnectCredentialBase::seek. The candidates are probed in the
+ *  hash tables of the directory and only those are read from EEPROM.
+ *  @param  ssid    SSID of the access point.
+ *  @param  bssid   BSSID of the access point, or nullptr.
+ *  @param  config  A station_config structure pointer to load the entry.
+ *  @retval The entry number. If the number less than 0, no entry matched.
+ */
+int8_t AutoConnectCredential::seek(const char* ssid, const uint8_t* bssid, station_config_t* config) {
+  if (!_index())
+    return AutoConnectCredentialBase::seek(ssid, bssid, config);
+
+  int8_t  entry = -1;
+  if (bssid) {
+    const uint16_t  mask = _slotSize - 1;
+    const uint16_t* slots = _slots.get() + _slotSize;
+    for (uint16_t s = _hashCredt(bssid, sizeof(station_config_t::bssid)) & mask; slots[s]; s = (s + 1) & mask) {
+      const int8_t  e = static_cast<int8_t>(slots[s] - 1);
+      if (!memcmp(_dir[e].bssid, bssid, sizeof(station_config_t::bssid)) && (entry < 0 || e < entry))
+        entry = e;
+    }
+  }
+
+  // The entries of the SSID match unless they are to be collated by the
+  // BSSID. Their SSID hash is checked before reading EEPROM.
+  const uint16_t  hash = _hashCredt(reinterpret_cast<const uint8_t*>(ssid), strlen(ssid));
+  const uint16_t  mask = _slotSize - 1;
+  for (uint16_t s = hash & mask; _slots[s]; s = (s + 1) & mask) {
+    const int8_t  e = static_cast<int8_t>(_slots[s] - 1);
+    if (_dir[e].hash == hash && (!bssid || !_hasBSSID(_dir[e].bssid)) && (entry < 0 || e < entry)) {
+      station_config_t  named;
+      if (load(e, &named) && !strcmp(ssid, reinterpret_cast<const char*>(named.ssid)))
+        entry = e;
+    }
+  }
+  if (entry >= 0)
+    load(entry, config);
+  return entry;
+}
+
 /**
  *  Save SSID and password to EEPROM.
  *  When the same SSID already exists, it will be replaced. If the current
@@ -293,6 +424,8 @@ bool AutoConnectCredential::save(const station_config_t* config) {
   delay(10);
   _eeprom->end();
 
+  // Entries have moved, rebuild the directory on the next lookup.
+  _dropIndex();
   return rc;
 }
 
@@ -374,9 +507,84 @@ bool  AutoConnectCredential::restore(Stream& in) {
   if (rc)
     AC_DBG("Credentials restored\n");
 
+  _dropIndex();
   return rc;
 }
 
+/**
+ *  Build the directory of the saved entries with one pass over EEPROM.
+ *  It holds the address, the SSID hash and the BSSID of each entry, and
+ *  two open addressing hash tables to find the entries by the SSID and
+ *  by the BSSID. The directory is shared by all instances and lasts
+ *  until the entries are changed. It is rebuilt if this instance sees a
+ *  different credential area than the one it was built from.
+ *  @retval true    The directory is available.
+ *  @retval false   No entries, or the directory could not be allocated.
+ */
+bool AutoConnectCredential::_index(void) {
+  if (_dir) {
+    if (_dirOffset == _offset && _dirEntries == _entries && _dirContainSize == _containSize)
+      return true;
+    _dropIndex();
+  }
+  if (!_entries)
+    return false;
+
+  // Keep the tables at most half full.
+  uint16_t  size = 4;
+  while (size < _entries * 2U)
+    size <<= 1;
+  _dir.reset(new (std::nothrow) AC_CREDTINDEX_t[_entries]);
+  _slots.reset(new (std::nothrow) uint16_t[size * 2]());
+  if (!_dir || !_slots) {
+    AC_DBG("Credential directory allocation failed\n");
+    _dropIndex();
+    return false;
+  }
+  _slotSize = size;
+  _dirOffset = _offset;
+  _dirEntries = _entries;
+  _dirContainSize = _containSize;
+
+  station_config_t  config;
+  _dp = AC_HEADERSIZE;
+  _eeprom->begin(AC_HEADERSIZE + _containSize);
+  for (uint8_t i = 0; i < _entries; i++) {
+    _retrieveEntry(&config);
+    AC_CREDTINDEX_t&  dir = _dir[i];
+    dir.addr = static_cast<uint16_t>(_ep);
+    dir.hash = _hashCredt(config.ssid, strlen(reinterpret_cast<const char*>(config.ssid)));
+    memcpy(dir.bssid, config.bssid, sizeof(AC_CREDTINDEX_t::bssid));
+    _insertSlot(_slots.get(), dir.hash, i);
+    if (_hasBSSID(dir.bssid))
+      _insertSlot(_slots.get() + _slotSize, _hashCredt(dir.bssid, sizeof(AC_CREDTINDEX_t::bssid)), i);
+  }
+  _eeprom->end();
+  return true;
+}
+
+/**
+ *  Discard the directory, the next lookup rebuilds it.
+ */
+void AutoConnectCredential::_dropIndex(void) {
+  _dir.reset();
+  _slots.reset();
+}
+
+/**
+ *  Register an entry in a hash table with the linear probing.
+ *  @param  slots   The hash table.
+ *  @param  hash    Hash of the key.
+ *  @param  entry   The entry number.
+ */
+void AutoConnectCredential::_insertSlot(uint16_t* slots, uint16_t hash, uint8_t entry) {
+  const uint16_t  mask = _slotSize - 1;
+  uint16_t  s = hash & mask;
+  while (slots[s])
+    s = (s + 1) & mask;
+  slots[s] = entry + 1;
+}
+
 /**
  *  Get the SSID and password from EEPROM indicated by _dp as the pointer
  *  of current read address. FF is skipped as unavailable area.
@@ -533,6 +741,27 @@ bool AutoConnectCredential::load(int8_t entry, station_config_t* config) {
   return false;
 }
 
+/**
+ *  Find the first saved entry that matches an access point, as described
+ *  with AutoConnectCredentialBase::seek. The saved credentials are
+ *  imported once and collated in one pass over the dictionary.
+ *  @param  ssid    SSID of the access point.
+ *  @param  bssid   BSSID of the access point, or nullptr.
+ *  @param  config  A station_config structure pointer to load the entry.
+ *  @retval The entry number. If the number less than 0, no entry matched.
+ */
+int8_t AutoConnectCredential::seek(const char* ssid, const uint8_t* bssid, station_config_t* config) {
+  int8_t  en = 0;
+  _entries = _import();
+  for (decltype(_credit)::iterator it = _credit.begin(), e = _credit.end(); it != e; ++it) {
+    _obtain(it, config);
+    if (_matchAP(*config, ssid, bssid))
+      return en;
+    en++;
+  }
+  return -1;
+}
+
 /**
  *  Save SSID and password to Preferences.
  *  When the same SSID already exists, it will be replaced. If the current
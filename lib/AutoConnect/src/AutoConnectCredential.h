@@ -87,12 +87,16 @@ class AutoConnectCredentialBase {
   virtual bool    del(const char* ssid) = 0;
   virtual int8_t  load(const char* ssid, station_config_t* config) = 0;
   virtual bool    load(int8_t entry, station_config_t* config) = 0;
+  virtual int8_t  seek(const char* ssid, const uint8_t* bssid, station_config_t* config);
+  virtual bool    index(void) { return false; }
   virtual bool    save(const station_config_t* config) = 0;
   virtual bool    backup(Stream& out) = 0;
   virtual bool    restore(Stream& in) = 0;
 
  protected:
   virtual void  _allocateEntry(void) = 0; /**< Initialize storage for credentials. */
+  static bool   _hasBSSID(const uint8_t* bssid);  /**< The BSSID is saved */
+  static bool   _matchAP(const station_config_t& config, const char* ssid, const uint8_t* bssid); /**< Collate an entry with an access point */
 
   uint8_t   _entries;       /**< Count of the available entry */
   uint16_t  _containSize;   /**< Container size */
@@ -112,6 +116,8 @@ class AutoConnectCredential : public AutoConnectCredentialBase {
   bool    del(const char* ssid) override;
   int8_t  load(const char* ssid, station_config_t* config) override;
   bool    load(int8_t entry, station_config_t* config) override;
+  int8_t  seek(const char* ssid, const uint8_t* bssid, station_config_t* config) override;
+  bool    index(void) override { return _index(); }
   bool    save(const station_config_t* config) override;
   bool    backup(Stream& out) override;
   bool    restore(Stream& in) override;
@@ -126,12 +132,30 @@ class AutoConnectCredential : public AutoConnectCredentialBase {
     uint16_t ss;
   } AC_CREDTHEADER_t;       /**< Header of AutConnectCredential */
 
+  typedef struct {
+    uint16_t  addr;         /**< Address of the entry in EEPROM */
+    uint16_t  hash;         /**< Hash of the SSID */
+    uint8_t   bssid[6];     /**< Saved BSSID, all zero if none */
+  } AC_CREDTINDEX_t;        /**< Directory entry of a saved credential */
+
+  bool    _index(void);     /**< Build the directory of the saved entries. */
+  static void _dropIndex(void); /**< Discard the directory after the entries change. */
+  void    _insertSlot(uint16_t* slots, uint16_t hash, uint8_t entry); /**< Register an entry in a hash table */
   void    _retrieveEntry(station_config_t* config);   /**< Read an available entry. */
 
   int       _dp;            /**< The current address in EEPROM */
   int       _ep;            /**< The current entry address in EEPROM */
   uint16_t  _offset;        /**< The offset for the saved area of credentials in EEPROM. */
   std::unique_ptr<EEPROMClass>  _eeprom;  /**< shared EEPROM class */
+
+  // The directory is shared by all instances, any of them that changes
+  // the entries discards it.
+  static uint16_t _slotSize;      /**< Slots of each hash table, a power of 2 */
+  static uint16_t _dirOffset;     /**< The offset of the credential area the directory was built from */
+  static uint8_t  _dirEntries;    /**< Number of the entries the directory was built from */
+  static uint16_t _dirContainSize;  /**< Container size the directory was built from */
+  static std::unique_ptr<AC_CREDTINDEX_t[]>  _dir; /**< Directory of the entries, built at the first lookup */
+  static std::unique_ptr<uint16_t[]> _slots; /**< SSID and BSSID hash tables of entry number + 1, 0 is empty */
 };
 
 #else
@@ -159,6 +183,7 @@ class AutoConnectCredential : public AutoConnectCredentialBase {
   uint8_t entries(void) override;
   int8_t  load(const char* ssid, station_config_t* config) override;
   bool    load(int8_t entry, station_config_t* config) override;
+  int8_t  seek(const char* ssid, const uint8_t* bssid, station_config_t* config) override;
   bool    save(const station_config_t* config) override;
   bool    backup(Stream& out) override;
   bool    restore(Stream& in) override;
@@ -182,6 +182,24 @@
 #define AUTOCONNECT_RECONNECT_DELAY   0
 #endif // !AUTOCONNECT_RECONNECT_DELAY
 
+// Time-out limitation [ms] of the direct connection to the access point
+// cached by AutoConnectConfig::fastReconnect
+#ifndef AUTOCONNECT_FASTRECONNECT_TIMEOUT
+#define AUTOCONNECT_FASTRECONNECT_TIMEOUT 3000
+#endif // !AUTOCONNECT_FASTRECONNECT_TIMEOUT
+
+// Number of connections that may apply the DHCP lease cached by
+// AutoConnectConfig::fastReconnect statically, before DHCP runs again
+#ifndef AUTOCONNECT_FASTRECONNECT_LEASEREUSE
+#define AUTOCONNECT_FASTRECONNECT_LEASEREUSE  4
+#endif // !AUTOCONNECT_FASTRECONNECT_LEASEREUSE
+
+// Offset of the fast reconnect record in the ESP8266 RTC user memory,
+// by 4-byte blocks. The first 128 bytes are reserved for OTA.
+#ifndef AUTOCONNECT_FASTRECONNECT_RTCOFFSET
+#define AUTOCONNECT_FASTRECONNECT_RTCOFFSET 32
+#endif // !AUTOCONNECT_FASTRECONNECT_RTCOFFSET
+
 // Captive portal timeout value [ms]
 #ifndef AUTOCONNECT_CAPTIVEPORTAL_TIMEOUT
 #define AUTOCONNECT_CAPTIVEPORTAL_TIMEOUT 0
@@ -343,6 +361,11 @@
 #define AUTOCONNECT_UPDATE_CATALOG_JSONBUFFER_SIZE  256
 #endif // !AUTOCONNECT_UPDATE_CATALOG_JSONBUFFER_SIZE
 
+// Number of firmwares listed on one page of the update catalog
+#ifndef AUTOCONNECT_UPDATE_CATALOG_PAGESIZE
+#define AUTOCONNECT_UPDATE_CATALOG_PAGESIZE 8
+#endif // !AUTOCONNECT_UPDATE_CATALOG_PAGESIZE
+
 // HTTP authentication default realm
 #ifndef AUTOCONNECT_AUTH_REALM
 #define AUTOCONNECT_AUTH_REALM        "AUTOCONNECT"
@@ -0,0 +1,234 @@
+/**
+ *  AutoConnectDelta class implementation.
+ *  Reconstructs a firmware image from the running image and a binary
+ *  patch received in arbitrary pieces, with the fixed size buffers.
+ *  @file   AutoConnectDelta.cpp
+ *  @copyright  MIT license.
+ */
+
+#include <string.h>
+#include "AutoConnectDelta.h"
+
+namespace {
+const uint8_t _magic[] = { 'A', 'C', 'D', '1' };
+}
+
+/**
+ * Constructs the applier.
+ * @param reader   A function that reads the running image.
+ * @param writer   A function that writes the reconstructed image.
+ * @param verifier A function that accepts the patch header before the
+ * image is reconstructed. It can refuse a patch which is made against
+ * an image other than the running one.
+ */
+AutoConnectDelta::AutoConnectDelta(ReaderFunction_ft reader, WriterFunction_ft writer, VerifierFunction_ft verifier)
+  : _reader(reader), _writer(writer), _verifier(verifier), _state(AC_DELTA_HEADER), _hdrLen(0), _value(0), _shift(0), _field(0), _count(0), _srcPos(0), _dstPos(0), _srcBase(0), _srcLen(0), _outLen(0) {
+  memset(&_header, 0, sizeof(_header));
+  memset(_ctl, 0, sizeof(_ctl));
+}
+
+/**
+ * Check whether the buffer begins with the patch header.
+ * @param buf  The first part of the uploaded data.
+ * @param size Size of the buffer.
+ * @return true  The data is a patch.
+ */
+bool AutoConnectDelta::isPatch(const uint8_t* buf, const size_t size) {
+  return size >= sizeof(_magic) && !memcmp(buf, _magic, sizeof(_magic));
+}
+
+/**
+ * Apply the next part of the patch. The reconstructed image is handed
+ * to the writer each time the output buffer is filled.
+ * @param buf  The next part of the patch.
+ * @param size Size of the part.
+ * @return The number of bytes consumed. It is less than the size if
+ * the patch is malformed or the reader or the writer has failed.
+ */
+size_t AutoConnectDelta::feed(const uint8_t* buf, const size_t size) {
+  size_t  n;
+
+  for (n = 0; n < size; n++) {
+    const uint8_t c = buf[n];
+    uint8_t s;
+
+    switch (_state) {
+    case AC_DELTA_HEADER:
+      _hdr[_hdrLen++] = c;
+      if (_hdrLen == sizeof(_hdr) && !_parseHeader())
+        _state = AC_DELTA_ERROR;
+      break;
+    case AC_DELTA_CONTROL:
+      if (_varint(c)) {
+        _ctl[_field++] = _value;
+        if (_field == sizeof(_ctl) / sizeof(_ctl[0]) && !_control())
+          _state = AC_DELTA_ERROR;
+      }
+      break;
+    case AC_DELTA_DIFF:
+      if (_varint(c)) {
+        _count = _value >> 1;
+        if (!_count || _count > _ctl[1]) {
+          _state = AC_DELTA_ERROR;
+          break;
+        }
+        _ctl[1] -= _count;
+        if (_value & 1) {
+          _state = AC_DELTA_ADD;
+          break;
+        }
+        // The unchanged bytes are copied without receiving data.
+        while (_count) {
+          if (!_source(&s) || !_emit(s))
+            break;
+          _count--;
+        }
+        if (_count)
+          _state = AC_DELTA_ERROR;
+        else
+          _control();
+      }
+      break;
+    case AC_DELTA_ADD:
+      if (!_source(&s) || !_emit(s + c))
+        _state = AC_DELTA_ERROR;
+      else if (!--_count)
+        _control();
+      break;
+    case AC_DELTA_EXTRA:
+      if (!_emit(c))
+        _state = AC_DELTA_ERROR;
+      else if (!--_ctl[2])
+        _control();
+      break;
+    default:
+      // Trailing data after the completion is also malformed.
+      _state = AC_DELTA_ERROR;
+      break;
+    }
+    if (_state == AC_DELTA_ERROR)
+      break;
+  }
+  return n;
+}
+
+/**
+ * Flush the rest of the reconstructed image.
+ * @return true  The image has been reconstructed completely.
+ */
+bool AutoConnectDelta::end(void) {
+  if (_state != AC_DELTA_DONE)
+    return false;
+  if (!_flush()) {
+    _state = AC_DELTA_ERROR;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Decode the received header and pass it to the verifier.
+ * @return false The header is invalid or refused.
+ */
+bool AutoConnectDelta::_parseHeader(void) {
+  if (memcmp(_hdr, _magic, sizeof(_magic)))
+    return false;
+  _header.srcSize = _le32(_hdr + 4);
+  _header.dstSize = _le32(_hdr + 8);
+  memcpy(_header.srcMD5, _hdr + 12, sizeof(_header.srcMD5));
+  memcpy(_header.dstMD5, _hdr + 28, sizeof(_header.dstMD5));
+  if (!_header.dstSize)
+    return false;
+  if (_verifier && !_verifier(_header))
+    return false;
+  _state = AC_DELTA_CONTROL;
+  return true;
+}
+
+/**
+ * Accumulate a byte of a varint.
+ * @return true  The varint is completed in _value.
+ */
+bool AutoConnectDelta::_varint(const uint8_t c) {
+  if (!_shift)
+    _value = 0;
+  else if (_shift > 28) {
+    _state = AC_DELTA_ERROR;
+    return false;
+  }
+  _value |= (uint32_t)(c & 0x7f) << _shift;
+  _shift += 7;
+  if (c & 0x80)
+    return false;
+  _shift = 0;
+  return true;
+}
+
+/**
+ * Advance to the next part of the block. When the block control has
+ * just been received, it applies the seek.
+ * @return false The seek exceeds the source image.
+ */
+bool AutoConnectDelta::_control(void) {
+  if (_state == AC_DELTA_CONTROL && _field) {
+    // The seek is a zigzag encoded signed value.
+    _srcPos += (_ctl[0] >> 1) ^ (uint32_t)-(int32_t)(_ctl[0] & 1);
+    if (_srcPos > _header.srcSize)
+      return false;
+  }
+  _field = 0;
+  if (_ctl[1] && (_state == AC_DELTA_CONTROL || _state == AC_DELTA_DIFF || _state == AC_DELTA_ADD))
+    _state = AC_DELTA_DIFF;
+  else if (_ctl[2] && _state != AC_DELTA_EXTRA)
+    _state = AC_DELTA_EXTRA;
+  else {
+    // The block is completed.
+    memset(_ctl, 0, sizeof(_ctl));
+    _state = written() == _header.dstSize ? AC_DELTA_DONE : AC_DELTA_CONTROL;
+  }
+  return true;
+}
+
+/**
+ * Read a byte at the current position of the source image through the
+ * source cache.
+ * @return false The position exceeds the source image or reading failed.
+ */
+bool AutoConnectDelta::_source(uint8_t* c) {
+  if (_srcPos >= _header.srcSize)
+    return false;
+  if (_srcPos < _srcBase || _srcPos >= _srcBase + _srcLen) {
+    _srcBase = _srcPos;
+    _srcLen = _header.srcSize - _srcPos < sizeof(_srcBuf) ? _header.srcSize - _srcPos : sizeof(_srcBuf);
+    if (!_reader(_srcBase, _srcBuf, _srcLen)) {
+      _srcLen = 0;
+      return false;
+    }
+  }
+  *c = _srcBuf[_srcPos++ - _srcBase];
+  return true;
+}
+
+/**
+ * Append a byte to the reconstructed image.
+ * @return false The image exceeds the target size or writing failed.
+ */
+bool AutoConnectDelta::_emit(const uint8_t c) {
+  if (written() >= _header.dstSize)
+    return false;
+  _outBuf[_outLen++] = c;
+  return _outLen < sizeof(_outBuf) ? true : _flush();
+}
+
+/**
+ * Hand the buffered output to the writer.
+ */
+bool AutoConnectDelta::_flush(void) {
+  if (_outLen) {
+    if (!_writer(_outBuf, _outLen))
+      return false;
+    _dstPos += _outLen;
+    _outLen = 0;
+  }
+  return true;
+}
@@ -0,0 +1,102 @@
+/**
+ *  Declaration of AutoConnectDelta class.
+ *  @file   AutoConnectDelta.h
+ *  @copyright  MIT license.
+ */
+
+#ifndef _AUTOCONNECTDELTA_H_
+#define _AUTOCONNECTDELTA_H_
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+// The size of each of the source and the output buffers held by the
+// patch applier. It does not depend on the size of the firmware.
+#ifndef AUTOCONNECT_DELTA_BUFFER_SIZE
+#define AUTOCONNECT_DELTA_BUFFER_SIZE 256
+#endif // !AUTOCONNECT_DELTA_BUFFER_SIZE
+
+/**
+ * Streaming applier of a binary patch which reconstructs a new firmware
+ * image from the running image. It does not depend on the Arduino core
+ * so that the patch format can be verified on the host.
+ * The patch is produced by updateserver/python3/deltapatch.py and
+ * consists of a header followed by a sequence of blocks:
+ *   header  "ACD1", source size, target size (uint32 LE),
+ *           MD5 of the source image, MD5 of the target image.
+ *   block   seek (zigzag varint), diff length (varint),
+ *           extra length (varint), diff data, extra bytes.
+ * A block moves the source position by seek, then adds the diff data
+ * to the source bytes from there, then appends the extra bytes as is.
+ * The diff data is a sequence of varint tokens, an even token n is
+ * n/2 unchanged bytes and an odd token n is followed by n/2 bytes to
+ * be added.
+ */
+class AutoConnectDelta {
+ public:
+  typedef struct {
+    uint32_t  srcSize;      /**< Size of the image the patch is made against */
+    uint32_t  dstSize;      /**< Size of the reconstructed image */
+    uint8_t   srcMD5[16];   /**< MD5 of the image the patch is made against */
+    uint8_t   dstMD5[16];   /**< MD5 of the reconstructed image */
+  } AC_DELTAHEADER_t;
+
+  typedef enum {
+    AC_DELTA_HEADER,        /**< Receiving the header */
+    AC_DELTA_CONTROL,       /**< Receiving the block control */
+    AC_DELTA_DIFF,          /**< Receiving a diff token */
+    AC_DELTA_ADD,           /**< Receiving the bytes to be added */
+    AC_DELTA_EXTRA,         /**< Appending the extra bytes */
+    AC_DELTA_DONE,          /**< The image is completed */
+    AC_DELTA_ERROR          /**< Malformed patch or I/O failure */
+  } AC_DELTASTATE_t;
+
+  // Reads the source image at the offset
+  typedef std::function<bool(uint32_t, uint8_t*, size_t)> ReaderFunction_ft;
+  // Writes the next part of the reconstructed image
+  typedef std::function<bool(const uint8_t*, size_t)>  WriterFunction_ft;
+  // Accepts the image that the patch is made against
+  typedef std::function<bool(const AC_DELTAHEADER_t&)> VerifierFunction_ft;
+
+  AutoConnectDelta(ReaderFunction_ft reader, WriterFunction_ft writer, VerifierFunction_ft verifier = nullptr);
+  ~AutoConnectDelta() {}
+  size_t  feed(const uint8_t* buf, const size_t size);
+  bool  end(void);
+  const AC_DELTAHEADER_t& header(void) const { return _header; }  /**< Returns the patch header */
+  AC_DELTASTATE_t state(void) const { return _state; }            /**< Returns the applying state */
+  uint32_t  written(void) const { return _dstPos + _outLen; }     /**< Returns the size of the reconstructed image so far */
+
+  static bool isPatch(const uint8_t* buf, const size_t size);
+
+ private:
+  bool  _parseHeader(void);
+  bool  _varint(const uint8_t c);
+  bool  _control(void);
+  bool  _source(uint8_t* c);
+  bool  _emit(const uint8_t c);
+  bool  _flush(void);
+  static uint32_t _le32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+  ReaderFunction_ft   _reader;
+  WriterFunction_ft   _writer;
+  VerifierFunction_ft _verifier;
+  AC_DELTASTATE_t _state;
+  AC_DELTAHEADER_t  _header;
+  uint8_t   _hdr[44];       /**< The header being received */
+  uint8_t   _hdrLen;        /**< Received header bytes */
+  uint32_t  _value;         /**< Varint being received */
+  uint8_t   _shift;         /**< Bit position of the next varint byte */
+  uint8_t   _field;         /**< Index of the block control field */
+  uint32_t  _ctl[3];        /**< seek, diff length, extra length */
+  uint32_t  _count;         /**< Remaining bytes of the current run */
+  uint32_t  _srcPos;        /**< Current position in the source image */
+  uint32_t  _dstPos;        /**< Flushed size of the reconstructed image */
+  uint32_t  _srcBase;       /**< Source offset of the cached bytes */
+  size_t    _srcLen;        /**< Number of the cached source bytes */
+  size_t    _outLen;        /**< Number of the buffered output bytes */
+  uint8_t   _srcBuf[AUTOCONNECT_DELTA_BUFFER_SIZE]; /**< Source cache */
+  uint8_t   _outBuf[AUTOCONNECT_DELTA_BUFFER_SIZE]; /**< Output buffer */
+};
+
+#endif // !_AUTOCONNECTDELTA_H_
@@ -0,0 +1,188 @@
+/**
+ *  AutoConnectExpander class implementation.
+ *  Decompresses an image received in arbitrary pieces within the
+ *  window declared by the image.
+ *  @file   AutoConnectExpander.cpp
+ *  @copyright  MIT license.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "AutoConnectExpander.h"
+
+namespace {
+const uint8_t _magic[] = { 'A', 'C', 'Z', '1' };
+}
+
+/**
+ * Constructs the expander.
+ * @param writer   A function that writes the decompressed image.
+ * @param verifier A function that accepts the image header before
+ * the image is decompressed.
+ */
+AutoConnectExpander::AutoConnectExpander(WriterFunction_ft writer, VerifierFunction_ft verifier)
+  : _writer(writer), _verifier(verifier), _state(AC_EXPANDER_HEADER), _hdrLen(0), _acc(0), _accBits(0), _distance(0), _window(nullptr), _head(0), _flushed(0), _expanded(0), _crc(0xffffffff) {
+  memset(&_header, 0, sizeof(_header));
+}
+
+AutoConnectExpander::~AutoConnectExpander() {
+  free(_window);
+}
+
+/**
+ * Check whether the buffer begins with the compressed image header.
+ * @param buf  The first part of the uploaded data.
+ * @param size Size of the buffer.
+ * @return true  The data is a compressed image.
+ */
+bool AutoConnectExpander::isCompressed(const uint8_t* buf, const size_t size) {
+  return size >= sizeof(_magic) && !memcmp(buf, _magic, sizeof(_magic));
+}
+
+/**
+ * Decompress the next part of the image.
+ * @param buf  The next part of the compressed image.
+ * @param size Size of the part.
+ * @return The number of bytes consumed. It is less than the size if
+ * the image is malformed or the writer has failed.
+ */
+size_t AutoConnectExpander::feed(const uint8_t* buf, const size_t size) {
+  size_t  n;
+
+  for (n = 0; n < size && _state != AC_EXPANDER_ERROR; n++) {
+    if (_state == AC_EXPANDER_HEADER) {
+      _hdr[_hdrLen++] = buf[n];
+      if (_hdrLen == sizeof(_hdr) && !_parseHeader())
+        _state = AC_EXPANDER_ERROR;
+      continue;
+    }
+    // The padding bits of the last byte are ignored.
+    if (_state == AC_EXPANDER_DONE)
+      continue;
+
+    _acc = (_acc << 8) | buf[n];
+    _accBits += 8;
+    while (_state != AC_EXPANDER_DONE && _state != AC_EXPANDER_ERROR) {
+      uint8_t need;
+      if (_state == AC_EXPANDER_TAG)
+        need = 1;
+      else if (_state == AC_EXPANDER_LITERAL)
+        need = 8;
+      else if (_state == AC_EXPANDER_DISTANCE)
+        need = _header.window;
+      else
+        need = _header.lookahead;
+      if (_accBits < need)
+        break;
+      _accBits -= need;
+      const uint32_t  value = (_acc >> _accBits) & ((1UL << need) - 1);
+      _acc &= (1UL << _accBits) - 1;
+      if (!_decode(value))
+        _state = AC_EXPANDER_ERROR;
+    }
+  }
+  return _state == AC_EXPANDER_ERROR && n ? n - 1 : n;
+}
+
+/**
+ * Write the rest of the decompressed image and verify it.
+ * @return true  The image is complete and its CRC32 matches.
+ */
+bool AutoConnectExpander::end(void) {
+  if (_state != AC_EXPANDER_DONE || !_flush() || ~_crc != _header.crc) {
+    _state = AC_EXPANDER_ERROR;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Decode the received header, then allocate the window.
+ * @return false The header is invalid or refused.
+ */
+bool AutoConnectExpander::_parseHeader(void) {
+  if (memcmp(_hdr, _magic, sizeof(_magic)))
+    return false;
+  _header.window = _hdr[4];
+  _header.lookahead = _hdr[5];
+  _header.size = _le32(_hdr + 8);
+  _header.crc = _le32(_hdr + 12);
+  memcpy(_header.md5, _hdr + 16, sizeof(_header.md5));
+  if (_header.window < 4 || _header.window > AUTOCONNECT_EXPANDER_WINDOW_MAX || _header.lookahead < 3 || _header.lookahead >= _header.window || !_header.size)
+    return false;
+  if (_verifier && !_verifier(_header))
+    return false;
+  _window = static_cast<uint8_t*>(malloc(1UL << _header.window));
+  if (!_window)
+    return false;
+  _state = AC_EXPANDER_TAG;
+  return true;
+}
+
+/**
+ * Act on a field of the bit stream.
+ * @param value The field value.
+ * @return false A back reference points before the top of the image.
+ */
+bool AutoConnectExpander::_decode(const uint32_t value) {
+  switch (_state) {
+  case AC_EXPANDER_TAG:
+    _state = value ? AC_EXPANDER_LITERAL : AC_EXPANDER_DISTANCE;
+    break;
+  case AC_EXPANDER_LITERAL:
+    if (!_emit(static_cast<uint8_t>(value)))
+      return false;
+    _state = AC_EXPANDER_TAG;
+    break;
+  case AC_EXPANDER_DISTANCE:
+    _distance = value + 1;
+    if (_distance > _expanded)
+      return false;
+    _state = AC_EXPANDER_LENGTH;
+    break;
+  default: {
+    const uint16_t  mask = (1U << _header.window) - 1;
+    for (uint32_t i = 0; i <= value; i++) {
+      if (!_emit(_window[(_head - _distance) & mask]))
+        return false;
+    }
+    _state = AC_EXPANDER_TAG;
+    break;
+  }
+  }
+  if (_expanded == _header.size)
+    _state = AC_EXPANDER_DONE;
+  return true;
+}
+
+/**
+ * Append a byte to the window. The window is written out as it wraps.
+ * @return false The image exceeds the size or writing failed.
+ */
+bool AutoConnectExpander::_emit(const uint8_t c) {
+  if (_expanded >= _header.size)
+    return false;
+  _crc ^= c;
+  for (uint8_t b = 0; b < 8; b++)
+    _crc = (_crc >> 1) ^ (0xedb88320 & -(_crc & 1));
+  _window[_head++] = c;
+  _expanded++;
+  if (_head == (1U << _header.window)) {
+    if (!_flush())
+      return false;
+    _head = _flushed = 0;
+  }
+  return true;
+}
+
+/**
+ * Hand the window contents not written yet to the writer.
+ */
+bool AutoConnectExpander::_flush(void) {
+  if (_head > _flushed) {
+    if (!_writer(_window + _flushed, _head - _flushed))
+      return false;
+    _flushed = _head;
+  }
+  return true;
+}
@@ -0,0 +1,92 @@
+/**
+ *  Declaration of AutoConnectExpander class.
+ *  @file   AutoConnectExpander.h
+ *  @copyright  MIT license.
+ */
+
+#ifndef _AUTOCONNECTEXPANDER_H_
+#define _AUTOCONNECTEXPANDER_H_
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+// The largest window accepted from a compressed image in bits. The
+// window is the only buffer allocated by the expander.
+#ifndef AUTOCONNECT_EXPANDER_WINDOW_MAX
+#define AUTOCONNECT_EXPANDER_WINDOW_MAX 12
+#endif // !AUTOCONNECT_EXPANDER_WINDOW_MAX
+
+/**
+ * Streaming decompressor of an image compressed by
+ * updateserver/python3/otacompress.py. It does not depend on the
+ * Arduino core so that it can be verified on the host.
+ * The image consists of a header and a heatshrink (LZSS) bit stream:
+ *   header  "ACZ1", window bits, lookahead bits, 2 reserved bytes,
+ *           size (uint32 LE), CRC32 (uint32 LE) and MD5 of the
+ *           decompressed image.
+ *   stream  MSB first, 1 and 8 bits for a literal byte, or 0, window
+ *           bits for the distance - 1 and lookahead bits for the
+ *           length - 1 of a back reference.
+ * The decompressed image is written from the window each time it
+ * wraps around, so that no buffer other than the window is needed.
+ */
+class AutoConnectExpander {
+ public:
+  typedef struct {
+    uint8_t   window;       /**< Window size in bits */
+    uint8_t   lookahead;    /**< Lookahead size in bits */
+    uint32_t  size;         /**< Size of the decompressed image */
+    uint32_t  crc;          /**< CRC32 of the decompressed image */
+    uint8_t   md5[16];      /**< MD5 of the decompressed image */
+  } AC_EXPANDERHEADER_t;
+
+  typedef enum {
+    AC_EXPANDER_HEADER,     /**< Receiving the header */
+    AC_EXPANDER_TAG,        /**< Receiving a tag bit */
+    AC_EXPANDER_LITERAL,    /**< Receiving a literal byte */
+    AC_EXPANDER_DISTANCE,   /**< Receiving a back reference distance */
+    AC_EXPANDER_LENGTH,     /**< Receiving a back reference length */
+    AC_EXPANDER_DONE,       /**< The image is completed */
+    AC_EXPANDER_ERROR       /**< Malformed stream or write failure */
+  } AC_EXPANDERSTATE_t;
+
+  // Writes the next part of the decompressed image
+  typedef std::function<bool(const uint8_t*, size_t)>  WriterFunction_ft;
+  // Accepts the header before the image is decompressed
+  typedef std::function<bool(const AC_EXPANDERHEADER_t&)> VerifierFunction_ft;
+
+  explicit AutoConnectExpander(WriterFunction_ft writer, VerifierFunction_ft verifier = nullptr);
+  ~AutoConnectExpander();
+  size_t  feed(const uint8_t* buf, const size_t size);
+  bool  end(void);
+  const AC_EXPANDERHEADER_t&  header(void) const { return _header; }  /**< Returns the image header */
+  AC_EXPANDERSTATE_t  state(void) const { return _state; }            /**< Returns the decompression state */
+  uint32_t  expanded(void) const { return _expanded; }                /**< Returns the decompressed size so far */
+
+  static bool isCompressed(const uint8_t* buf, const size_t size);
+
+ private:
+  bool  _parseHeader(void);
+  bool  _decode(const uint32_t value);
+  bool  _emit(const uint8_t c);
+  bool  _flush(void);
+  static uint32_t _le32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+  WriterFunction_ft   _writer;
+  VerifierFunction_ft _verifier;
+  AC_EXPANDERSTATE_t  _state;
+  AC_EXPANDERHEADER_t _header;
+  uint8_t   _hdr[32];       /**< The header being received */
+  uint8_t   _hdrLen;        /**< Received header bytes */
+  uint32_t  _acc;           /**< Bits received but not decoded */
+  uint8_t   _accBits;       /**< Number of the bits in _acc */
+  uint16_t  _distance;      /**< Distance of the back reference */
+  uint8_t*  _window;        /**< Decompressed bytes, the history of back references */
+  uint16_t  _head;          /**< Next position in the window */
+  uint16_t  _flushed;       /**< Window position written out */
+  uint32_t  _expanded;      /**< Decompressed size */
+  uint32_t  _crc;           /**< CRC32 of the decompressed bytes */
+};
+
+#endif // !_AUTOCONNECTEXPANDER_H_
@@ -43,6 +43,9 @@ class AutoConnectExt : public AutoConnectCore<T> {
   AutoConnectAux& locate(const String& uri) const { return *aux(uri); }
   bool  on(const String& uri, const AuxHandlerFunctionT handler, AutoConnectExitOrder_t order = AC_EXIT_AHEAD);
 
+  /** For AutoConnectAux precompiled from JSON */
+  bool  load(const AutoConnectAux::ACPage_t& aux);
+
   /** For AutoConnectAux described in JSON */
 #ifdef AUTOCONNECT_USE_JSON
   bool  load(PGM_P aux);
@@ -346,6 +346,25 @@ void AutoConnectExt<T>::_saveCurrentUri(const String& uri) {
     _prevUri = uri;
 }
 
+/**
+ * Load AutoConnectAux page from the table precompiled by auxtable.py.
+ * It places the page without ArduinoJson, and the table can stay in
+ * PROGMEM.
+ * @param  aux  The precompiled page.
+ * @return true Successfully loaded.
+ */
+template<typename T>
+bool AutoConnectExt<T>::load(const AutoConnectAux::ACPage_t& aux) {
+  AutoConnectAux* newAux = new AutoConnectAux;
+  if (!newAux->load(aux)) {
+    delete newAux;
+    return false;
+  }
+  newAux->_deletable = true;
+  join(*newAux);
+  return true;
+}
+
 #ifdef AUTOCONNECT_USE_JSON
 // A set of functions for processing JSON descriptions in AutoConnectAux.
 // It is instantiated according to the sketch implementation.
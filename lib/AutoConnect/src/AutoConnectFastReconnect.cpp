@@ -0,0 +1,111 @@
+/**
+ *  AutoConnectFastReconnect class implementation.
+ *  Keeps the access point of the last established connection in the
+ *  RTC memory for the direct connection at the next boot.
+ *  @file   AutoConnectFastReconnect.cpp
+ *  @copyright  MIT license.
+ */
+
+#include "AutoConnectFastReconnect.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+// The RTC slow memory is not initialized by a software reset.
+static RTC_NOINIT_ATTR AutoConnectFastReconnect::AC_FASTRECONNECT_t _rtcCache;
+#endif
+
+/**
+ * Load the cached access point from the RTC memory.
+ * @param cache A pointer to the record to be loaded.
+ * @return true   The cache is valid.
+ * @return false  Nothing is cached, or the RTC memory was lost by power-on.
+ */
+bool AutoConnectFastReconnect::load(AC_FASTRECONNECT_t* cache) {
+#if defined(ARDUINO_ARCH_ESP8266)
+  if (!ESP.rtcUserMemoryRead(AUTOCONNECT_FASTRECONNECT_RTCOFFSET, reinterpret_cast<uint32_t*>(cache), sizeof(AC_FASTRECONNECT_t)))
+    return false;
+#elif defined(ARDUINO_ARCH_ESP32)
+  memcpy(cache, &_rtcCache, sizeof(AC_FASTRECONNECT_t));
+#endif
+  cache->ssid[sizeof(AC_FASTRECONNECT_t::ssid) - 1] = '\0';
+  return cache->crc == _crc(*cache) && cache->channel && strlen(cache->ssid);
+}
+
+/**
+ * Cache the access point of the current connection.
+ * @param lease The current IP configuration was leased by DHCP.
+ */
+void AutoConnectFastReconnect::save(const bool lease) {
+  AC_FASTRECONNECT_t  cache;
+
+  memset(&cache, 0, sizeof(AC_FASTRECONNECT_t));
+  const uint8_t*  bssid = WiFi.BSSID();
+  if (bssid)
+    memcpy(cache.bssid, bssid, sizeof(AC_FASTRECONNECT_t::bssid));
+  cache.channel = static_cast<uint8_t>(WiFi.channel());
+  cache.lease = lease;
+  cache.ip = static_cast<uint32_t>(WiFi.localIP());
+  cache.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+  cache.netmask = static_cast<uint32_t>(WiFi.subnetMask());
+  cache.dns1 = static_cast<uint32_t>(WiFi.dnsIP(0));
+  cache.dns2 = static_cast<uint32_t>(WiFi.dnsIP(1));
+  strncpy(cache.ssid, WiFi.SSID().c_str(), sizeof(AC_FASTRECONNECT_t::ssid) - 1);
+  _store(&cache);
+  AC_DBG("Cached %s ch(%d) for fast reconnect\n", cache.ssid, (int)cache.channel);
+}
+
+/**
+ * Count a connection that applied the cached lease statically. The
+ * lease is left as it was negotiated, so it is not renewed by reusing it.
+ */
+void AutoConnectFastReconnect::reuseLease(void) {
+  AC_FASTRECONNECT_t  cache;
+
+  if (load(&cache) && cache.lease) {
+    cache.leaseReuse++;
+    _store(&cache);
+    AC_DBG("Lease of %s reused %d time(s)\n", cache.ssid, (int)cache.leaseReuse);
+  }
+}
+
+/**
+ * Invalidate the cache, the next connection will scan.
+ */
+void AutoConnectFastReconnect::clear(void) {
+  uint32_t  crc = 0;
+#if defined(ARDUINO_ARCH_ESP8266)
+  ESP.rtcUserMemoryWrite(AUTOCONNECT_FASTRECONNECT_RTCOFFSET, &crc, sizeof(crc));
+#elif defined(ARDUINO_ARCH_ESP32)
+  _rtcCache.crc = crc;
+#endif
+}
+
+/**
+ * Seal the record with its CRC and write it to the RTC memory.
+ * @param cache The record.
+ */
+void AutoConnectFastReconnect::_store(AC_FASTRECONNECT_t* cache) {
+  cache->crc = _crc(*cache);
+#if defined(ARDUINO_ARCH_ESP8266)
+  ESP.rtcUserMemoryWrite(AUTOCONNECT_FASTRECONNECT_RTCOFFSET, reinterpret_cast<uint32_t*>(cache), sizeof(AC_FASTRECONNECT_t));
+#elif defined(ARDUINO_ARCH_ESP32)
+  memcpy(&_rtcCache, cache, sizeof(AC_FASTRECONNECT_t));
+#endif
+}
+
+/**
+ * CRC32 of the record excluding the crc field.
+ * @param cache The record.
+ * @return CRC32
+ */
+uint32_t AutoConnectFastReconnect::_crc(const AC_FASTRECONNECT_t& cache) {
+  const uint8_t*  p = reinterpret_cast<const uint8_t*>(&cache) + sizeof(AC_FASTRECONNECT_t::crc);
+  size_t  len = sizeof(AC_FASTRECONNECT_t) - sizeof(AC_FASTRECONNECT_t::crc);
+  uint32_t  crc = 0xffffffff;
+
+  while (len--) {
+    crc ^= *p++;
+    for (uint8_t b = 0; b < 8; b++)
+      crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
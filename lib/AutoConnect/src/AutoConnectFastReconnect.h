@@ -0,0 +1,53 @@
+/**
+ *  Declaration of AutoConnectFastReconnect class.
+ *  @file   AutoConnectFastReconnect.h
+ *  @copyright  MIT license.
+ */
+
+#ifndef _AUTOCONNECTFASTRECONNECT_H_
+#define _AUTOCONNECTFASTRECONNECT_H_
+
+#if defined(ARDUINO_ARCH_ESP8266)
+#include <ESP8266WiFi.h>
+#elif defined(ARDUINO_ARCH_ESP32)
+#include <WiFi.h>
+#endif
+#include "AutoConnectDefs.h"
+
+/**
+ * The access point of the last established connection kept in the RTC
+ * memory, which survives a reset, a watchdog or a deep sleep but not a
+ * power-on. It allows the next boot to connect with the BSSID and the
+ * channel without scanning, and to skip DHCP with the previous lease.
+ * A lease is applied statically for at most
+ * AUTOCONNECT_FASTRECONNECT_LEASEREUSE connections, after which DHCP
+ * runs again and renews it.
+ */
+class AutoConnectFastReconnect {
+ public:
+  typedef struct {
+    uint32_t  crc;          /**< CRC32 of the following fields */
+    uint8_t   bssid[6];     /**< BSSID of the access point */
+    uint8_t   channel;      /**< Channel of the access point */
+    uint8_t   lease;        /**< The IP configuration was leased by DHCP */
+    uint8_t   leaseReuse;   /**< Connections that applied the lease without DHCP */
+    uint8_t   reserved[3];  /**< Alignment of the following addresses */
+    uint32_t  ip;           /**< Station IP */
+    uint32_t  gateway;      /**< Gateway */
+    uint32_t  netmask;      /**< Netmask */
+    uint32_t  dns1;         /**< Primary DNS */
+    uint32_t  dns2;         /**< Secondary DNS */
+    char      ssid[36];     /**< SSID, null terminated and padded to 4 bytes */
+  } AC_FASTRECONNECT_t;
+
+  static bool load(AC_FASTRECONNECT_t* cache);
+  static void save(const bool lease);
+  static void reuseLease(void);
+  static void clear(void);
+
+ private:
+  static void _store(AC_FASTRECONNECT_t* cache);
+  static uint32_t _crc(const AC_FASTRECONNECT_t& cache);
+};
+
+#endif // !_AUTOCONNECTFASTRECONNECT_H_
@@ -29,6 +29,20 @@
 #include "AutoConnectOTA.h"
 #include "AutoConnectOTAPage.h"
 
+namespace {
+/**
+ * Format a MD5 digest as the hex string that the Update class takes.
+ * @param  md5  MD5 digest.
+ * @param  hex  A buffer of 33 bytes.
+ * @return The hex string.
+ */
+const char* _md5Hex(const uint8_t* md5, char* hex) {
+  for (size_t i = 0; i < 16; i++)
+    sprintf(hex + i * 2, "%02x", md5[i]);
+  return hex;
+}
+}
+
 /**
  * A destructor. Release the OTA operation pages.
  */
@@ -198,6 +212,9 @@ bool AutoConnectOTA::_open(const char* filename, const char* mode) {
 #endif
 
   _err.clear();
+  _delta.reset(nullptr);
+  _expander.reset(nullptr);
+  _stored = 0;
   AC_DBG("OTA:%s %s\n", _dest == OTA_DEST_FIRM ? "app" : "fs", _binName.c_str());
   if (_dest == OTA_DEST_FIRM) {
     uint32_t  maxSketchSpace = (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000;
@@ -258,20 +275,115 @@ size_t AutoConnectOTA::_write(const uint8_t *buf, const size_t size) {
     digitalWrite(_tickerPort, digitalRead(_tickerPort) ^ 0x01);
   if (!_err.length()) {
     _otaStatus = AC_OTA_PROGRESS;
-    if (_dest == OTA_DEST_FIRM) {
-      wsz = Update.write(const_cast<uint8_t*>(buf), size);
-      if (wsz != size)
-        _setError();
+    // A compressed image is decompressed before it is stored.
+    if (!_ulAmount && AutoConnectExpander::isCompressed(buf, size))
+      _beginExpand();
+    if (_expander) {
+      wsz = _expander->feed(buf, size);
+      if (wsz != size && !_err.length())
+        _setError("Invalid compressed image");
+    }
+    else
+      wsz = _store(buf, size);
+  }
+  return wsz;
+}
+
+/**
+ * Stores the uploaded data, or the decompressed data of a compressed
+ * image, to the destination.
+ * @param  buf  Buffer address of the data.
+ * @param  size Size to be written.
+ * @return      the amount written
+ */
+size_t AutoConnectOTA::_store(const uint8_t* buf, const size_t size) {
+  size_t  wsz;
+
+  if (_dest == OTA_DEST_FIRM) {
+    // A patch uploaded instead of the whole binary reconstructs the
+    // new firmware from the running one through the Update class.
+    if (!_stored && AutoConnectDelta::isPatch(buf, size))
+      _beginDelta();
+    if (_delta) {
+      wsz = _delta->feed(buf, size);
+      if (wsz != size && !_err.length()) {
+        if (Update.hasError())
+          _setError();
+        else
+          _setError("Invalid patch");
+      }
     }
     else {
-      wsz = _file.write(buf, size);
+      wsz = Update.write(const_cast<uint8_t*>(buf), size);
       if (wsz != size)
-        _setError("Incomplete writing");
+        _setError();
     }
   }
+  else {
+    if (_expander)
+      _md5.add(buf, size);
+    wsz = _file.write(buf, size);
+    if (wsz != size)
+      _setError("Incomplete writing");
+  }
+  _stored += wsz;
   return wsz;
 }
 
+/**
+ * Start decompressing the uploaded image. The MD5 of the decompressed
+ * image is verified by the Update class for the firmware, and by _close
+ * for a file.
+ */
+void AutoConnectOTA::_beginExpand(void) {
+  AC_DBG("OTA:compressed\n");
+  _expander.reset(new AutoConnectExpander(
+    [this](const uint8_t* data, size_t size) {
+      return _store(data, size) == size;
+    },
+    [this](const AutoConnectExpander::AC_EXPANDERHEADER_t& header) {
+      AC_DBG("OTA:expand %u bytes, window %u\n", header.size, 1U << header.window);
+      if (_dest == OTA_DEST_FILE) {
+        _md5.begin();
+        return true;
+      }
+      char  md5[sizeof(header.md5) * 2 + 1];
+      return Update.setMD5(_md5Hex(header.md5, md5));
+    }));
+}
+
+/**
+ * Start applying the uploaded patch. The running sketch is read as the
+ * source image and the reconstructed image goes to the Update class
+ * which was begun by _open.
+ */
+void AutoConnectOTA::_beginDelta(void) {
+  AC_DBG("OTA:delta\n");
+  _delta.reset(new AutoConnectDelta(
+    [](uint32_t offset, uint8_t* data, size_t size) {
+#if defined(ARDUINO_ARCH_ESP8266)
+      // The sketch is placed from the top of the flash.
+      return ESP.flashRead(offset, data, size);
+#elif defined(ARDUINO_ARCH_ESP32)
+      return esp_partition_read(esp_ota_get_running_partition(), offset, data, size) == ESP_OK;
+#endif
+    },
+    [](const uint8_t* data, size_t size) {
+      return Update.write(const_cast<uint8_t*>(data), size) == size;
+    },
+    [this](const AutoConnectDelta::AC_DELTAHEADER_t& header) {
+      char  md5[sizeof(header.srcMD5) * 2 + 1];
+
+      // The patch must be made against the running sketch.
+      if (header.srcSize != ESP.getSketchSize() || !ESP.getSketchMD5().equalsIgnoreCase(_md5Hex(header.srcMD5, md5))) {
+        _setError("Patch is not for the running firmware");
+        return false;
+      }
+      AC_DBG("OTA:patch %u to %u bytes\n", header.srcSize, header.dstSize);
+      return Update.setMD5(_md5Hex(header.dstMD5, md5));
+    }));
+}
+
 /**
  * All bytes are written, this call writes the config to reboot.
  * If there is an error this will clear everything.
@@ -286,9 +398,36 @@ void AutoConnectOTA::_close(const HTTPUploadStatus status) {
   // Updater class, and native file uploading closes the file.
   bool  bc = status == UPLOAD_FILE_END;
 
+  // A compressed image is stored only if it is complete and the CRC32
+  // of the decompressed data matches. Its rest is flushed to the
+  // destination here.
+  if (_expander) {
+    if (bc && !_err.length()) {
+      if (!_expander->end())
+        _setError("Corrupted compressed image");
+      else if (_dest == OTA_DEST_FILE) {
+        char  md5[sizeof(AutoConnectExpander::AC_EXPANDERHEADER_t::md5) * 2 + 1];
+        _md5.calculate();
+        if (!_md5.toString().equalsIgnoreCase(_md5Hex(_expander->header().md5, md5)))
+          _setError("MD5 mismatch");
+      }
+    }
+    bc = bc && !_err.length();
+    _expander.reset(nullptr);
+  }
+
   if (_dest == OTA_DEST_FIRM) {
+    // The image reconstructed by a patch is committed only if it is
+    // complete. Its MD5 is verified by the Update class.
+    if (_delta) {
+      if (bc && !_delta->end() && !_err.length())
+        _setError("Incomplete patch");
+      bc = bc && !_err.length();
+      _delta.reset(nullptr);
+    }
     if (!Update.end(bc)) {
-      _setError();
+      if (!_err.length())
+        _setError();
       AC_DBG("Failed to flash");
     }
   }
@@ -19,7 +19,10 @@
 
 #include <functional>
 #include <memory>
+#include <MD5Builder.h>
 #include "AutoConnectAux.h"
+#include "AutoConnectDelta.h"
+#include "AutoConnectExpander.h"
 #include "AutoConnectUpload.h"
 #include "AutoConnectFS.h"
 
@@ -41,7 +44,7 @@ public:
     OTA_DEST_FIRM  /**< To update the firmware */
   } AC_OTADest_t;
 
-  AutoConnectOTA() : extraCaption(nullptr), _dest(OTA_DEST_FIRM), _otaStatus(AC_OTA_IDLE), _tickerPort(-1), _tickerOn(LOW), _fs(nullptr) {};
+  AutoConnectOTA() : extraCaption(nullptr), _dest(OTA_DEST_FIRM), _otaStatus(AC_OTA_IDLE), _tickerPort(-1), _tickerOn(LOW), _stored(0), _fs(nullptr) {};
   ~AutoConnectOTA();
   void  attach(AutoConnectExt<AutoConnectConfigExt>& portal); /**< Attach itself to AutoConnect */
   void  authentication(const AC_AUTH_t auth);               /**< Set certain page authentication */
@@ -66,6 +69,9 @@ protected:
   std::unique_ptr<AutoConnectAux> _auxResult;   /**< An update result page */
 
  private:
+  void  _beginDelta(void);
+  void  _beginExpand(void);
+  size_t  _store(const uint8_t* buf, const size_t size);
   void  _setError(void);
 
   AC_OTADest_t _dest;           /**< Destination of OTA transferred data */
@@ -73,6 +79,10 @@ protected:
   int8_t  _tickerPort;          /**< GPIO for flicker */
   uint8_t _tickerOn;            /**< A signal for flicker turn on */
   String  _binName;             /**< An updater file name */
+  std::unique_ptr<AutoConnectDelta> _delta; /**< Applier of an uploaded patch */
+  std::unique_ptr<AutoConnectExpander> _expander; /**< Decompressor of an uploaded compressed image */
+  MD5Builder  _md5;             /**< MD5 of a decompressed file */
+  size_t  _stored;              /**< Amount stored after decompression */
 
   AutoConnectFS::FS*  _fs;      /**< Filesystem for the native file uploading */
   fs::File  _file;              /**< File handler for the native file uploading */
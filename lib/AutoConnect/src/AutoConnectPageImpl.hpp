@@ -1020,90 +1020,12 @@ String AutoConnectCore<T>::_getSystemUptime() {
   return uptime;
 }
 
-template <typename T>
-String AutoConnectCore<T>::_token_CSS_BASE(PageArgument &args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_BASE));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_ICON_LOCK(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_ICON_LOCK));
-}
-
 template<typename T>
 String AutoConnectCore<T>::_token_CSS_ICON_TRASH(PageArgument& args) {
   AC_UNUSED(args);
   return (_apConfig.menuItems & AC_MENUITEM_DELETESSID) ? String(FPSTR(_CSS_ICON_TRASH)) : String("");
 }
 
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_INPUT_BUTTON(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_INPUT_BUTTON));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_INPUT_TEXT(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_INPUT_TEXT));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_LUXBAR_BODY(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_LUXBAR_BODY));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_LUXBAR_HEADER));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_LUXBAR_BGR(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_LUXBAR_BGR));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_LUXBAR_ANI(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_LUXBAR_ANI));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_LUXBAR_MEDIA));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_LUXBAR_ITEM));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_SPINNER(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_SPINNER));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_TABLE(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_TABLE));
-}
-
-template<typename T>
-String AutoConnectCore<T>::_token_CSS_UL(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_CSS_UL));
-}
-
 template<typename T>
 String AutoConnectCore<T>::_token_MENU_AUX(PageArgument& args) {
   return _mold_MENU_AUX(args);
@@ -1254,12 +1176,6 @@ String AutoConnectCore<T>::_token_GATEWAY(PageArgument &args) {
   return WiFi.gatewayIP().toString();
 }
 
-template<typename T>
-String AutoConnectCore<T>::_token_HEAD(PageArgument& args) {
-  AC_UNUSED(args);
-  return String(FPSTR(_ELM_HTML_HEAD));
-}
-
 template<typename T>
 String AutoConnectCore<T>::_token_HIDDEN_COUNT(PageArgument& args) {
   AC_UNUSED(args);
@@ -1619,15 +1535,15 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     reqAuth = true;
     _freeHeapSize = ESP.getFreeHeap();
     elm->setMold(FPSTR(_PAGE_STAT));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_TABLE"), std::bind(&AutoConnectCore<T>::_token_CSS_TABLE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_TABLE"), FPSTR(_CSS_TABLE));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_AUX"), std::bind(&AutoConnectCore<T>::_token_MENU_AUX, this, std::placeholders::_1));
@@ -1654,18 +1570,18 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     // Setup /_ac/config
     reqAuth = true;
     elm->setMold(FPSTR(_PAGE_CONFIGNEW));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_UL"), std::bind(&AutoConnectCore<T>::_token_CSS_UL, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_ICON_LOCK"), std::bind(&AutoConnectCore<T>::_token_CSS_ICON_LOCK, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_INPUT_BUTTON"), std::bind(&AutoConnectCore<T>::_token_CSS_INPUT_BUTTON, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_INPUT_TEXT"), std::bind(&AutoConnectCore<T>::_token_CSS_INPUT_TEXT, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_UL"), FPSTR(_CSS_UL));
+    elm->addToken(FPSTR("CSS_ICON_LOCK"), FPSTR(_CSS_ICON_LOCK));
+    elm->addToken(FPSTR("CSS_INPUT_BUTTON"), FPSTR(_CSS_INPUT_BUTTON));
+    elm->addToken(FPSTR("CSS_INPUT_TEXT"), FPSTR(_CSS_INPUT_TEXT));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_AUX"), std::bind(&AutoConnectCore<T>::_token_MENU_AUX, this, std::placeholders::_1));
@@ -1682,15 +1598,15 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     _menuTitle = FPSTR(AUTOCONNECT_MENUTEXT_CONNECTING);
     elm->setMold(FPSTR(_PAGE_CONNECTING));
     elm->addToken(FPSTR("REQ"), std::bind(&AutoConnectCore<T>::_induceConnect, this, std::placeholders::_1));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_SPINNER"), std::bind(&AutoConnectCore<T>::_token_CSS_SPINNER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_SPINNER"), FPSTR(_CSS_SPINNER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_POST"), std::bind(&AutoConnectCore<T>::_token_MENU_POST, this, std::placeholders::_1));
@@ -1701,17 +1617,17 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     // Setup /_ac/open
     reqAuth = true;
     elm->setMold(FPSTR(_PAGE_OPENCREDT));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_ICON_LOCK"), std::bind(&AutoConnectCore<T>::_token_CSS_ICON_LOCK, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_ICON_LOCK"), FPSTR(_CSS_ICON_LOCK));
     elm->addToken(FPSTR("CSS_ICON_TRASH"), std::bind(&AutoConnectCore<T>::_token_CSS_ICON_TRASH, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_INPUT_BUTTON"), std::bind(&AutoConnectCore<T>::_token_CSS_INPUT_BUTTON, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("CSS_INPUT_BUTTON"), FPSTR(_CSS_INPUT_BUTTON));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_AUX"), std::bind(&AutoConnectCore<T>::_token_MENU_AUX, this, std::placeholders::_1));
@@ -1731,14 +1647,14 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     _menuTitle = FPSTR(AUTOCONNECT_MENUTEXT_DISCONNECT);
     elm->setMold(FPSTR(_PAGE_DISCONN));
     elm->addToken(FPSTR("DISCONNECT"), std::bind(&AutoConnectCore<T>::_induceDisconnect, this, std::placeholders::_1));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_POST"), std::bind(&AutoConnectCore<T>::_token_MENU_POST, this, std::placeholders::_1));
@@ -1748,7 +1664,7 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     // Setup /_ac/reset
     reqAuth = true;
     elm->setMold(FPSTR(_PAGE_RESETTING));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
     elm->addToken(FPSTR("BOOTURI"), std::bind(&AutoConnectCore<T>::_token_BOOTURI, this, std::placeholders::_1));
     elm->addToken(FPSTR("UPTIME"), std::bind(&AutoConnectCore<T>::_token_UPTIME, this, std::placeholders::_1));
     elm->addToken(FPSTR("RESET"), std::bind(&AutoConnectCore<T>::_induceReset, this, std::placeholders::_1));
@@ -1756,22 +1672,38 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
   else if (uri == String(AUTOCONNECT_URI_RESULT)) {
 
     // Setup /_ac/result
-    elm->setMold(FPSTR("{{RESULT}}"));
-    elm->addToken(FPSTR("RESULT"), std::bind(&AutoConnectCore<T>::_invokeResult, this, std::placeholders::_1));
+    // It keeps the connecting page with polling until the attempt
+    // settles, then the REQ token redirects to the outcome.
+    _menuTitle = FPSTR(AUTOCONNECT_MENUTEXT_CONNECTING);
+    elm->setMold(FPSTR(_PAGE_CONNECTING));
+    elm->addToken(FPSTR("REQ"), std::bind(&AutoConnectCore<T>::_invokeResult, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_SPINNER"), FPSTR(_CSS_SPINNER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
+    elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
+    elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
+    elm->addToken(FPSTR("MENU_POST"), std::bind(&AutoConnectCore<T>::_token_MENU_POST, this, std::placeholders::_1));
+    elm->addToken(FPSTR("CUR_SSID"), std::bind(&AutoConnectCore<T>::_token_CURRENT_SSID, this, std::placeholders::_1));
   }
   else if (uri == String(AUTOCONNECT_URI_SUCCESS)) {
 
     // Setup /_ac/success
     elm->setMold(FPSTR(_PAGE_SUCCESS));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_TABLE"), std::bind(&AutoConnectCore<T>::_token_CSS_TABLE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_TABLE"), FPSTR(_CSS_TABLE));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_AUX"), std::bind(&AutoConnectCore<T>::_token_MENU_AUX, this, std::placeholders::_1));
@@ -1790,15 +1722,15 @@ PageElement* AutoConnectCore<T>::_setupPage(String& uri) {
     // Setup /_ac/fail
     _menuTitle = FPSTR(AUTOCONNECT_MENUTEXT_FAILED);
     elm->setMold(FPSTR(_PAGE_FAIL));
-    elm->addToken(FPSTR("HEAD"), std::bind(&AutoConnectCore<T>::_token_HEAD, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_BASE"), std::bind(&AutoConnectCore<T>::_token_CSS_BASE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_TABLE"), std::bind(&AutoConnectCore<T>::_token_CSS_TABLE, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BODY, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_HEADER, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_BGR, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ANI, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_MEDIA, this, std::placeholders::_1));
-    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), std::bind(&AutoConnectCore<T>::_token_CSS_LUXBAR_ITEM, this, std::placeholders::_1));
+    elm->addToken(FPSTR("HEAD"), FPSTR(_ELM_HTML_HEAD));
+    elm->addToken(FPSTR("CSS_BASE"), FPSTR(_CSS_BASE));
+    elm->addToken(FPSTR("CSS_TABLE"), FPSTR(_CSS_TABLE));
+    elm->addToken(FPSTR("CSS_LUXBAR_BODY"), FPSTR(_CSS_LUXBAR_BODY));
+    elm->addToken(FPSTR("CSS_LUXBAR_HEADER"), FPSTR(_CSS_LUXBAR_HEADER));
+    elm->addToken(FPSTR("CSS_LUXBAR_BGR"), FPSTR(_CSS_LUXBAR_BGR));
+    elm->addToken(FPSTR("CSS_LUXBAR_ANI"), FPSTR(_CSS_LUXBAR_ANI));
+    elm->addToken(FPSTR("CSS_LUXBAR_MEDIA"), FPSTR(_CSS_LUXBAR_MEDIA));
+    elm->addToken(FPSTR("CSS_LUXBAR_ITEM"), FPSTR(_CSS_LUXBAR_ITEM));
     elm->addToken(FPSTR("MENU_PRE"), std::bind(&AutoConnectCore<T>::_token_MENU_PRE, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_LIST"), std::bind(&AutoConnectCore<T>::_token_MENU_LIST, this, std::placeholders::_1));
     elm->addToken(FPSTR("MENU_AUX"), std::bind(&AutoConnectCore<T>::_token_MENU_AUX, this, std::placeholders::_1));
@@ -359,6 +359,10 @@ void AutoConnectUpdateAct::_inProgress(size_t amount, size_t size) {
  * AUTOCONNECT_URI_UPDATE page handler.
  * It queries the update server for cataloged sketch binary and
  * displays the result on the page as an available updater list.
+ * The catalog is parsed directly from the response stream one entry at
+ * a time, so its size is not limited by the JSON buffer. The list is
+ * divided into pages of AUTOCONNECT_UPDATE_CATALOG_PAGESIZE firmwares
+ * selected by the page query parameter.
  * The update execution button held by this page will be enabled only
  * when there are any available updaters.
  * @param  catalog A reference of the AutoConnectAux as AUTOCONNECT_URI_UPDATE
@@ -366,7 +370,6 @@ void AutoConnectUpdateAct::_inProgress(size_t amount, size_t size) {
  * @return         Additional string to the page but it always null.
  */
 String AutoConnectUpdateAct::_onCatalog(AutoConnectAux& catalog, PageArgument& args) {
-  AC_UNUSED(args);
   WiFiClient  wifiClient;
   HTTPClient  httpClient;
 
@@ -374,11 +377,20 @@ String AutoConnectUpdateAct::_onCatalog(AutoConnectAux& catalog, PageArgument& a
   _binName = String("");
   AutoConnectText&  caption = catalog.getElement<AutoConnectText>(F("caption"));
   AutoConnectRadio& firmwares = catalog.getElement<AutoConnectRadio>(F("firmwares"));
+  AutoConnectElement& pager = catalog.getElement<AutoConnectElement>(F("pager"));
   AutoConnectSubmit&  submit = catalog.getElement<AutoConnectSubmit>(F("update"));
   firmwares.empty();
   firmwares.tags.clear();
+  pager.value = String("");
   submit.enable = false;
 
+  // The range of the firmwares to be listed on this page.
+  long  page = args.arg(F("page")).toInt();
+  if (page < 0)
+    page = 0;
+  const size_t  firstEntry = (size_t)page * AUTOCONNECT_UPDATE_CATALOG_PAGESIZE;
+  size_t  binEntries = 0;
+
   String  qs = String(F(AUTOCONNECT_UPDATE_CATALOG)) + '?' + String(F("op=list&path=")) + uri;
   AC_DBG("Query %s:%d%s\n", host.c_str(), port, qs.c_str());
 
@@ -395,22 +407,33 @@ String AutoConnectUpdateAct::_onCatalog(AutoConnectAux& catalog, PageArgument& a
       char  endOfList[] = "]";
       WiFiClient& responseBody = httpClient.getStream();
 
+#if ARDUINOJSON_VERSION_MAJOR>=6
+      // Only the fields listed on the page are retained from each entry,
+      // the others are skipped while reading the stream.
+      StaticJsonDocument<JSON_OBJECT_SIZE(5)> filter;
+      filter["name"] = true;
+      filter["type"] = true;
+      filter["date"] = true;
+      filter["time"] = true;
+      filter["size"] = true;
+#endif
+
       // Read partially and repeatedly the responded http stream that is
       // including the JSON array to reduce the buffer size for parsing
       // of the firmware catalog list.
       AC_DBG("Update server responded:");
       responseBody.find(beginOfList);
       do {
-        // The size of the JSON buffer is a fixed. It can be a problem
-        // when parsing with ArduinoJson V6. If memory insufficient has
-        // occurred during the parsing, increase this buffer size.
+        // The buffer holds only the filtered fields of an entry. If memory
+        // insufficient has occurred during the parsing, increase this
+        // buffer size.
         ArduinoJsonStaticBuffer<AUTOCONNECT_UPDATE_CATALOG_JSONBUFFER_SIZE> jb;
 
 #if ARDUINOJSON_VERSION_MAJOR<=5
         ArduinoJsonObject json = jb.parseObject(responseBody);
         parse = json.success();
 #else
-        DeserializationError err = deserializeJson(jb, responseBody);
+        DeserializationError err = deserializeJson(jb, responseBody, DeserializationOption::Filter(filter));
         ArduinoJsonObject json = jb.as<JsonObject>();
         parse = (err == DeserializationError::Ok);
 #endif
@@ -421,11 +444,17 @@ String AutoConnectUpdateAct::_onCatalog(AutoConnectAux& catalog, PageArgument& a
 #endif
           // Register only bin type file name as available sketch binary to
           // AutoConnectRadio value based on the response from the update server.
-          firmwares.order = AC_Horizontal;
           if (json["type"].as<String>().equalsIgnoreCase("bin")) {
-            firmwares.add(json[F("name")].as<String>());
-            String  attr = String(F("<span>")) + json[F("date")].as<String>() + String(F("</span><span>")) + json[F("time")].as<String>().substring(0, 5) + String(F("</span><span>")) + String(json[F("size")].as<int>()) + String(F("</span>"));
-            firmwares.tags.push_back(attr);
+            // An entry beyond this page tells that the next page exists,
+            // the rest of the catalog is left unread.
+            if (binEntries++ >= firstEntry + AUTOCONNECT_UPDATE_CATALOG_PAGESIZE)
+              break;
+            if (binEntries > firstEntry) {
+              firmwares.order = AC_Horizontal;
+              firmwares.add(json[F("name")].as<String>());
+              String  attr = String(F("<span>")) + json[F("date")].as<String>() + String(F("</span><span>")) + json[F("time")].as<String>().substring(0, 5) + String(F("</span><span>")) + String(json[F("size")].as<int>()) + String(F("</span>"));
+              firmwares.tags.push_back(attr);
+            }
           }
         }
         else {
@@ -440,6 +469,15 @@ String AutoConnectUpdateAct::_onCatalog(AutoConnectAux& catalog, PageArgument& a
         }
       } while (responseBody.findUntil(endOfEntry, endOfList));
 
+      // Links to the neighbor pages.
+      if (page > 0)
+        pager.value = String(F("<a href=\"" AUTOCONNECT_URI_UPDATE "?page=")) + String(page - 1) + String(F("\">&laquo;</a>"));
+      if (binEntries > firstEntry + AUTOCONNECT_UPDATE_CATALOG_PAGESIZE) {
+        if (pager.value.length())
+          pager.value += String(F("&ensp;"));
+        pager.value += String(F("<a href=\"" AUTOCONNECT_URI_UPDATE "?page=")) + String(page + 1) + String(F("\">&raquo;</a>"));
+      }
+
       AC_DBG_DUMB("\n");
       if (parse) {
         if (firmwares.size()) {
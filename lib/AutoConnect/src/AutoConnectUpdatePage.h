@@ -28,6 +28,7 @@ const AutoConnectAux::ACElementProp_t AutoConnectUpdateAct::_elmCatalog[] PROGME
   { AC_Element, "c1", "<div class=\"bins\">", nullptr },
   { AC_Radio, "firmwares", nullptr, nullptr },
   { AC_Element, "c2", "</div>", nullptr },
+  { AC_Element, "pager", nullptr, nullptr },
   { AC_Submit, "update", AUTOCONNECT_BUTTONLABEL_UPDATE, AUTOCONNECT_URI_UPDATE_ACT }
 };
 const AutoConnectAux::ACPage_t AutoConnectUpdateAct::_pageCatalog PROGMEM = {
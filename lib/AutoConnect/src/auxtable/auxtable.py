@@ -0,0 +1,133 @@
+#!python3.*
+
+"""Precompile AutoConnectAux JSON into tables for AutoConnect::load.
+
+The generated header declares an AutoConnectAux::ACPage_t for each page
+in the JSON document. Loading it with AutoConnect::load places the page
+without parsing JSON at run time. The tables and their strings are all
+declared PROGMEM.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# The element type and the attribute held in the peculiar of the table.
+ELEMENTS = {
+    'ACButton': ('AC_Button', 'action'),
+    'ACCheckbox': ('AC_Checkbox', 'label'),
+    'ACElement': ('AC_Element', None),
+    'ACFile': ('AC_File', 'label'),
+    'ACInput': ('AC_Input', 'label'),
+    'ACRange': ('AC_Range', 'min,max,step'),
+    'ACStyle': ('AC_Style', None),
+    'ACSubmit': ('AC_Submit', 'uri'),
+    'ACText': ('AC_Text', 'style')
+}
+
+AUTH = {
+    'none': 'AC_AUTH_NONE',
+    'basic': 'AC_AUTH_BASIC',
+    'digest': 'AC_AUTH_DIGEST'
+}
+
+
+def cstr(s):
+    """Quote a string as a C literal."""
+    out = ''
+    for c in s.encode('utf-8'):
+        if c in (0x22, 0x5c):
+            out += '\\' + chr(c)
+        elif 0x20 <= c < 0x7f:
+            out += chr(c)
+        else:
+            out += '\\{0:03o}'.format(c)
+    return '"' + out + '"'
+
+
+class Strings:
+    """The strings of a page, each declared as a PROGMEM array."""
+
+    def __init__(self, name):
+        self.name = name
+        self.decls = []
+
+    def ref(self, s, suffix):
+        if s is None:
+            return 'nullptr'
+        symbol = '{0}_{1}'.format(self.name, suffix)
+        self.decls.append('static const char {0}[] PROGMEM = {1};\n'.format(symbol, cstr(str(s))))
+        return symbol
+
+
+def symbol(uri):
+    return 'AUX' + re.sub(r'[^0-9A-Z]+', '_', uri.upper()).rstrip('_')
+
+
+def range_peculiar(aux, elm):
+    """The range of ACRange held as "min,max,step"."""
+    for key in ('min', 'max', 'step'):
+        if key in elm and not isinstance(elm[key], int):
+            sys.exit('{0}: "{1}" of "{2}" must be an integer'.format(aux.get('uri'), key, elm.get('name')))
+    return '{0},{1},{2}'.format(elm.get('min', 0), elm.get('max', 0), elm.get('step', 1))
+
+
+def page(aux, name):
+    for key in aux:
+        if key not in ('uri', 'title', 'menu', 'auth', 'element'):
+            sys.exit('{0}: "{1}" cannot be precompiled'.format(aux.get('uri'), key))
+    auth = str(aux.get('auth', 'none')).lower()
+    if auth not in AUTH:
+        sys.exit('{0}: unknown auth "{1}"'.format(aux.get('uri'), auth))
+    elements = aux.get('element', [])
+    if isinstance(elements, dict):
+        elements = [elements]
+    strings = Strings(name)
+    rows = []
+    for n, elm in enumerate(elements):
+        if elm.get('type') not in ELEMENTS:
+            sys.exit('{0}: {1} of "{2}" cannot be precompiled'.format(aux.get('uri'), elm.get('type'), elm.get('name')))
+        ac_type, peculiar = ELEMENTS[elm['type']]
+        held = peculiar.split(',') if peculiar else []
+        for key in elm:
+            if key not in ['name', 'type', 'value'] + held:
+                sys.exit('{0}: "{1}" of "{2}" cannot be precompiled'.format(aux.get('uri'), key, elm.get('name')))
+        if elm['type'] == 'ACRange':
+            peculiar_value = range_peculiar(aux, elm)
+        else:
+            peculiar_value = elm.get(peculiar) if peculiar else None
+        rows.append('  {{ {0}, {1}, {2}, {3} }}'.format(ac_type,
+            strings.ref(elm['name'], '{0}_NAME'.format(n)),
+            strings.ref(elm.get('value'), '{0}_VALUE'.format(n)),
+            strings.ref(peculiar_value, '{0}_PECULIAR'.format(n))))
+    uri = strings.ref(aux.get('uri', ''), 'URI')
+    title = strings.ref(aux.get('title', ''), 'TITLE')
+    out = ''.join(strings.decls) + '\n'
+    if rows:
+        out += 'static const AutoConnectAux::ACElementProp_t {0}_ELEMENTS[] PROGMEM = {{\n{1}\n}};\n\n'.format(name, ',\n'.join(rows))
+    out += 'static const AutoConnectAux::ACPage_t {0} PROGMEM = {{\n  {1}, {2}, {3}, {4}, {5}, {6}\n}};\n'.format(
+        name, uri, title, 'true' if aux.get('menu', True) else 'false',
+        name + '_ELEMENTS' if rows else 'nullptr', len(rows), AUTH[auth])
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Precompile AutoConnectAux JSON for AutoConnect::load.')
+    parser.add_argument('input', help='The JSON document of the custom web pages')
+    parser.add_argument('output', help='The header to be included in the sketch')
+    parser.add_argument('--name', '-n', action='append', help='Symbol of the page in order (Default: AUX and the uri)')
+    args = parser.parse_args()
+
+    with open(args.input, 'r') as f:
+        doc = json.load(f)
+    pages = doc if isinstance(doc, list) else [doc]
+    names = args.name or []
+    body = '\n'.join(page(aux, names[n] if n < len(names) else symbol(aux.get('uri', ''))) for n, aux in enumerate(pages))
+    guard = '_' + re.sub(r'[^0-9A-Z]+', '_', args.output.split('/')[-1].upper()) + '_'
+    with open(args.output, 'w') as f:
+        f.write('// Generated by auxtable.py from {0}\n#ifndef {1}\n#define {1}\n\n{2}\n#endif // !{1}\n'.format(args.input.split('/')[-1], guard, body))
+
+
+if __name__ == '__main__':
+    main()
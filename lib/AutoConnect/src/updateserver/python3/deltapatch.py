@@ -0,0 +1,188 @@
+#!python3.*
+
+"""Make a binary patch for the delta OTA of AutoConnectOTA.
+
+The patch reconstructs NEW from OLD, which is the image running on the
+module. Upload the patch from the AutoConnectOTA page instead of the
+whole binary, with the .bin extension so that it is treated as the
+firmware. The format is described in AutoConnectDelta.h.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+MAGIC = b'ACD1'
+SEED = 8            # Length of the key to find a match
+STRIDE = 4          # Interval of the indexed source positions
+MIN_MATCH = 16      # Shortest exact match starting a new alignment
+GIVE_UP = 64        # Bytes without improvement ending an approximate match
+
+
+def varint(v):
+    b = bytearray()
+    while v > 0x7f:
+        b.append((v & 0x7f) | 0x80)
+        v >>= 7
+    b.append(v)
+    return bytes(b)
+
+
+def zigzag(v):
+    return (v << 1) if v >= 0 else ((-v << 1) - 1)
+
+
+def index(old):
+    idx = dict()
+    for i in range(0, len(old) - SEED + 1, STRIDE):
+        idx.setdefault(old[i:i + SEED], i)
+    return idx
+
+
+def exact(old, o, new, n):
+    l = 0
+    while o + l < len(old) and n + l < len(new) and old[o + l] == new[n + l]:
+        l += 1
+    return l
+
+
+def extend(old, o, new, n, step, limit):
+    """Extend an alignment while more than half of the bytes match."""
+    s = score = length = i = 0
+    while i < limit and i - length <= GIVE_UP:
+        oi = o + i * step
+        ni = n + i * step
+        if oi < 0 or oi >= len(old):
+            break
+        if old[oi] == new[ni]:
+            s += 1
+        i += 1
+        if 2 * s - i > score:
+            score = 2 * s - i
+            length = i
+    return length
+
+
+def align(old, new):
+    """List the approximate matches as (old, new, length)."""
+    idx = index(old)
+    matches = list()
+    offset = None
+    done = 0
+    n = 0
+    while n + SEED <= len(new):
+        key = new[n:n + SEED]
+        o = None
+        if offset is not None and 0 <= n + offset and old[n + offset:n + offset + SEED] == key:
+            o = n + offset
+        else:
+            # The indexed position may lie up to STRIDE-1 bytes behind.
+            for k in range(STRIDE):
+                c = idx.get(new[n + k:n + k + SEED]) if n + k + SEED <= len(new) else None
+                if c is not None and c - k >= 0 and exact(old, c - k, new, n) >= MIN_MATCH:
+                    o = c - k
+                    break
+        if o is None:
+            n += 1
+            continue
+        fwd = extend(old, o, new, n, 1, len(new) - n)
+        back = extend(old, o - 1, new, n - 1, -1, n - done)
+        matches.append((o - back, n - back, back + fwd))
+        offset = o - n
+        done = n = n + fwd
+    return matches
+
+
+def diff_tokens(d):
+    """Encode the diff bytes as runs of zeros and bytes to be added."""
+    out = bytearray()
+    i = 0
+    while i < len(d):
+        j = i
+        while j < len(d) and d[j] == 0:
+            j += 1
+        if j - i >= 3 or j == len(d):
+            out += varint((j - i) << 1)
+            i = j
+            continue
+        j = i
+        while j < len(d) and not (d[j] == 0 and d[j + 1:j + 3] == b'\x00\x00'):
+            j += 1
+        out += varint(((j - i) << 1) | 1) + bytes(d[i:j])
+        i = j
+    return bytes(out)
+
+
+def make(old, new):
+    body = bytearray()
+    pos = 0
+    start = 0
+    for o, n, length in align(old, new) + [(len(old), len(new), 0)]:
+        extra = new[start:n]
+        if extra:
+            body += varint(0) + varint(0) + varint(len(extra)) + extra
+        if length:
+            d = bytes((new[n + i] - old[o + i]) & 0xff for i in range(length))
+            body += varint(zigzag(o - pos)) + varint(length) + varint(0) + diff_tokens(d)
+            pos = o + length
+        start = n + length
+    header = MAGIC + struct.pack('<II', len(old), len(new)) + hashlib.md5(old).digest() + hashlib.md5(new).digest()
+    return header + bytes(body)
+
+
+def apply(old, patch):
+    """Reference applier to verify the patch."""
+    p = 44
+    new = bytearray()
+    pos = 0
+
+    def uvar():
+        nonlocal p
+        v = s = 0
+        while True:
+            c = patch[p]
+            p += 1
+            v |= (c & 0x7f) << s
+            s += 7
+            if not c & 0x80:
+                return v
+
+    while p < len(patch):
+        seek, dlen, elen = uvar(), uvar(), uvar()
+        pos += (seek >> 1) ^ -(seek & 1)
+        while dlen:
+            t = uvar()
+            k = t >> 1
+            for i in range(k):
+                new.append((old[pos + i] + (patch[p + i] if t & 1 else 0)) & 0xff)
+            if t & 1:
+                p += k
+            pos += k
+            dlen -= k
+        new += patch[p:p + elen]
+        p += elen
+    return bytes(new)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Make a delta OTA patch for AutoConnectOTA.')
+    parser.add_argument('old', help='The binary running on the module')
+    parser.add_argument('new', help='The binary to be updated')
+    parser.add_argument('patch', help='The patch file to be uploaded')
+    args = parser.parse_args()
+
+    with open(args.old, 'rb') as f:
+        old = f.read()
+    with open(args.new, 'rb') as f:
+        new = f.read()
+    patch = make(old, new)
+    if apply(old, patch) != new:
+        sys.exit('The patch does not reproduce {0}'.format(args.new))
+    with open(args.patch, 'wb') as f:
+        f.write(patch)
+    print('{0}: {1} bytes, {2:.1f}% of {3}'.format(args.patch, len(patch), len(patch) * 100.0 / len(new), args.new))
+
+
+if __name__ == '__main__':
+    main()
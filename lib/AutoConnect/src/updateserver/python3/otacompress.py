@@ -0,0 +1,146 @@
+#!python3.*
+
+"""Compress a binary for the compressed OTA of AutoConnectOTA.
+
+The image is compressed with heatshrink (LZSS) and decompressed on the
+module within a window of 2^WINDOW bytes while it is uploaded. Upload
+the compressed image from the AutoConnectOTA page with the extension of
+the original file. The format is described in AutoConnectExpander.h.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+import zlib
+
+MAGIC = b'ACZ1'
+MIN_MATCH = 3       # Shortest back reference worth its bits
+CHAIN = 64          # Candidates examined for a match
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.bits = 0
+
+    def put(self, value, bits):
+        self.acc = (self.acc << bits) | value
+        self.bits += bits
+        while self.bits >= 8:
+            self.bits -= 8
+            self.out.append((self.acc >> self.bits) & 0xff)
+        self.acc &= (1 << self.bits) - 1
+
+    def flush(self):
+        if self.bits:
+            self.out.append((self.acc << (8 - self.bits)) & 0xff)
+            self.acc = self.bits = 0
+        return bytes(self.out)
+
+
+def compress(data, window, lookahead):
+    size = 1 << window
+    longest = 1 << lookahead
+    head = dict()
+    prev = [0] * len(data)
+    w = BitWriter()
+
+    def insert(i):
+        if i + MIN_MATCH <= len(data):
+            key = data[i:i + MIN_MATCH]
+            prev[i] = head.get(key, -1)
+            head[key] = i
+
+    def match(i):
+        best, dist = 0, 0
+        limit = min(longest, len(data) - i)
+        if limit < MIN_MATCH:
+            return 0, 0
+        c = head.get(data[i:i + MIN_MATCH], -1)
+        chain = CHAIN
+        while c >= 0 and i - c <= size and chain:
+            if data[c + best:c + best + 1] == data[i + best:i + best + 1]:
+                l = MIN_MATCH
+                while l < limit and data[c + l] == data[i + l]:
+                    l += 1
+                if l > best:
+                    best, dist = l, i - c
+                    if l == limit:
+                        break
+            c = prev[c]
+            chain -= 1
+        return best, dist
+
+    i = 0
+    while i < len(data):
+        l, d = match(i)
+        insert(i)
+        # Defer to a longer match at the next position.
+        if MIN_MATCH <= l < longest and i + 1 < len(data) and match(i + 1)[0] > l:
+            l = 0
+        if l >= MIN_MATCH:
+            w.put(0, 1)
+            w.put(d - 1, window)
+            w.put(l - 1, lookahead)
+            for k in range(i + 1, i + l):
+                insert(k)
+            i += l
+        else:
+            w.put(1, 1)
+            w.put(data[i], 8)
+            i += 1
+    return w.flush()
+
+
+def expand(stream, size, window, lookahead):
+    """Reference decompressor to verify the stream."""
+    out = bytearray()
+    acc = bits = p = 0
+
+    def get(n):
+        nonlocal acc, bits, p
+        while bits < n:
+            acc = (acc << 8) | stream[p]
+            p += 1
+            bits += 8
+        bits -= n
+        v = (acc >> bits) & ((1 << n) - 1)
+        acc &= (1 << bits) - 1
+        return v
+
+    while len(out) < size:
+        if get(1):
+            out.append(get(8))
+        else:
+            d = get(window) + 1
+            for _ in range(get(lookahead) + 1):
+                out.append(out[-d])
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compress a binary for AutoConnectOTA.')
+    parser.add_argument('input', help='The binary to be compressed')
+    parser.add_argument('output', help='The compressed image to be uploaded')
+    parser.add_argument('--window', '-w', type=int, default=12, help='Window size in bits, up to AUTOCONNECT_EXPANDER_WINDOW_MAX (Default: 12)')
+    parser.add_argument('--lookahead', '-l', type=int, default=5, help='Lookahead size in bits (Default: 5)')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    # AutoConnectExpander refuses an image without content.
+    if not data:
+        sys.exit('{0} is empty'.format(args.input))
+    stream = compress(data, args.window, args.lookahead)
+    if expand(stream, len(data), args.window, args.lookahead) != data:
+        sys.exit('The compressed image does not reproduce {0}'.format(args.input))
+    header = MAGIC + struct.pack('<BBxxII', args.window, args.lookahead, len(data), zlib.crc32(data) & 0xffffffff) + hashlib.md5(data).digest()
+    with open(args.output, 'wb') as f:
+        f.write(header + stream)
+    print('{0}: {1} bytes, {2:.1f}% of {3}'.format(args.output, len(header) + len(stream), (len(header) + len(stream)) * 100.0 / len(data), args.input))
+
+
+if __name__ == '__main__':
+    main()
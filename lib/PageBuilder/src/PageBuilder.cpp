@@ -18,6 +18,9 @@ namespace PageBuilderFS { PB_APPLIED_FILECLASS& flash = PB_APPLIED_FILESYSTEM; }
 // Allocate static null string
 const String PageArgument::_nullString = String();
 
+// Compiled molds shared among the PageElements
+std::vector<std::shared_ptr<const PageElement::_MoldST>>  PageElement::_molds;
+
 // A set of fixed directives just for sending No-cache headers
 const PageBuilder::_httpHeaderConstST  PageBuilder::_headersNocache[] PROGMEM = {
   { "Cache-Control", "no-cache,no-store,must-revalidate" },
@@ -91,6 +94,7 @@ const PageArgument::_RequestArgumentST& PageArgument::_item(int i) const {
 void PageElement::addToken(const char* token, HandleFuncT handler) {
   TokenSource source(token, handler);
   _sources.push_back(source);
+  _binding.clear();
 }
 
 /**
@@ -101,6 +105,31 @@ void PageElement::addToken(const char* token, HandleFuncT handler) {
 void PageElement::addToken(const __FlashStringHelper* token, HandleFuncT handler) {
   TokenSource source(token, handler);
   _sources.push_back(source);
+  _binding.clear();
+}
+
+/**
+ * Add a PageElement token replaced by a fixed fragment in PROGMEM.
+ * The fragment is sent as it is without calling a handler.
+ * @param   token     const char*
+ * @param   fragment  const __FlashStringHelper*
+ */
+void PageElement::addToken(const char* token, const __FlashStringHelper* fragment) {
+  TokenSource source(token, fragment);
+  _sources.push_back(source);
+  _binding.clear();
+}
+
+/**
+ * Add a PageElement token replaced by a fixed fragment in PROGMEM.
+ * It is an interface for tokens placed in the .irom.text segment.
+ * @param   token     const __FlashStringHelper*
+ * @param   fragment  const __FlashStringHelper*
+ */
+void PageElement::addToken(const __FlashStringHelper* token, const __FlashStringHelper* fragment) {
+  TokenSource source(token, fragment);
+  _sources.push_back(source);
+  _binding.clear();
 }
 
 /**
@@ -135,6 +164,23 @@ size_t PageElement::build(String& buffer, PageArgument& args) {
   }
 
   rewind();                 // Reset the scanning position.
+  if (_compiled) {
+    // A compiled mold is built span by span, the literal spans are
+    // copied in blocks and the tokens are looked up by index.
+    _bind();
+    for (const _MoldSpanST& span : _compiled->spans) {
+      bool  built = _concatSpan(buffer, _mold + span.offset, span.length);
+      if (built && span.token >= 0) {
+        PGM_P fragment = _fragment(span.token);
+        built = fragment ? _concatSpan(buffer, fragment, strlen_P(fragment)) : buffer.concat(_fillin(span.token, args));
+      }
+      if (!built) {
+        PB_DBG("Element building failure\n");
+        break;
+      }
+    }
+    return buffer.length();
+  }
   c = _contextRead(args);   // Content construction loop
   while (c) {               // Stops at nul character
     if (buffer.concat(c))
@@ -158,6 +204,49 @@ size_t PageElement::build(String& buffer, PageArgument& args) {
 size_t PageElement::build(char* buffer, size_t length, PageArgument& args) {
   size_t  wc = 0;
 
+  if (_compiled) {
+    // Copy as much of the current literal span or replacement string
+    // as the buffer takes at once, and continue from there next time.
+    _bind();
+    while (wc < length && _span.span < _compiled->spans.size()) {
+      const _MoldSpanST&  span = _compiled->spans[_span.span];
+      if (!_span.token) {
+        size_t  n = std::min(static_cast<size_t>(span.length) - _span.pos, length - wc);
+        memcpy_P(buffer + wc, _mold + span.offset + _span.pos, n);
+        wc += n;
+        _span.pos += n;
+        if (_span.pos < span.length)
+          break;
+        _span.pos = 0;
+        if (span.token < 0) {
+          _span.span++;
+          continue;
+        }
+        _span.text = _fragment(span.token);
+        if (_span.text)
+          _span.length = strlen_P(_span.text);
+        else {
+          _span.fillin = _fillin(span.token, args);
+          _span.text = _span.fillin.c_str();
+          _span.length = _span.fillin.length();
+        }
+        _span.token = true;
+      }
+      size_t  n = std::min(_span.length - _span.pos, length - wc);
+      memcpy_P(buffer + wc, _span.text + _span.pos, n);
+      wc += n;
+      _span.pos += n;
+      if (_span.pos < _span.length)
+        break;
+      // Release the replacement string once it has been read.
+      _span.fillin = String();
+      _span.token = false;
+      _span.pos = 0;
+      _span.span++;
+    }
+    return wc;
+  }
+
   while (wc < length) {
     char  c = _contextRead(args);
     if (!c)
@@ -167,6 +256,257 @@ size_t PageElement::build(char* buffer, size_t length, PageArgument& args) {
   return wc;
 }
 
+/**
+ * Fill the tokens of a compiled mold ahead of sending the element.
+ * All the token handlers are invoked here, before any of the element
+ * is sent, so that a handler can still cancel the response.
+ * @param   args    Arguments to be passed to the token handler.
+ * @return  true    The tokens are filled, send the element with send.
+ * @return  false   The mold is not compiled, build the element instead.
+ */
+bool PageElement::fill(PageArgument& args) {
+  _fillins.clear();
+  if (!_compiled)
+    return false;
+  _bind();
+  for (const _MoldSpanST& span : _compiled->spans) {
+    if (span.token >= 0)
+      _fillins.push_back(_fragment(span.token) ? String() : _fillin(span.token, args));
+  }
+  return true;
+}
+
+/**
+ * Send the element filled by fill as the chunked content. The literal
+ * spans are sent straight from the mold without copying them into a
+ * String.
+ * @param   server  Reference of the WebServer sending the content.
+ * @return  Size of the content sent.
+ */
+size_t PageElement::send(WebServer& server) {
+  size_t  wc = 0;
+
+  if (!_compiled)
+    return wc;
+  std::vector<String>::iterator fillin = _fillins.begin();
+  for (const _MoldSpanST& span : _compiled->spans) {
+    // An empty chunk would terminate the chunked transfer.
+    if (span.length) {
+      server.sendContent_P(_mold + span.offset, span.length);
+      wc += span.length;
+    }
+    if (span.token >= 0 && fillin != _fillins.end()) {
+      PGM_P fragment = _fragment(span.token);
+      const size_t  fragmentLength = fragment ? strlen_P(fragment) : 0;
+      if (fragmentLength) {
+        server.sendContent_P(fragment, fragmentLength);
+        wc += fragmentLength;
+      }
+      else if (fillin->length()) {
+        server.sendContent(*fillin);
+        wc += fillin->length();
+      }
+      // Release the replacement string once it has been sent.
+      *fillin++ = String();
+    }
+  }
+  _fillins.clear();
+  return wc;
+}
+
+/**
+ * Match the token names of the compiled mold against the sources.
+ * The index of the matched source is saved for each name, so a token
+ * occurrence is replaced without searching the sources again. The
+ * binding is discarded when a token is added.
+ */
+void PageElement::_bind(void) {
+  if (_binding.size() == _compiled->tokens.size())
+    return;
+
+  _binding.clear();
+  _binding.reserve(_compiled->tokens.size());
+  for (const _MoldTokenST& token : _compiled->tokens) {
+    String  name;
+    if (!name.reserve(token.length)) {
+      PB_DBG("Token binding failed, free:%u\n", ESP.getFreeHeap());
+    }
+    _concatSpan(name, _mold + token.offset, token.length);
+    int16_t bound = -1;
+    for (size_t i = 0; i < _sources.size(); i++) {
+      if (_sources[i].match(name.c_str())) {
+        bound = static_cast<int16_t>(i);
+        break;
+      }
+    }
+    PB_DBG_DUMB("%s%s ", name.c_str(), bound < 0 ? "?" : "");
+    _binding.push_back(bound);
+  }
+}
+
+/**
+ * Append a span of text to the buffer. The span is copied in blocks,
+ * which also works for the text in flash.
+ * @param   buffer  Reference of the String to append to.
+ * @param   span    The span of text.
+ * @param   length  Length of the span.
+ * @return  false   The buffer could not be extended.
+ */
+bool PageElement::_concatSpan(String& buffer, PGM_P span, size_t length) {
+  char  block[64];
+  PGM_P p = span;
+
+  while (length) {
+    size_t  n = std::min(length, sizeof(block) - 1);
+    memcpy_P(block, p, n);
+    block[n] = '\0';
+    if (!buffer.concat(block))
+      return false;
+    p += n;
+    length -= n;
+  }
+  return true;
+}
+
+/**
+ * Get the replacement string of a compiled token. As with the lexical
+ * reader, an unmatched token leaves only the opening delimiter and the
+ * replacement string may contain tokens itself.
+ * @param   token   Index of the token in the compiled mold.
+ * @param   args    Arguments to be passed to the token handler.
+ * @return  The replacement string.
+ */
+String PageElement::_fillin(int16_t token, PageArgument& args) {
+  const int16_t source = _binding[token];
+  if (source < 0)
+    return String(PAGEBUILDER_TOKENDELIMITER_OPEN);
+
+  if (_sources[source].fragment)
+    return String(FPSTR(_sources[source].fragment));
+
+  String  fillin = _sources[source].builder(args);
+  const char  nested[] = { PAGEBUILDER_TOKENDELIMITER_OPEN, PAGEBUILDER_TOKENDELIMITER_OPEN, '\0' };
+  if (fillin.indexOf(nested) < 0)
+    return fillin;
+
+  // Build the replacement string as a mold with the same sources.
+  PageElement element;
+  String  content;
+  element._sources = _sources;
+  element._mold = fillin.c_str();
+  element._storage = TokenSource::HEAP;
+  element._approxSize = fillin.length();
+  element._compiled = _compile(element._mold, TokenSource::HEAP);
+  element.build(content, args);
+  return content;
+}
+
+/**
+ * Get the fixed fragment which replaces a compiled token.
+ * @param   token   Index of the token in the compiled mold.
+ * @return  The fragment in PROGMEM, null if the token has a handler or is unmatched.
+ */
+PGM_P PageElement::_fragment(int16_t token) const {
+  const int16_t source = _binding[token];
+  return source < 0 ? nullptr : _sources[source].fragment;
+}
+
+/**
+ * Split the mold into literal spans and tokens. The mold is scanned
+ * with the same lexical rules as _contextRead once, and the compiled
+ * mold in flash is cached for the elements built from it later.
+ * @param   mold    The mold to compile.
+ * @param   storage Storage class of the mold, HEAP or TEXT.
+ * @return  The compiled mold, null if the mold is too long to compile.
+ */
+std::shared_ptr<const PageElement::_MoldST> PageElement::_compile(PGM_P mold, TokenSource::STORAGE_CLASS_t storage) {
+  if (storage == TokenSource::TEXT) {
+    for (auto it = _molds.begin(); it != _molds.end(); ++it) {
+      if ((*it)->mold == mold) {
+        std::shared_ptr<const _MoldST>  hit = *it;
+        _molds.erase(it);
+        _molds.insert(_molds.begin(), hit);
+        return hit;
+      }
+    }
+  }
+
+  auto  at = [&](size_t i) -> char {
+    return storage == TokenSource::TEXT ? static_cast<char>(pgm_read_byte(mold + i)) : mold[i];
+  };
+
+  // Spans are addressed with 16-bit offsets.
+  if ((storage == TokenSource::TEXT ? strlen_P(mold) : strlen(mold)) > UINT16_MAX) {
+    PB_DBG("Mold too long to compile\n");
+    return nullptr;
+  }
+
+  std::shared_ptr<_MoldST>  compiled = std::make_shared<_MoldST>();
+  compiled->mold = mold;
+  size_t  literal = 0;
+  size_t  i = 0;
+  char  c;
+  while ((c = at(i)) != '\0') {
+    if (c != PAGEBUILDER_TOKENDELIMITER_OPEN || at(i + 1) != PAGEBUILDER_TOKENDELIMITER_OPEN) {
+      i++;
+      continue;
+    }
+
+    // A token ends at the closing delimiter pair or at the end of the mold.
+    const size_t  name = i + 2;
+    size_t  next = name;
+    size_t  end;
+    while (true) {
+      c = at(next);
+      if (c == '\0') {
+        end = next;
+        break;
+      }
+      else if (c == PAGEBUILDER_TOKENDELIMITER_CLOSE) {
+        const char  sub_c = at(next + 1);
+        if (sub_c == PAGEBUILDER_TOKENDELIMITER_CLOSE || !sub_c) {
+          end = next;
+          next += sub_c ? 2 : 1;
+          break;
+        }
+        next += 2;
+      }
+      else
+        next++;
+    }
+
+    // An empty token is dropped from the content.
+    int16_t token = -1;
+    if (end > name) {
+      const uint16_t  length = end - name;
+      for (size_t t = 0; t < compiled->tokens.size() && token < 0; t++) {
+        const _MoldTokenST& known = compiled->tokens[t];
+        if (known.length == length) {
+          size_t  k = 0;
+          while (k < length && at(known.offset + k) == at(name + k))
+            k++;
+          if (k == length)
+            token = static_cast<int16_t>(t);
+        }
+      }
+      if (token < 0) {
+        compiled->tokens.push_back({ static_cast<uint16_t>(name), length });
+        token = static_cast<int16_t>(compiled->tokens.size() - 1);
+      }
+    }
+    compiled->spans.push_back({ static_cast<uint16_t>(literal), static_cast<uint16_t>(i - literal), token });
+    literal = i = next;
+  }
+  compiled->spans.push_back({ static_cast<uint16_t>(literal), static_cast<uint16_t>(i - literal), -1 });
+
+  if (storage == TokenSource::TEXT && PAGEELEMENT_MOLDCACHE_SIZE > 0) {
+    if (_molds.size() >= PAGEELEMENT_MOLDCACHE_SIZE)
+      _molds.pop_back();
+    _molds.insert(_molds.begin(), compiled);
+  }
+  return compiled;
+}
+
 /**
  * Read as context while replacing the token contained in the mold with
  * the actual string
@@ -189,7 +529,7 @@ char PageElement::_contextRead(PageArgument& args) {
       bool  subseq = false;
       do {
         c = _read();
-        if (c == PAGEBUILDER_TOKENDELIMITER_OPEN) {
+        if (c == PAGEBUILDER_TOKENDELIMITER_OPEN && !_raw._verbatim) {
           _sub_c = _read();
           if (_sub_c == PAGEBUILDER_TOKENDELIMITER_OPEN) {
             _sub_c = '\0';
@@ -198,20 +538,31 @@ char PageElement::_contextRead(PageArgument& args) {
             if (token.length()) {
               // here, matches a token
               HandleFuncT exchanger = nullptr;
+              PGM_P fragment = nullptr;
               for (TokenSource& source : _sources) {
                 // Find the token replacement source
                 if (source.match(token.c_str())) {
                   exchanger = source.builder;
+                  fragment = source.fragment;
                   break;
                 }
               }
-              if (exchanger) {
+              if (fragment) {
+                // Read the fragment as it is, directly from the flash
+                _indexStack.push(_raw);
+                _raw._p = fragment;
+                _raw._storage = TokenSource::STORAGE_CLASS_t::TEXT;
+                _raw._verbatim = true;
+                c = _contextRead(args);
+              }
+              else if (exchanger) {
                 // Get token replacement string, extract into the content
                 _indexStack.push(_raw);
                 _raw._fillin = exchanger(args);
                 _raw._storage = TokenSource::STORAGE_CLASS_t::STRING;
                 _raw._s = 0;
                 _raw._p = nullptr;
+                _raw._verbatim = false;
                 // Read context again due to source changes
                 c = _contextRead(args);
               }
@@ -314,8 +665,14 @@ void PageElement::rewind(void) {
   _raw._storage = _storage;
   _raw._s = 0;
   _raw._p = _mold;
+  _raw._verbatim = false;
   _sub_c = '\0';
   _eoe = false;
+  _fillins.clear();
+  _span.span = 0;
+  _span.pos = 0;
+  _span.token = false;
+  _span.fillin = String();
 }
 
 /**
@@ -327,11 +684,15 @@ void PageElement::setMold(const char* mold) {
     _mold = mold;
     _storage = TokenSource::HEAP;
     _approxSize = strlen(_mold);
+    _compiled = _compile(_mold, _storage);
   }
   else {
+    // The file content is read at the build, it is not compiled.
     _mold = mold + strlen(PAGEELEMENT_TOKENIDENTIFIER_FILE);
     _storage = TokenSource::FILE;
+    _compiled.reset();
   }
+  _binding.clear();
 }
 
 /**
@@ -342,6 +703,8 @@ void PageElement::setMold(const __FlashStringHelper* mold) {
   _mold = reinterpret_cast<PGM_P>(mold);
   _storage = TokenSource::TEXT;
   _approxSize = strlen_P(_mold);
+  _compiled = _compile(_mold, _storage);
+  _binding.clear();
 }
 
 /**
@@ -649,17 +1012,28 @@ void PageBuilder::_handle(int code, WebServer& server) {
       // Chunks generate and send a page segment for each element of
       // PageElements. PageBuilder needs enough heap space to store a
       // segment of the page content into a String instance.
+      // A compiled element has only its tokens filled in advance, and
+      // its literal spans are sent straight from the mold.
       for (auto& element : _elements) {
+        PageElement&  pe = element.get();
         String  contentBlock;
-        size_t  blkSize = element.get().build(contentBlock, args);
-        if (_cancel)
+        size_t  blkSize = 0;
+        const bool  filled = pe.fill(args);
+        if (!filled)
+          blkSize = pe.build(contentBlock, args);
+        if (_cancel) {
+          pe.rewind();
           return;
+        }
         else if (firstOrder) {
           server.setContentLength(CONTENT_LENGTH_UNKNOWN);
           server.send(code, "text/html", "");
           firstOrder = false;
         }
-        server.sendContent_P(contentBlock.c_str());
+        if (filled)
+          blkSize = pe.send(server);
+        else if (blkSize)
+          server.sendContent_P(contentBlock.c_str());
         (void)(blkSize);
         PB_DBG("blk:%u\n", blkSize);
         server.client().flush();
@@ -17,6 +17,7 @@
 #include <stack>
 #include <vector>
 #include <iterator>
+#include <memory>
 #if defined(ARDUINO_ARCH_ESP8266)
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
@@ -132,6 +133,14 @@ using WebServer = ESP8266WebServer;
 #define PAGEELEMENT_TOKENIDENTIFIER_FILE  "file:"
 #endif
 
+// Number of compiled molds in flash kept for reuse. A PageElement is
+// usually constructed for each request from the same PROGMEM mold, so
+// the compiled form is shared instead of being rebuilt every time.
+// Setting 0 disables the cache, the mold is compiled per element then.
+#ifndef PAGEELEMENT_MOLDCACHE_SIZE
+#define PAGEELEMENT_MOLDCACHE_SIZE        4
+#endif
+
 /**
  * Container for HTTP request parameters from the current client of the
  * ESP8266WebServer. It provides access methods equivalent to the HTTP
@@ -177,6 +186,10 @@ typedef std::function<String(PageArgument&)>  HandleFuncT;
  * handler. It also supports proper reading depending on the distinction
  * between the type of PageElement and the storage where the token is
  * placed (it is a heap area or a text block that is a PROGMEM attribute).
+ * A token can also be replaced by a fixed fragment placed in PROGMEM
+ * instead of a handler. The fragment is sent as it is, directly from
+ * the flash without being copied into a String, and is not scanned for
+ * tokens.
  */
 class TokenSource {
  public:
@@ -188,9 +201,11 @@ class TokenSource {
     FILE          /**< For File */
   };
 
-  TokenSource() : token(nullptr) {}
-  TokenSource(const char* token, HandleFuncT builder) : token(token), builder(builder), _storage(STORAGE_CLASS_t::HEAP) {}
-  TokenSource(const __FlashStringHelper* token, HandleFuncT builder) : token(reinterpret_cast<PGM_P>(token)), builder(builder), _storage(STORAGE_CLASS_t::TEXT) {}
+  TokenSource() : token(nullptr), fragment(nullptr) {}
+  TokenSource(const char* token, HandleFuncT builder) : token(token), builder(builder), fragment(nullptr), _storage(STORAGE_CLASS_t::HEAP) {}
+  TokenSource(const __FlashStringHelper* token, HandleFuncT builder) : token(reinterpret_cast<PGM_P>(token)), builder(builder), fragment(nullptr), _storage(STORAGE_CLASS_t::TEXT) {}
+  TokenSource(const char* token, const __FlashStringHelper* fragment) : token(token), builder(nullptr), fragment(reinterpret_cast<PGM_P>(fragment)), _storage(STORAGE_CLASS_t::HEAP) {}
+  TokenSource(const __FlashStringHelper* token, const __FlashStringHelper* fragment) : token(reinterpret_cast<PGM_P>(token)), builder(nullptr), fragment(reinterpret_cast<PGM_P>(fragment)), _storage(STORAGE_CLASS_t::TEXT) {}
   virtual ~TokenSource() {}
   bool  match(const char* key) const {
     return !(_storage == HEAP ? strcmp(key, token) : strcmp_P(key, reinterpret_cast<const char*>(token)));
@@ -198,6 +213,7 @@ class TokenSource {
 
   PGM_P         token;                /**< a token */
   HandleFuncT   builder;              /**< User defined handler to replace a token */
+  PGM_P         fragment;             /**< Fixed replacement in PROGMEM, used instead of the builder */
 
  private:
   STORAGE_CLASS_t  _storage;          /**< Explicit distinction of storage where token is placed */
@@ -224,13 +240,17 @@ class PageElement {
   ~PageElement() {}
   void  addToken(const char* token, HandleFuncT handler);
   void  addToken(const __FlashStringHelper* token, HandleFuncT handler);
+  void  addToken(const char* token, const __FlashStringHelper* fragment);
+  void  addToken(const __FlashStringHelper* token, const __FlashStringHelper* fragment);
   size_t  build(String& buffer);
   size_t  build(String& buffer, PageArgument& args);
   size_t  build(char* buffer, size_t length, PageArgument& args);
+  bool  fill(PageArgument& args);
   size_t  getApproxSize(void) const { return _approxSize; }
   PGM_P mold(void) const { return _mold; }
   void  reserve(const size_t reserveSize = 0) { _reserveSize = reserveSize; }
   void  rewind(void);
+  size_t  send(WebServer& server);
   void  setMold(const char* mold);
   void  setMold(const __FlashStringHelper* mold);
 
@@ -244,11 +264,51 @@ class PageElement {
     String  _fillin;                  /**< String with a token replaced */
     std::shared_ptr<File> _file;      /**< File for file: mold */
     TokenSource::STORAGE_CLASS_t  _storage; /**< Distinct class of storage to be scanned */
+    bool  _verbatim;                  /**< Scanning a fixed fragment, which holds no tokens */
   } _LexicalIndexST;
 
+  // A literal span of the compiled mold, followed by a token unless
+  // the token index is negative.
+  typedef struct {
+    uint16_t  offset;                 /**< Offset of the literal span in the mold */
+    uint16_t  length;                 /**< Length of the literal span */
+    int16_t   token;                  /**< Index of the following token in _MoldST::tokens */
+  } _MoldSpanST;
+
+  // Position of a token name in the mold.
+  typedef struct {
+    uint16_t  offset;                 /**< Offset of the token name in the mold */
+    uint16_t  length;                 /**< Length of the token name */
+  } _MoldTokenST;
+
+  // A mold split into literal spans and tokens ahead of the build.
+  // Each distinct token name appears once in the tokens, so it is
+  // matched against the sources once and then looked up by index.
+  typedef struct {
+    PGM_P   mold;                     /**< The compiled mold */
+    std::vector<_MoldSpanST>  spans;  /**< Literal spans in the order of the mold */
+    std::vector<_MoldTokenST> tokens; /**< Distinct token names */
+  } _MoldST;
+
+  // Read position in the compiled mold, kept across the successive
+  // builds of a streaming output.
+  typedef struct {
+    size_t  span;                     /**< Index of the span being read */
+    size_t  pos;                      /**< Read offset in the literal span or the replacement */
+    bool    token;                    /**< The replacement of the span's token is being read */
+    PGM_P   text;                     /**< The replacement, a fragment or the fill-in string */
+    size_t  length;                   /**< Length of the replacement */
+    String  fillin;                   /**< Replacement string built by the token handler */
+  } _SpanIndexST;
+
+  void    _bind(void);                /**< Match the compiled token names against the sources */
+  static bool _concatSpan(String& buffer, PGM_P span, size_t length);  /**< Append a span of text in PROGMEM */
   char    _contextRead(PageArgument& args); /**< Common lexical reader */
   String  _extractToken(void);        /**< Read as context while replacing the tokens */
+  String  _fillin(int16_t token, PageArgument& args); /**< Replacement string of a compiled token */
+  PGM_P   _fragment(int16_t token) const; /**< Fixed fragment of a compiled token, if any */
   char    _read(void);                /**< Common lexical reader */
+  static std::shared_ptr<const _MoldST> _compile(PGM_P mold, TokenSource::STORAGE_CLASS_t storage);  /**< Split the mold into spans and tokens */
 
   char    _sub_c;                     /**< Subsequent characters at a token delimiter appearance */
   size_t  _reserveSize = 0;           /**< Size when reserving read buffer as context */
@@ -262,6 +322,11 @@ class PageElement {
   _LexicalIndexST               _raw;         /**< Position of lexical currently being scanned */
   std::stack<_LexicalIndexST>   _indexStack;  /**< Stack for the mold scanning position save */
   bool    _eoe;                       /**< The element has been read */
+  std::shared_ptr<const _MoldST>  _compiled;  /**< Compiled mold, null for file: molds */
+  std::vector<int16_t>          _binding;     /**< Source index of each compiled token, -1 if unmatched */
+  std::vector<String>           _fillins;     /**< Replacement strings filled ahead of send */
+  _SpanIndexST                  _span = {};   /**< Streaming read position in the compiled mold */
+  static std::vector<std::shared_ptr<const _MoldST>>  _molds; /**< Compiled molds in flash, most recent first */
 };
 
 // The type of user-owned function for preparing the handling of current URI.
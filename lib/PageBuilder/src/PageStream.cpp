@@ -18,11 +18,10 @@
 size_t PageStream::readBytes(char* buffer, size_t length) {
   size_t  wc = 0;
 
-  while (wc < length) {
-    if (_pos >= _content.length())
-      break;
-    *buffer++ = _content[_pos++];
-    wc++;
+  if (_pos < _content.length()) {
+    wc = std::min(length, static_cast<size_t>(_content.length()) - _pos);
+    memcpy(buffer, _content.c_str() + _pos, wc);
+    _pos += wc;
   }
   return wc;
 }
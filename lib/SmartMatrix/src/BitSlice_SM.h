@@ -0,0 +1,91 @@
+#ifndef _SMARTMATRIX_BITSLICE_H_
+#define _SMARTMATRIX_BITSLICE_H_
+
+#include <stdint.h>
+
+/* Bit-slicing of HUB75 pixel data into bitplanes
+ *
+ * Every pixel clocked into a HUB75 panel drives six data lines (R1 G1 B1 R2 G2 B2), and every bitplane needs one
+ * bit of each of the six channels.  Instead of testing each channel against a mask once per bitplane, the channels
+ * are treated as the rows of an 8x8 bit matrix and transposed (as in FastLED's bitswap.h), giving the six data
+ * bits of eight bitplanes at once: bit 0 = R1, 1 = G1, 2 = B1, 3 = R2, 4 = G2, 5 = B2.
+ *
+ * Nothing here depends on the platform, the output can be checked against the per-bitplane packer on a host.
+ */
+
+#define BITSLICE_R1_BIT     (1 << 0)
+#define BITSLICE_G1_BIT     (1 << 1)
+#define BITSLICE_B1_BIT     (1 << 2)
+#define BITSLICE_R2_BIT     (1 << 3)
+#define BITSLICE_G2_BIT     (1 << 4)
+#define BITSLICE_B2_BIT     (1 << 5)
+
+/* out[b] bit i = in[i] bit b, done on two 32-bit halves which suits the 32-bit cores */
+static inline void bitSliceTranspose8x8(const uint8_t in[8], uint8_t out[8]) {
+    uint32_t lo = in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+    uint32_t hi = in[4] | (in[5] << 8) | (in[6] << 16) | ((uint32_t)in[7] << 24);
+    uint32_t t;
+
+    // swap 1x1 blocks, then 2x2 blocks, then 4x4 blocks
+    t = (lo ^ (lo >> 7)) & 0x00AA00AA;
+    lo ^= t ^ (t << 7);
+    t = (hi ^ (hi >> 7)) & 0x00AA00AA;
+    hi ^= t ^ (t << 7);
+
+    t = (lo ^ (lo >> 14)) & 0x0000CCCC;
+    lo ^= t ^ (t << 14);
+    t = (hi ^ (hi >> 14)) & 0x0000CCCC;
+    hi ^= t ^ (t << 14);
+
+    t = (lo ^ (hi << 4)) & 0xF0F0F0F0;
+    lo ^= t;
+    hi ^= t >> 4;
+
+    out[0] = lo;
+    out[1] = lo >> 8;
+    out[2] = lo >> 16;
+    out[3] = lo >> 24;
+    out[4] = hi;
+    out[5] = hi >> 8;
+    out[6] = hi >> 16;
+    out[7] = hi >> 24;
+}
+
+/* planes[j] = data bits for bit (firstBit + j) of the channels, channels are 8 or 16 bits wide
+ * only the bytes of the channels that hold the requested bits are transposed */
+template <int numPlanes, int firstBit>
+static inline void bitSliceChannels(uint16_t r1, uint16_t g1, uint16_t b1, uint16_t r2, uint16_t g2, uint16_t b2, uint8_t planes[numPlanes]) {
+    uint8_t in[8];
+    uint8_t out[8];
+
+    in[6] = in[7] = 0;
+
+    if(firstBit < 8) {
+        in[0] = r1; in[1] = g1; in[2] = b1;
+        in[3] = r2; in[4] = g2; in[5] = b2;
+        bitSliceTranspose8x8(in, out);
+
+        for(int j = 0; j < numPlanes && firstBit + j < 8; j++)
+            planes[j] = out[firstBit + j];
+    }
+
+    if(firstBit + numPlanes > 8) {
+        in[0] = r1 >> 8; in[1] = g1 >> 8; in[2] = b1 >> 8;
+        in[3] = r2 >> 8; in[4] = g2 >> 8; in[5] = b2 >> 8;
+        bitSliceTranspose8x8(in, out);
+
+        for(int j = (firstBit < 8) ? 8 - firstBit : 0; j < numPlanes; j++)
+            planes[j] = out[firstBit + j - 8];
+    }
+}
+
+/* slices a row of pixel pairs, planes holds numPlanes bytes per pixel */
+template <int numPlanes, int firstBit, typename RGB>
+static inline void bitSliceRow(const RGB upper[], const RGB lower[], int numPixels, uint8_t planes[]) {
+    for(int k = 0; k < numPixels; k++) {
+        bitSliceChannels<numPlanes, firstBit>(upper[k].red, upper[k].green, upper[k].blue,
+            lower[k].red, lower[k].green, lower[k].blue, &planes[k * numPlanes]);
+    }
+}
+
+#endif
@@ -1,32 +1,69 @@
 #ifndef _SMARTMATRIX_CIRCULARBUFFER_H_
 #define _SMARTMATRIX_CIRCULARBUFFER_H_
 
-// TODO: Consider INLINE for several functions - many small, only used in one place, in frequently used code
-
-/* Circular buffer object */
+/* Circular buffer object, single producer and single consumer
+ *
+ * head is only advanced by the producer (cbWrite), tail only by the consumer (cbRead), so the refresh ISR and the
+ * calc task never write the same field.  Both run over [0, 2*size) so that full (head - tail == size) and empty
+ * (head == tail) are told apart without a shared count, and an index is taken with a compare instead of a divide,
+ * as dmaBufferNumRows is not always a power of two.  The index written by one side is published with release
+ * ordering and read with acquire ordering by the other, so the data in the element is visible before the index.
+ *
+ * The functions are inline so they get compiled into the refresh ISR instead of being called from it.
+ */
 typedef struct {
     int         size;   /* maximum number of elements           */
-    int         start;  /* index of oldest element              */
-    int         count;    /* new  */
+    int         head;   /* next element to write, 0..2*size-1   */
+    int         tail;   /* oldest element, 0..2*size-1          */
 } CircularBuffer_SM;
 
 void cbInit(CircularBuffer_SM *cb, int size);
 
-int cbIsFull(CircularBuffer_SM *cb);
+static inline int cbCount(CircularBuffer_SM *cb) {
+    int count = __atomic_load_n(&cb->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&cb->tail, __ATOMIC_ACQUIRE);
+    return count < 0 ? count + 2 * cb->size : count;
+}
+
+static inline int cbIndex(CircularBuffer_SM *cb, int position) {
+    return position >= cb->size ? position - cb->size : position;
+}
+
+static inline int cbAdvance(CircularBuffer_SM *cb, int position) {
+    return ++position == 2 * cb->size ? 0 : position;
+}
+
+static inline int cbIsFull(CircularBuffer_SM *cb) {
+    return cbCount(cb) == cb->size;
+}
 
-int cbIsEmpty(CircularBuffer_SM *cb);
+static inline int cbIsEmpty(CircularBuffer_SM *cb) {
+    return cbCount(cb) == 0;
+}
 
 // returns index of next element to write
-int cbGetNextWrite(CircularBuffer_SM *cb);
+static inline int cbGetNextWrite(CircularBuffer_SM *cb) {
+    return cbIndex(cb, __atomic_load_n(&cb->head, __ATOMIC_RELAXED));
+}
 
 // mark next element as written
-void cbWrite(CircularBuffer_SM *cb);
+// the element under the consumer can't be overwritten, so a write to a full buffer is dropped; callers wait on cbIsFull
+static inline void cbWrite(CircularBuffer_SM *cb) {
+    if (cbIsFull(cb))
+        return;
+    __atomic_store_n(&cb->head, cbAdvance(cb, __atomic_load_n(&cb->head, __ATOMIC_RELAXED)), __ATOMIC_RELEASE);
+}
 
 // returns index of next element to read
-int cbGetNextRead(CircularBuffer_SM *cb);
+static inline int cbGetNextRead(CircularBuffer_SM *cb) {
+    return cbIndex(cb, __atomic_load_n(&cb->tail, __ATOMIC_RELAXED));
+}
 
 // marks next element as read
-void cbRead(CircularBuffer_SM *cb);
+static inline void cbRead(CircularBuffer_SM *cb) {
+    if (cbIsEmpty(cb))
+        return;
+    __atomic_store_n(&cb->tail, cbAdvance(cb, __atomic_load_n(&cb->tail, __ATOMIC_RELAXED)), __ATOMIC_RELEASE);
+}
 
 
 #endif // _SMARTMATRIX_CIRCULARBUFFER_H_
@@ -46,3 +46,60 @@ int SM_Layer::getRequestedBrightnessShifts() {
 bool SM_Layer::isLayerChanged() {
     return true;
 }
+
+// layers that don't track changed rows have every row refreshed
+bool SM_Layer::isRowChanged(uint16_t hardwareY) {
+    return true;
+}
+
+bool SM_Layer::getHardwareRows(int16_t localX0, int16_t localY0, int16_t localX1, int16_t localY1, int16_t &hardwareY0, int16_t &hardwareY1) const {
+    switch( layerRotation ) {
+      case rotation180 :
+        hardwareY0 = (matrixHeight - 1) - localY1;
+        hardwareY1 = (matrixHeight - 1) - localY0;
+        break;
+      case rotation90 :
+        hardwareY0 = localX0;
+        hardwareY1 = localX1;
+        break;
+      case rotation270 :
+        hardwareY0 = (matrixHeight - 1) - localX1;
+        hardwareY1 = (matrixHeight - 1) - localX0;
+        break;
+      case rotation0 :
+      default:
+        hardwareY0 = localY0;
+        hardwareY1 = localY1;
+        break;
+    };
+
+    if(hardwareY0 < 0)
+        hardwareY0 = 0;
+    if(hardwareY1 >= matrixHeight)
+        hardwareY1 = matrixHeight - 1;
+
+    return hardwareY0 <= hardwareY1;
+}
+
+void SM_Layer::setRowBits(uint32_t *rows, int16_t hardwareY0, int16_t hardwareY1) {
+    for(int y=hardwareY0; y<=hardwareY1; y++)
+        rows[y / 32] |= (uint32_t)1 << (y % 32);
+}
+
+void SM_Layer::setOpacity(uint8_t newOpacity) {
+    opacity = newOpacity;
+    compositionChange = true;
+}
+
+void SM_Layer::setBlendMode(BlendMode newBlendMode) {
+    blendMode = newBlendMode;
+    compositionChange = true;
+}
+
+bool SM_Layer::getCompositionChanged(void) {
+    if(compositionChange) {
+        compositionChange = false;
+        return true;
+    }
+    return false;
+}
@@ -44,6 +44,21 @@ class SM_Layer {
         virtual void setRefreshRate(uint8_t newRefreshRate);
         virtual int getRequestedBrightnessShifts();
         virtual bool isLayerChanged();
+        // true if fillRefreshRow() may return different data for hardwareY than on the previous frame, valid after frameRefreshCallback()
+        virtual bool isRowChanged(uint16_t hardwareY);
+
+        // opacity and blend mode are applied when the layer is composed over the layers below it, 0 hides the layer
+        void setOpacity(uint8_t newOpacity);
+        uint8_t getOpacity(void) const { return opacity; };
+        void setBlendMode(BlendMode newBlendMode);
+        BlendMode getBlendMode(void) const { return blendMode; };
+        // true once after the opacity or blend mode changed
+        bool getCompositionChanged(void);
+
+        // fills refreshRow like fillRefreshRow(), composing the layer over the contents of refreshRow with the layer's opacity and blend mode
+        // scratchRow holds 2 * matrixWidth values, and can't be shared by rows being composed at the same time
+        template <typename RGB>
+        void composeRefreshRow(uint16_t hardwareY, RGB refreshRow[], RGB scratchRow[], int brightnessShifts = 0);
 
         SM_Layer * nextLayer;
 
@@ -57,8 +72,89 @@ class SM_Layer {
         // the local dimensions of this layer with rotation applied, local x=0,y=0 in the upper left
         uint16_t localWidth, localHeight;
         uint8_t refreshRate;
+        uint8_t opacity = 255;
+        BlendMode blendMode = blendNormal;
+        volatile bool compositionChange = false;
+
+        // helpers for layers that track changed rows in a bitmap with one bit per hardware row
+        // the hardware rows covered by a rectangle of the local screen, clipped to the matrix, false if none are covered
+        bool getHardwareRows(int16_t localX0, int16_t localY0, int16_t localX1, int16_t localY1, int16_t &hardwareY0, int16_t &hardwareY1) const;
+        static void setRowBits(uint32_t *rows, int16_t hardwareY0, int16_t hardwareY1);
+        static bool getRowBit(const uint32_t *rows, uint16_t hardwareY) { return rows[hardwareY / 32] & ((uint32_t)1 << (hardwareY % 32)); };
         
     private:
+        template <typename T>
+        static T multiplyChannel(T a, T b);
+        template <typename T>
+        static T blendChannel(T below, T layer, BlendMode mode, uint16_t scaledOpacity);
 };
 
+// 8-bit fixed point product of two channels, with full scale treated as 1.0
+template <typename T>
+inline T SM_Layer::multiplyChannel(T a, T b) {
+    const int channelBits = sizeof(T) * 8;
+    uint32_t product = (uint32_t)a * b + (1UL << (channelBits - 1));
+    return (product + (product >> channelBits)) >> channelBits;
+}
+
+// scaledOpacity is 1-256, 256 for a fully opaque layer
+template <typename T>
+inline T SM_Layer::blendChannel(T below, T layer, BlendMode mode, uint16_t scaledOpacity) {
+    const uint32_t channelMax = (T)~0;
+    T blended;
+
+    switch(mode) {
+        case blendAdd:
+            blended = ((uint32_t)below + layer > channelMax) ? channelMax : below + layer;
+            break;
+        case blendMultiply:
+            blended = multiplyChannel<T>(below, layer);
+            break;
+        case blendScreen:
+            blended = channelMax - multiplyChannel<T>(channelMax - below, channelMax - layer);
+            break;
+        case blendNormal:
+        default:
+            blended = layer;
+            break;
+    }
+
+    if(scaledOpacity == 256)
+        return blended;
+
+    return below + (((int32_t)blended - below) * scaledOpacity >> 8);
+}
+
+template <typename RGB>
+void SM_Layer::composeRefreshRow(uint16_t hardwareY, RGB refreshRow[], RGB scratchRow[], int brightnessShifts) {
+    // hidden layer, or a layer that simply overwrites the layers below it
+    if(!opacity)
+        return;
+
+    if(opacity == 255 && blendMode == blendNormal) {
+        fillRefreshRow(hardwareY, refreshRow, brightnessShifts);
+        return;
+    }
+
+    // layers leave transparent pixels untouched, so fill over black and over white: only the pixels the layer draws match
+    RGB * layerRow = &scratchRow[0];
+    RGB * coverageRow = &scratchRow[matrixWidth];
+    memset(layerRow, 0x00, sizeof(RGB) * matrixWidth);
+    memset(coverageRow, 0xFF, sizeof(RGB) * matrixWidth);
+    fillRefreshRow(hardwareY, layerRow, brightnessShifts);
+    fillRefreshRow(hardwareY, coverageRow, brightnessShifts);
+
+    BlendMode mode = blendMode;
+    uint16_t scaledOpacity = opacity + (opacity >> 7);
+
+    for(int i=0; i<matrixWidth; i++) {
+        if(layerRow[i].red != coverageRow[i].red || layerRow[i].green != coverageRow[i].green || layerRow[i].blue != coverageRow[i].blue)
+            continue;
+
+        refreshRow[i].red = blendChannel(refreshRow[i].red, layerRow[i].red, mode, scaledOpacity);
+        refreshRow[i].green = blendChannel(refreshRow[i].green, layerRow[i].green, mode, scaledOpacity);
+        refreshRow[i].blue = blendChannel(refreshRow[i].blue, layerRow[i].blue, mode, scaledOpacity);
+    }
+}
+
 #endif
@@ -41,6 +41,7 @@ class SMLayerBackground : public SM_Layer {
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
         int getRequestedBrightnessShifts();
         bool isLayerChanged();
+        bool isRowChanged(uint16_t hardwareY);
         
         void swapBuffers(bool copy = true);
         bool isSwapPending();
@@ -94,6 +95,16 @@ class SMLayerBackground : public SM_Layer {
 
         RGB *getCurrentRefreshRow(uint16_t y);
 
+        // converting refresh buffer rows to refresh rows
+        template <bool colorCorrection, int numShifts>
+        void loadRefreshPixel(const RGB &currentPixel, rgb48 &refreshPixel, int brightnessShifts);
+        template <bool colorCorrection, int numShifts>
+        void loadRefreshPixel(const RGB &currentPixel, rgb24 &refreshPixel, int brightnessShifts);
+        template <bool colorCorrection, int numShifts, typename RGB_OUT>
+        void loadRefreshRow(const RGB *ptr, RGB_OUT refreshRow[], int brightnessShifts);
+        template <bool colorCorrection, typename RGB_OUT>
+        void loadRefreshRow(const RGB *ptr, RGB_OUT refreshRow[], int brightnessShifts);
+
         void loadPixelToDrawBuffer(int16_t hwx, int16_t hwy, const RGB& color);
         const RGB readPixelFromDrawBuffer(int16_t hwx, int16_t hwy);
         void getBackgroundRefreshPixel(uint16_t x, uint16_t y, RGB &refreshPixel);
@@ -119,6 +130,17 @@ class SMLayerBackground : public SM_Layer {
         volatile unsigned char currentRefreshBuffer;
         volatile bool swapPending;
         void handleBufferSwap(void);
+
+        // keeping track of changed rows, one bit per hardware row
+        // divergentRows: rows where the drawing buffer may differ from the refresh buffer
+        // changedRows: rows of the refresh buffer changed on this frame
+        uint32_t *divergentRows = NULL;
+        uint32_t *changedRows = NULL;
+        bool allRowsChanged = true;
+        uint8_t refreshedBrightness = 0;
+        bool refreshedCcEnabled = false;
+        int getRowBitmapSize(void) const { return sizeof(uint32_t) * ((this->matrixHeight + 31) / 32); };
+        void markAllRowsDivergent(void);
 };
 
 #include "Layer_Background_Impl.h"
@@ -472,10 +472,14 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::setRotation(rotationDegrees newrota
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackgroundGFX<RGB, optionFlags>::drawChar(int16_t x, int16_t y, const RGB& charColor, char character) {
     int xcnt, ycnt;
+    const unsigned char *glyph = getBitmapFontGlyph(character, font);
+
+    if (!glyph)
+        return;
 
     for (ycnt = 0; ycnt < font->Height; ycnt++) {
         for (xcnt = 0; xcnt < font->Width; xcnt++) {
-            if (getBitmapFontPixelAtXY(character, xcnt, ycnt, font)) {
+            if (glyph[ycnt] & (0x80 >> xcnt)) {
                 drawPixel(x + xcnt, y + ycnt, charColor);
             }
         }
@@ -488,9 +492,13 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawString(int16_t x, int16_t y, co
     char character;
 
     while ((character = text[offset++]) != '\0') {
+        const unsigned char *glyph = getBitmapFontGlyph(character, font);
+
         for (ycnt = 0; ycnt < font->Height; ycnt++) {
+            uint8_t row = glyph ? glyph[ycnt] : 0x00;
+
             for (xcnt = 0; xcnt < font->Width; xcnt++) {
-                if (getBitmapFontPixelAtXY(character, xcnt, ycnt, font)) {
+                if (row & (0x80 >> xcnt)) {
                     drawPixel(x + xcnt, y + ycnt, charColor);
                 }
             }
@@ -506,9 +514,13 @@ void SMLayerBackgroundGFX<RGB, optionFlags>::drawString(int16_t x, int16_t y, co
     char character;
 
     while ((character = text[offset++]) != '\0') {
+        const unsigned char *glyph = getBitmapFontGlyph(character, font);
+
         for (ycnt = 0; ycnt < font->Height; ycnt++) {
+            uint8_t row = glyph ? glyph[ycnt] : 0x00;
+
             for (xcnt = 0; xcnt < font->Width; xcnt++) {
-                if (getBitmapFontPixelAtXY(character, xcnt, ycnt, font)) {
+                if (row & (0x80 >> xcnt)) {
                     drawPixel(x + xcnt, y + ycnt, charColor);
                 } else {
                     drawPixel(x + xcnt, y + ycnt, backColor);
@@ -23,6 +23,8 @@
 
 #include <stdlib.h>     
 
+#define INLINE __attribute__( ( always_inline ) ) inline
+
 // call when backgroundBuffers and backgroundColorCorrectionLUT buffer is allocated outside of class
 template <typename RGB, unsigned int optionFlags>
 SMLayerBackground<RGB, optionFlags>::SMLayerBackground(RGB * buffer, uint16_t width, uint16_t height, color_chan_t * colorCorrectionLUT) {
@@ -74,12 +76,32 @@ void SMLayerBackground<RGB, optionFlags>::begin(void) {
 
     currentDrawBufferPtr = backgroundBuffers[0];
     currentRefreshBufferPtr = backgroundBuffers[1];
+
+    if(!divergentRows && !changedRows) {
+        divergentRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(divergentRows != NULL);
+        changedRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(changedRows != NULL);
+    }
+    memset(divergentRows, 0x00, getRowBitmapSize());
+    memset(changedRows, 0x00, getRowBitmapSize());
 }
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::frameRefreshCallback(void) {
+    // rows changed on the previous frame are already in the refresh buffers
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = false;
+
     handleBufferSwap();
 
+    // the LUT changes every row
+    if(backgroundBrightness != refreshedBrightness || this->ccEnabled != refreshedCcEnabled) {
+        refreshedBrightness = backgroundBrightness;
+        refreshedCcEnabled = this->ccEnabled;
+        allRowsChanged = true;
+    }
+
     if(sizeof(RGB) > 3)
         calculate12BitBackgroundLUT(backgroundColorCorrectionLUT, backgroundBrightness);
     else
@@ -96,102 +118,146 @@ bool SMLayerBackground<RGB, optionFlags>::isLayerChanged() {
     return swapPending;
 }
 
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerBackground<RGB, optionFlags>::isRowChanged(uint16_t hardwareY) {
+    return allRowsChanged || this->getRowBit(changedRows, hardwareY);
+}
+
 // numShifts must be in range of 0-4, otherwise 16-bit to 12-bit conversion code breaks (would be an easy fix, but 4 is enough for APA102 GBC application)
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::setBrightnessShifts(int numShifts) {
     pendingIdealBrightnessShifts = numShifts;
 }
 
+// numShifts is the brightness shift known at compile time, or -1 to use brightnessShifts
 template <typename RGB, unsigned int optionFlags>
-void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
-    RGB currentPixel;
-    int i;
-
-    RGB *ptr = currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+template <bool colorCorrection, int numShifts>
+INLINE void SMLayerBackground<RGB, optionFlags>::loadRefreshPixel(const RGB &currentPixel, rgb48 &refreshPixel, int brightnessShifts) {
+    const int shifts = (numShifts < 0) ? brightnessShifts : numShifts;
+
+    if(colorCorrection) {
+        // load background pixel with color correction
+        if(sizeof(RGB) <= 3) {
+            // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
+            refreshPixel = rgb48(backgroundColorCorrectionLUT[currentPixel.red << shifts],
+                backgroundColorCorrectionLUT[currentPixel.green << shifts],
+                backgroundColorCorrectionLUT[currentPixel.blue << shifts]);
+        } else {
+            // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
+            refreshPixel = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - shifts)],
+                backgroundColorCorrectionLUT[currentPixel.green >> (4 - shifts)],
+                backgroundColorCorrectionLUT[currentPixel.blue >> (4 - shifts)]);
+        }
+    } else {
+        // load background pixel without color correction
+        if(sizeof(RGB) <= 3) {
+            // 24-bit source (8 bits per color channel): shift to fit in 16-bit color channel
+            refreshPixel = rgb48(currentPixel.red << (shifts + 8),
+                currentPixel.green << (shifts + 8),
+                currentPixel.blue << (shifts + 8));
+        } else {
+            // 48-bit source (16 bits per color channel): no shifting needed to fit in 16-bit color channel
+            refreshPixel = rgb48(currentPixel.red << shifts,
+                currentPixel.green << shifts,
+                currentPixel.blue << shifts);
+        }
+    }
+}
 
-    if(this->ccEnabled) {
-        for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
-            // load background pixel with color correction
-            if(sizeof(RGB) <= 3) {
-                // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.green << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
-            } else {
-                // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
-            }
+template <typename RGB, unsigned int optionFlags>
+template <bool colorCorrection, int numShifts>
+INLINE void SMLayerBackground<RGB, optionFlags>::loadRefreshPixel(const RGB &currentPixel, rgb24 &refreshPixel, int brightnessShifts) {
+    const int shifts = (numShifts < 0) ? brightnessShifts : numShifts;
+
+    if(colorCorrection) {
+        // load background pixel with color correction
+        if(sizeof(RGB) <= 3) {
+            // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
+            refreshPixel = rgb48(backgroundColorCorrectionLUT[currentPixel.red << shifts],
+                backgroundColorCorrectionLUT[currentPixel.green << shifts],
+                backgroundColorCorrectionLUT[currentPixel.blue << shifts]);
+        } else {
+            // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
+            refreshPixel = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - shifts)],
+                backgroundColorCorrectionLUT[currentPixel.green >> (4 - shifts)],
+                backgroundColorCorrectionLUT[currentPixel.blue >> (4 - shifts)]);
         }
     } else {
-        for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
-            // load background pixel without color correction
-            if(sizeof(RGB) <= 3) {
-                // 24-bit source (8 bits per color channel): shift to fit in 16-bit color channel
-                refreshRow[i] = rgb48(currentPixel.red << (brightnessShifts + 8),
-                    currentPixel.green << (brightnessShifts + 8),
-                    currentPixel.blue << (brightnessShifts + 8));
-            } else {
-                // 48-bit source (16 bits per color channel): no shifting needed to fit in 16-bit color channel
-                refreshRow[i] = rgb48(currentPixel.red << brightnessShifts,
-                    currentPixel.green << brightnessShifts,
-                    currentPixel.blue << brightnessShifts);                
-            }
+        // load background pixel without color correction
+        if(sizeof(RGB) <= 3) {
+            refreshPixel = rgb24(currentPixel.red << shifts,
+                currentPixel.green << shifts,
+                currentPixel.blue << shifts);
+        } else {
+            refreshPixel = rgb48(currentPixel.red << shifts,
+                currentPixel.green << shifts,
+                currentPixel.blue << shifts);
         }
     }
 }
 
+// converts a row with the branches on color correction and brightness shifts resolved at compile time, four pixels per iteration
 template <typename RGB, unsigned int optionFlags>
-void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts) {
-    RGB currentPixel;
+template <bool colorCorrection, int numShifts, typename RGB_OUT>
+INLINE void SMLayerBackground<RGB, optionFlags>::loadRefreshRow(const RGB *ptr, RGB_OUT refreshRow[], int brightnessShifts) {
     int i;
 
-    RGB *ptr = currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+    for(i=0; i + 4 <= this->matrixWidth; i += 4) {
+        const RGB pixel0 = ptr[i];
+        const RGB pixel1 = ptr[i+1];
+        const RGB pixel2 = ptr[i+2];
+        const RGB pixel3 = ptr[i+3];
+        loadRefreshPixel<colorCorrection, numShifts>(pixel0, refreshRow[i], brightnessShifts);
+        loadRefreshPixel<colorCorrection, numShifts>(pixel1, refreshRow[i+1], brightnessShifts);
+        loadRefreshPixel<colorCorrection, numShifts>(pixel2, refreshRow[i+2], brightnessShifts);
+        loadRefreshPixel<colorCorrection, numShifts>(pixel3, refreshRow[i+3], brightnessShifts);
+    }
 
-    if(this->ccEnabled) {
-        for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
-            // load background pixel with color correction
-            if(sizeof(RGB) <= 3) {
-                // 24-bit source (8 bits per color channel): backgroundColorCorrectionLUT expects 8-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.green << brightnessShifts],
-                    backgroundColorCorrectionLUT[currentPixel.blue << brightnessShifts]);                
-            } else {
-                // 48-bit source (16 bits per color channel): backgroundColorCorrectionLUT expects 12-bit value, returns 16-bit value
-                refreshRow[i] = rgb48(backgroundColorCorrectionLUT[currentPixel.red >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.green >> (4 - brightnessShifts)],
-                    backgroundColorCorrectionLUT[currentPixel.blue >> (4 - brightnessShifts)]);
-            }
-        }
-    } else {
-        for(i=0; i<this->matrixWidth; i++) {
-            currentPixel = *ptr++;
-            // load background pixel without color correction
-            if(sizeof(RGB) <= 3) {
-                refreshRow[i] = rgb24(currentPixel.red << brightnessShifts,
-                    currentPixel.green << brightnessShifts,
-                    currentPixel.blue << brightnessShifts);
-            } else {
-                refreshRow[i] = rgb48(currentPixel.red << brightnessShifts,
-                    currentPixel.green << brightnessShifts,
-                    currentPixel.blue << brightnessShifts);
-            }
-        }
+    for(; i<this->matrixWidth; i++)
+        loadRefreshPixel<colorCorrection, numShifts>(ptr[i], refreshRow[i], brightnessShifts);
+}
+
+// brightnessShifts is normally in range of 0-4 (see setBrightnessShifts()), other values use a runtime shift
+template <typename RGB, unsigned int optionFlags>
+template <bool colorCorrection, typename RGB_OUT>
+INLINE void SMLayerBackground<RGB, optionFlags>::loadRefreshRow(const RGB *ptr, RGB_OUT refreshRow[], int brightnessShifts) {
+    switch(brightnessShifts) {
+        case 0: loadRefreshRow<colorCorrection, 0>(ptr, refreshRow, brightnessShifts); break;
+        case 1: loadRefreshRow<colorCorrection, 1>(ptr, refreshRow, brightnessShifts); break;
+        case 2: loadRefreshRow<colorCorrection, 2>(ptr, refreshRow, brightnessShifts); break;
+        case 3: loadRefreshRow<colorCorrection, 3>(ptr, refreshRow, brightnessShifts); break;
+        case 4: loadRefreshRow<colorCorrection, 4>(ptr, refreshRow, brightnessShifts); break;
+        default: loadRefreshRow<colorCorrection, -1>(ptr, refreshRow, brightnessShifts); break;
     }
 }
 
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
+    RGB *ptr = currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+
+    if(this->ccEnabled)
+        loadRefreshRow<true>(ptr, refreshRow, brightnessShifts);
+    else
+        loadRefreshRow<false>(ptr, refreshRow, brightnessShifts);
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts) {
+    RGB *ptr = currentRefreshBufferPtr + (hardwareY * this->matrixWidth);
+
+    if(this->ccEnabled)
+        loadRefreshRow<true>(ptr, refreshRow, brightnessShifts);
+    else
+        loadRefreshRow<false>(ptr, refreshRow, brightnessShifts);
+}
+
 extern volatile int totalFramesToInterpolate;
 extern volatile int framesInterpolated;
 
-#define INLINE __attribute__( ( always_inline ) ) inline
-
 template <typename RGB, unsigned int optionFlags>
 INLINE void SMLayerBackground<RGB, optionFlags>::loadPixelToDrawBuffer(int16_t hwx, int16_t hwy, const RGB& color) {
     currentDrawBufferPtr[(hwy * this->matrixWidth) + hwx] = color;
+    divergentRows[hwy / 32] |= (uint32_t)1 << (hwy % 32);
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -872,10 +938,14 @@ void SMLayerBackground<RGB, optionFlags>::setFont(fontChoices newFont) {
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::drawChar(int16_t x, int16_t y, const RGB& charColor, char character) {
     int xcnt, ycnt;
+    const unsigned char *glyph = getBitmapFontGlyph(character, font);
+
+    if (!glyph)
+        return;
 
     for (ycnt = 0; ycnt < font->Height; ycnt++) {
         for (xcnt = 0; xcnt < font->Width; xcnt++) {
-            if (getBitmapFontPixelAtXY(character, xcnt, ycnt, font)) {
+            if (glyph[ycnt] & (0x80 >> xcnt)) {
                 drawPixel(x + xcnt, y + ycnt, charColor);
             }
         }
@@ -888,9 +958,13 @@ void SMLayerBackground<RGB, optionFlags>::drawString(int16_t x, int16_t y, const
     char character;
 
     while ((character = text[offset++]) != '\0') {
+        const unsigned char *glyph = getBitmapFontGlyph(character, font);
+
         for (ycnt = 0; ycnt < font->Height; ycnt++) {
+            uint8_t row = glyph ? glyph[ycnt] : 0x00;
+
             for (xcnt = 0; xcnt < font->Width; xcnt++) {
-                if (getBitmapFontPixelAtXY(character, xcnt, ycnt, font)) {
+                if (row & (0x80 >> xcnt)) {
                     drawPixel(x + xcnt, y + ycnt, charColor);
                 }
             }
@@ -906,9 +980,13 @@ void SMLayerBackground<RGB, optionFlags>::drawString(int16_t x, int16_t y, const
     char character;
 
     while ((character = text[offset++]) != '\0') {
+        const unsigned char *glyph = getBitmapFontGlyph(character, font);
+
         for (ycnt = 0; ycnt < font->Height; ycnt++) {
+            uint8_t row = glyph ? glyph[ycnt] : 0x00;
+
             for (xcnt = 0; xcnt < font->Width; xcnt++) {
-                if (getBitmapFontPixelAtXY(character, xcnt, ycnt, font)) {
+                if (row & (0x80 >> xcnt)) {
                     drawPixel(x + xcnt, y + ycnt, charColor);
                 } else {
                     drawPixel(x + xcnt, y + ycnt, backColor);
@@ -943,6 +1021,9 @@ void SMLayerBackground<RGB, optionFlags>::handleBufferSwap(void) {
     if (!swapPending)
         return;
 
+    // the new refresh buffer differs from the old one where the buffers diverged, swapping doesn't change where they diverge
+    memcpy(changedRows, divergentRows, getRowBitmapSize());
+
     unsigned char newDrawBuffer = currentRefreshBuffer;
 
     currentRefreshBuffer = currentDrawBuffer;
@@ -981,25 +1062,35 @@ void SMLayerBackground<RGB, optionFlags>::swapBuffers(bool copy) {
         //if(currentDrawBuffer != currentRefreshBuffer)     
         //   memcpy(backgroundBuffers[currentDrawBuffer], backgroundBuffers[currentRefreshBuffer], sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
 #endif
+        memset(divergentRows, 0x00, getRowBitmapSize());
     }
 }
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::copyRefreshToDrawing() {
     memcpy(currentDrawBufferPtr, currentRefreshBufferPtr, sizeof(RGB) * (this->matrixWidth * this->matrixHeight));
+    memset(divergentRows, 0x00, getRowBitmapSize());
 }
 
 // return pointer to start of currentDrawBuffer, so application can do efficient loading of bitmaps
 template <typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackground<RGB, optionFlags>::backBuffer(void) {
+    // the application can write anywhere in the buffer
+    markAllRowsDivergent();
     return currentDrawBufferPtr;
 }
 
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::setBackBuffer(RGB *newBuffer) {
+  markAllRowsDivergent();
   currentDrawBufferPtr = newBuffer;
 }
 
+template<typename RGB, unsigned int optionFlags>
+void SMLayerBackground<RGB, optionFlags>::markAllRowsDivergent(void) {
+  memset(divergentRows, 0xff, getRowBitmapSize());
+}
+
 template<typename RGB, unsigned int optionFlags>
 void SMLayerBackground<RGB, optionFlags>::setBrightness(uint8_t brightness) {
     backgroundBrightness = brightness;
@@ -1039,6 +1130,7 @@ const RGB SMLayerBackground<RGB, optionFlags>::readPixel(int16_t x, int16_t y) {
 
 template<typename RGB, unsigned int optionFlags>
 RGB *SMLayerBackground<RGB, optionFlags>::getRealBackBuffer() {
+  markAllRowsDivergent();
   return backgroundBuffers[currentDrawBuffer];
 }
 
@@ -43,6 +43,7 @@ class SMLayerGFXMono : public SM_Layer, public Adafruit_GFX {
         void frameRefreshCallback();
         void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        bool isRowChanged(uint16_t hardwareY);
 
         // could make this generic if moving the buffer copy code to a new function
         void swapBuffers(bool copy = true);
@@ -152,6 +153,19 @@ class SMLayerGFXMono : public SM_Layer, public Adafruit_GFX {
         volatile unsigned char currentDrawBuffer;
         volatile unsigned char currentRefreshBuffer;
         volatile bool swapPending;
+
+        // keeping track of changed rows
+        // divergentRowMin..Max: rows of the layer buffer where the drawing buffer may differ from the refresh buffer, none if Min > Max
+        // changedRows: hardware rows changed on this frame, one bit per row
+        int16_t divergentRowMin = INT16_MAX;
+        int16_t divergentRowMax = -1;
+        uint32_t *changedRows = NULL;
+        bool allRowsChanged = true;
+        bool refreshedCcEnabled = true;
+        volatile bool colorChange = false;
+        volatile bool layerChange = false;
+        int getRowBitmapSize(void) const { return sizeof(uint32_t) * ((this->matrixHeight + 31) / 32); };
+        void markChangedRows(int16_t layerY0, int16_t layerY1);
 };
 
 #include "Layer_Gfx_Mono_Impl.h"
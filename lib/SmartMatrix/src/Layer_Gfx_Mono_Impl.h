@@ -62,6 +62,13 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::begin(void) {
     currentDrawBuffer = 0;
     currentRefreshBuffer = 1;
     swapPending = false;
+
+    if(!changedRows) {
+        changedRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(changedRows != NULL);
+    }
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = true;
 }
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
@@ -79,8 +86,48 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::handleBufferSwap(void) {
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
 void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::frameRefreshCallback(void) {
+    int16_t refreshedXOffset = layerXOffset;
+    int16_t refreshedYOffset = layerYOffset;
+
+    // rows changed on the previous frame are already in the refresh buffers
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = false;
+
     updateScrollingText();
+
+    // the new refresh buffer differs from the old one where the buffers diverged
+    if(swapPending && divergentRowMin <= divergentRowMax)
+        markChangedRows(divergentRowMin, divergentRowMax);
     handleBufferSwap();
+
+    // moving the layer changes the rows it covered and the rows it covers now
+    if(layerXOffset != refreshedXOffset || layerYOffset != refreshedYOffset) {
+        markChangedRows(refreshedYOffset - layerYOffset, refreshedYOffset - layerYOffset + this->layerHeight - 1);
+        markChangedRows(0, this->layerHeight - 1);
+    }
+
+    // the colors are applied to every row while refreshing, and a resize changes the layer everywhere
+    if(colorChange || layerChange || this->ccEnabled != refreshedCcEnabled) {
+        colorChange = false;
+        layerChange = false;
+        refreshedCcEnabled = this->ccEnabled;
+        allRowsChanged = true;
+    }
+}
+
+template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
+bool SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::isRowChanged(uint16_t hardwareY) {
+    return allRowsChanged || this->getRowBit(changedRows, hardwareY);
+}
+
+// layerY0..layerY1 are rows of the layer buffer, shown at hardware rows offset by layerYOffset
+template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
+void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::markChangedRows(int16_t layerY0, int16_t layerY1) {
+    int16_t hardwareY0 = max((int)0, layerY0 + layerYOffset);
+    int16_t hardwareY1 = min((int)this->matrixHeight - 1, layerY1 + layerYOffset);
+
+    if(hardwareY0 <= hardwareY1)
+        this->setRowBits(changedRows, hardwareY0, hardwareY1);
 }
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags> template <typename RGB_OUT>
@@ -192,6 +239,8 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::swapBuffers(bool copy) {
             memcpy(&indexedBitmap[RGB1_BUFFER_SIZE], &indexedBitmap[0], RGB1_BUFFER_SIZE);
         else
             memcpy(&indexedBitmap[0], &indexedBitmap[RGB1_BUFFER_SIZE], RGB1_BUFFER_SIZE);
+        divergentRowMin = INT16_MAX;
+        divergentRowMax = -1;
 #else
         // below is untested after copying from backgroundLayer to indexedLayer:
 
@@ -211,6 +260,7 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::swapBuffers(bool copy) {
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
 void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::setIndexedColor(uint8_t index, const RGB_API & newColor) {
     indexedColor[index % 2] = newColor;
+    colorChange = true;
 }
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
@@ -264,6 +314,11 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::drawPixel(int16_t x, int
         hwy = (this->layerHeight - 1) - x;
     }
 
+    if(hwy < divergentRowMin)
+        divergentRowMin = hwy;
+    if(hwy > divergentRowMax)
+        divergentRowMax = hwy;
+
     if(index) {
         tempBitmask = 0x80 >> (hwx%8);
         indexedBitmap[currentDrawBuffer*RGB1_BUFFER_SIZE + (hwy * RGB1_BUFFER_HARDWARE_ROW_SIZE) + (hwx/8)] |= tempBitmask;
@@ -282,6 +337,8 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::fillScreen(const rgb1 in
         fillValue = 0x00;
 
     memset(&indexedBitmap[currentDrawBuffer*RGB1_BUFFER_SIZE], fillValue, RGB1_BUFFER_SIZE);
+    divergentRowMin = 0;
+    divergentRowMax = this->layerHeight - 1;
 }
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
@@ -322,6 +379,7 @@ int SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::resizeLayer(uint16_t widt
 
     // this will take care of applying changes to Adafruit_GFX _width/_height, and localWidth/Height
     setRotation(this->layerRotation);
+    layerChange = true;
 
     if(resizeWasTooBig)
         return -1;
@@ -561,6 +619,9 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::getDimensionsOfPrintedSt
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
 void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::clearRefreshAndDrawingBuffers() {
     memset(indexedBitmap, 0x00, RGB1_BUFFER_SIZE*2);
+    divergentRowMin = INT16_MAX;
+    divergentRowMax = -1;
+    layerChange = true;
 }
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
@@ -678,6 +739,7 @@ void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::setStartOffsetFromLeft(i
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
 void SMLayerGFXMono<RGB_API, RGB_STORAGE, optionFlags>::setColor(const RGB_API & newColor) {
     indexedColor[1] = newColor;
+    colorChange = true;
 }
 
 template <typename RGB_API, typename RGB_STORAGE, unsigned int optionFlags>
@@ -41,6 +41,8 @@ class SMLayerIndexed : public SM_Layer {
         void frameRefreshCallback();
         void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        void setRotation(rotationDegrees newrotation);
+        bool isRowChanged(uint16_t hardwareY);
 
         void enableColorCorrection(bool enabled);
 
@@ -94,6 +96,19 @@ class SMLayerIndexed : public SM_Layer {
         volatile bool swapPending;
         void handleBufferSwap(void);
 
+        // keeping track of changed rows, one bit per hardware row
+        // divergentRows: rows where the drawing buffer may differ from the refresh buffer
+        // changedRows: rows of the refresh buffer changed on this frame
+        uint32_t *divergentRows = NULL;
+        uint32_t *changedRows = NULL;
+        bool allRowsChanged = true;
+        bool refreshedCcEnabled = false;
+        rotationDegrees refreshedRotation = rotation0;
+        volatile bool colorChange = false;
+        int getRowBitmapSize(void) const { return sizeof(uint32_t) * ((this->matrixHeight + 31) / 32); };
+        void markRowsDivergent(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+        void markAllRowsDivergent(void);
+
         bitmap_font *layerFont = (bitmap_font *) &apple3x5;
 };
 
@@ -55,11 +55,60 @@ void SMLayerIndexed<RGB, optionFlags>::begin(void) {
     currentDrawBuffer = 0;
     currentRefreshBuffer = 1;
     swapPending = false;
+
+    if(!divergentRows && !changedRows) {
+        divergentRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(divergentRows != NULL);
+        changedRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(changedRows != NULL);
+    }
+    memset(divergentRows, 0x00, getRowBitmapSize());
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = true;
 }
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerIndexed<RGB, optionFlags>::frameRefreshCallback(void) {
+    // rows changed on the previous frame are already in the refresh buffers
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = false;
+
     handleBufferSwap();
+
+    // the color and rotation are applied to every row while refreshing
+    if(colorChange || this->ccEnabled != refreshedCcEnabled || this->layerRotation != refreshedRotation) {
+        colorChange = false;
+        refreshedCcEnabled = this->ccEnabled;
+        refreshedRotation = this->layerRotation;
+        allRowsChanged = true;
+    }
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerIndexed<RGB, optionFlags>::setRotation(rotationDegrees newrotation) {
+    SM_Layer::setRotation(newrotation);
+    // rows marked so far were mapped with the old rotation, the buffers may differ anywhere on the new one
+    markAllRowsDivergent();
+}
+
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerIndexed<RGB, optionFlags>::isRowChanged(uint16_t hardwareY) {
+    return allRowsChanged || this->getRowBit(changedRows, hardwareY);
+}
+
+// x0..x1, y0..y1 are local screen coordinates
+template <typename RGB, unsigned int optionFlags>
+void SMLayerIndexed<RGB, optionFlags>::markRowsDivergent(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    int16_t hardwareY0, hardwareY1;
+
+    if(this->getHardwareRows(x0, y0, x1, y1, hardwareY0, hardwareY1))
+        this->setRowBits(divergentRows, hardwareY0, hardwareY1);
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerIndexed<RGB, optionFlags>::markAllRowsDivergent(void) {
+    if(divergentRows)
+        memset(divergentRows, 0xff, getRowBitmapSize());
 }
 
 // returns true and copies color to xyPixel if pixel is opaque, returns false if not
@@ -149,6 +198,7 @@ void SMLayerIndexed<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb24
 template<typename RGB, unsigned int optionFlags>
 void SMLayerIndexed<RGB, optionFlags>::setIndexedColor(uint8_t index, const RGB & newColor) {
     color = newColor;
+    colorChange = true;
 }
 
 template<typename RGB, unsigned int optionFlags>
@@ -165,6 +215,7 @@ void SMLayerIndexed<RGB, optionFlags>::fillScreen(uint8_t index) {
         fillValue = 0x00;
 
     memset(&indexedBitmap[currentDrawBuffer*INDEXED_BUFFER_SIZE], fillValue, INDEXED_BUFFER_SIZE);
+    markAllRowsDivergent();
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -182,6 +233,7 @@ void SMLayerIndexed<RGB, optionFlags>::swapBuffers(bool copy) {
             memcpy(&indexedBitmap[INDEXED_BUFFER_SIZE], &indexedBitmap[0], INDEXED_BUFFER_SIZE);
         else
             memcpy(&indexedBitmap[0], &indexedBitmap[INDEXED_BUFFER_SIZE], INDEXED_BUFFER_SIZE);
+        memset(divergentRows, 0x00, getRowBitmapSize());
 #else
         // below is untested after copying from backgroundLayer to indexedLayer:
 
@@ -203,6 +255,9 @@ void SMLayerIndexed<RGB, optionFlags>::handleBufferSwap(void) {
     if (!swapPending)
         return;
 
+    // the new refresh buffer differs from the old one where the buffers diverged, swapping doesn't change where they diverge
+    memcpy(changedRows, divergentRows, getRowBitmapSize());
+
     unsigned char newDrawBuffer = currentRefreshBuffer;
 
     currentRefreshBuffer = currentDrawBuffer;
@@ -218,6 +273,8 @@ void SMLayerIndexed<RGB, optionFlags>::drawPixel(int16_t x, int16_t y, uint8_t i
     if(x < 0 || x >= this->localWidth || y < 0 || y >= this->localHeight)
         return;
 
+    markRowsDivergent(x, y, x, y);
+
     if(index) {
         tempBitmask = 0x80 >> (x%8);
         indexedBitmap[currentDrawBuffer*INDEXED_BUFFER_SIZE + (y * INDEXED_BUFFER_ROW_SIZE) + (x/8)] |= tempBitmask;
@@ -237,18 +294,26 @@ template <typename RGB, unsigned int optionFlags>
 void SMLayerIndexed<RGB, optionFlags>::drawChar(int16_t x, int16_t y, uint8_t index, char character) {
     uint8_t tempBitmask;
     int k;
+    const unsigned char *glyph;
 
     // only draw if character is on the screen
     if (x + scrollFont->Width < 0 || x >= this->localWidth) {
         return;
     }
 
+    glyph = getBitmapFontGlyph(character, layerFont);
+    if (!glyph)
+        return;
+
+    // the glyph's rows are written 8 pixels wide
+    markRowsDivergent(x, y, x + 7, y + layerFont->Height - 1);
+
     for (k = y; k < y+layerFont->Height; k++) {
         // ignore rows that are not on the screen
         if(k < 0) continue;
         if (k >= this->localHeight) return;
 
-        tempBitmask = getBitmapFontRowAtXY(character, k - y, layerFont);
+        tempBitmask = glyph[k - y];
         if (x < 0) {
             indexedBitmap[currentDrawBuffer*INDEXED_BUFFER_SIZE + (k * INDEXED_BUFFER_ROW_SIZE) + 0] |= tempBitmask << -x;
         } else {
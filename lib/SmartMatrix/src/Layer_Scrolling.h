@@ -29,6 +29,8 @@
 
 // scroll text
 const int textLayerMaxStringLength = 100;
+// tallest font the scrolling text is rendered with, rows below are blank
+const int textLayerMaxFontHeight = 16;
 
 #define SM_SCROLLING_OPTIONS_NONE     0
 
@@ -44,6 +46,8 @@ class SMLayerScrolling : public SM_Layer {
         void frameRefreshCallback();
         void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
         void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        // only rows written by the scrolling text are tracked, not direct writes to scrollingBitmap
+        bool isRowChanged(uint16_t hardwareY);
 
         void setRefreshRate(uint8_t newRefreshRate);
 
@@ -64,6 +68,8 @@ class SMLayerScrolling : public SM_Layer {
 
     private:
         void redrawScrollingText(void);
+        void renderScrollingStrip(void);
+        uint8_t getScrollingStripByte(int stripRow, int stripX);
         void setMinMax(void);
 
         void updateScrollingText(void);
@@ -93,6 +99,18 @@ class SMLayerScrolling : public SM_Layer {
         unsigned int textWidth;
         int scrollMin, scrollMax;
         int scrollPosition;
+
+        // the whole text rendered once with one bit per pixel, 8 pixels per character plus one byte for the last character
+        uint8_t scrollingStrip[textLayerMaxFontHeight * (textLayerMaxStringLength + 1)];
+        volatile bool stripChange = true;
+
+        // hardware rows of scrollingBitmap written on this frame, one bit per row
+        uint32_t *changedRows = NULL;
+        bool allRowsChanged = true;
+        bool refreshedCcEnabled = false;
+        rotationDegrees refreshedRotation = rotation0;
+        volatile bool colorChange = false;
+        int getRowBitmapSize(void) const { return sizeof(uint32_t) * ((this->matrixHeight + 31) / 32); };
 };
 
 #include "Layer_Scrolling_Impl.h"
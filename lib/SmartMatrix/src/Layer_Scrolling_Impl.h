@@ -25,6 +25,7 @@
 
 #define SCROLLING_BUFFER_ROW_SIZE   (this->localWidth / 8)
 #define SCROLLING_BUFFER_SIZE       (SCROLLING_BUFFER_ROW_SIZE * this->localHeight)
+#define SCROLLING_STRIP_ROW_SIZE    (textLayerMaxStringLength + 1)
 
 template <typename RGB, unsigned int optionFlags>
 SMLayerScrolling<RGB, optionFlags>::SMLayerScrolling(uint8_t * bitmap, uint16_t width, uint16_t height) {
@@ -50,11 +51,33 @@ SMLayerScrolling<RGB, optionFlags>::SMLayerScrolling(uint16_t width, uint16_t he
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::begin(void) {
+    if(!changedRows) {
+        changedRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(changedRows != NULL);
+    }
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = true;
 }
 
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::frameRefreshCallback(void) {
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = false;
+
     updateScrollingText();
+
+    // the color and rotation are applied to every row while refreshing
+    if(colorChange || this->ccEnabled != refreshedCcEnabled || this->layerRotation != refreshedRotation) {
+        colorChange = false;
+        refreshedCcEnabled = this->ccEnabled;
+        refreshedRotation = this->layerRotation;
+        allRowsChanged = true;
+    }
+}
+
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerScrolling<RGB, optionFlags>::isRowChanged(uint16_t hardwareY) {
+    return allRowsChanged || this->getRowBit(changedRows, hardwareY);
 }
 
 // returns true and copies color to xyPixel if pixel is opaque, returns false if not
@@ -170,6 +193,7 @@ void SMLayerScrolling<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb2
 template<typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::setColor(const RGB & newColor) {
     textcolor = newColor;
+    colorChange = true;
 }
 
 template<typename RGB, unsigned int optionFlags>
@@ -234,6 +258,7 @@ void SMLayerScrolling<RGB, optionFlags>::start(const char inputtext[], int numSc
     scrollcounter = numScrolls;
 
     textWidth = (textlen * scrollFont->Width) - 1;
+    stripChange = true;
 
     setMinMax();
  }
@@ -248,16 +273,14 @@ void SMLayerScrolling<RGB, optionFlags>::update(const char inputtext[]){
     strncpy(text, (const char *)inputtext, length);
     textlen = length;
     textWidth = (textlen * scrollFont->Width) - 1;
+    stripChange = true;
 
     setMinMax();
 }
 
 // called once per frame to update (virtual) bitmap
-// function needs major efficiency improvments
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::updateScrollingText(void) {
-    bool resetScrolls = false;
-
     // return if not ready to update
     if (!scrollcounter || ++currentframe <= framesperscroll)
         return;
@@ -293,21 +316,11 @@ void SMLayerScrolling<RGB, optionFlags>::updateScrollingText(void) {
     default:
     case stopped:
         scrollPosition = fontLeftOffset;
-        resetScrolls = true;
         break;
     }
 
-    // done scrolling - move text off screen and disable
-    if (!scrollcounter) {
-        resetScrolls = true;
-    }
-
-    // for now, fill the bitmap fresh with each update
-    // TODO: reset only when necessary, and update just the pixels that need it
-    resetScrolls = true;
-    if (resetScrolls) {
-        redrawScrollingText();
-    }
+    // the position changed, copy the new window of the text strip
+    redrawScrollingText();
 }
 
 // TODO: recompute stuff after changing mode, font, etc
@@ -331,6 +344,7 @@ void SMLayerScrolling<RGB, optionFlags>::setSpeed(unsigned char pixels_per_secon
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::setFont(fontChoices newFont) {
     scrollFont = fontLookup(newFont);
+    stripChange = true;
 }
 
 template <typename RGB, unsigned int optionFlags>
@@ -344,12 +358,59 @@ void SMLayerScrolling<RGB, optionFlags>::setStartOffsetFromLeft(int offset) {
     fontLeftOffset = offset;
 }
 
+// renders the whole text once, scrolling copies a window of the strip to scrollingBitmap
+template <typename RGB, unsigned int optionFlags>
+void SMLayerScrolling<RGB, optionFlags>::renderScrollingStrip(void) {
+    int i, k, x;
+    const unsigned char *glyph;
+
+    stripChange = false;
+    memset(scrollingStrip, 0x00, sizeof(scrollingStrip));
+
+    for (i = 0; i < textlen; i++) {
+        glyph = getBitmapFontGlyph(text[i], scrollFont);
+        if (!glyph)
+            continue;
+
+        x = i * scrollFont->Width;
+        for (k = 0; k < scrollFont->Height && k < textLayerMaxFontHeight; k++) {
+            scrollingStrip[(k * SCROLLING_STRIP_ROW_SIZE) + (x/8)] |= glyph[k] >> (x%8);
+            if (x % 8)
+                scrollingStrip[(k * SCROLLING_STRIP_ROW_SIZE) + (x/8) + 1] |= glyph[k] << (8-(x%8));
+        }
+    }
+}
+
+// returns the 8 pixels of the strip row starting at stripX, pixels outside of the strip are clear
+template <typename RGB, unsigned int optionFlags>
+uint8_t SMLayerScrolling<RGB, optionFlags>::getScrollingStripByte(int stripRow, int stripX) {
+    const int stripWidth = SCROLLING_STRIP_ROW_SIZE * 8;
+    uint8_t bitmask = 0x00;
+
+    if (stripRow >= textLayerMaxFontHeight || stripX <= -8 || stripX >= stripWidth)
+        return 0x00;
+
+    const uint8_t * row = &scrollingStrip[stripRow * SCROLLING_STRIP_ROW_SIZE];
+    int shift = ((stripX % 8) + 8) % 8;
+    int index = (stripX - shift) / 8;
+
+    if (index >= 0)
+        bitmask |= row[index] << shift;
+    if (shift && index + 1 < SCROLLING_STRIP_ROW_SIZE)
+        bitmask |= row[index + 1] >> (8 - shift);
+
+    return bitmask;
+}
+
 // if font size or position changed since the last call, redraw the whole frame
 template <typename RGB, unsigned int optionFlags>
 void SMLayerScrolling<RGB, optionFlags>::redrawScrollingText(void) {
-    int j, k;
-    int charPosition, textPosition;
+    int i, j, k;
     uint16_t charY0, charY1;
+    int16_t hardwareY0, hardwareY1;
+
+    if (stripChange)
+        renderScrollingStrip();
 
     for (j = 0; j < this->localHeight; j++) {
 
@@ -358,16 +419,6 @@ void SMLayerScrolling<RGB, optionFlags>::redrawScrollingText(void) {
             continue;
 
         // now in row with text
-        // find the position of the first char
-        charPosition = scrollPosition;
-        textPosition = 0;
-
-        // move to first character at least partially on screen
-        while (charPosition + scrollFont->Width < 0 ) {
-            charPosition += scrollFont->Width;
-            textPosition++;
-        }
-
         // find rows within character bitmap that will be drawn (0-font->height unless text is partially off screen)
         charY0 = j - fontTopOffset;
 
@@ -381,31 +432,16 @@ void SMLayerScrolling<RGB, optionFlags>::redrawScrollingText(void) {
             // clear full refresh buffer before copying background over, size or position may have changed, can't just clear rows used by font
             memset(scrollingBitmap, 0x00, SCROLLING_BUFFER_SIZE);
             majorScrollFontChange = false;
-        } else {
-            // clear rows used by font before drawing on top
-            for (k = 0; k < charY1 - charY0; k++)
-                memset(&scrollingBitmap[((j + k) * SCROLLING_BUFFER_ROW_SIZE)], 0x00, SCROLLING_BUFFER_ROW_SIZE);
+            allRowsChanged = true;
         }
 
-        while (textPosition < textlen && charPosition < this->localWidth) {
-            uint8_t tempBitmask;
-            // draw character from top to bottom
-            for (k = charY0; k < charY1; k++) {
-                tempBitmask = getBitmapFontRowAtXY(text[textPosition], k, scrollFont);
-                //tempBitmask = 0xAA;
-                if (charPosition < 0) {
-                    scrollingBitmap[((j + k - charY0) * SCROLLING_BUFFER_ROW_SIZE) + 0] |= tempBitmask << -charPosition;
-                } else {
-                    scrollingBitmap[((j + k - charY0) * SCROLLING_BUFFER_ROW_SIZE) + (charPosition/8)] |= tempBitmask >> (charPosition%8);
-                    // do two writes if the shifted 8-bit wide bitmask is still on the screen
-                    if(charPosition + 8 < this->localWidth && charPosition % 8)
-                        scrollingBitmap[((j + k - charY0) * SCROLLING_BUFFER_ROW_SIZE) + (charPosition/8) + 1] |= tempBitmask << (8-(charPosition%8));
-                }
-            }
-
-            // get set up for next character
-            charPosition += scrollFont->Width;
-            textPosition++;
+        if(this->getHardwareRows(0, j, this->localWidth - 1, j + (charY1 - charY0) - 1, hardwareY0, hardwareY1))
+            this->setRowBits(changedRows, hardwareY0, hardwareY1);
+
+        // copy the window of the strip at scrollPosition, cost doesn't depend on the length of the text
+        for (k = charY0; k < charY1; k++) {
+            for (i = 0; i < SCROLLING_BUFFER_ROW_SIZE; i++)
+                scrollingBitmap[((j + k - charY0) * SCROLLING_BUFFER_ROW_SIZE) + i] = getScrollingStripByte(k, (i * 8) - scrollPosition);
         }
 
         j += (charY1 - charY0) - 1;
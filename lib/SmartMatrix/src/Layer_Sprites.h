@@ -0,0 +1,110 @@
+/*
+ * SmartMatrix Library - Sprite Layer Class
+ *
+ * Copyright (c) 2020 Louis Beaudoin (Pixelmatix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _LAYER_SPRITES_H_
+#define _LAYER_SPRITES_H_
+
+#include "Layer.h"
+#include "MatrixCommon.h"
+
+#define SM_SPRITES_OPTIONS_NONE     0
+
+typedef struct SM_Sprite {
+    int16_t x, y;               // local screen position of the sprite's top left corner
+    uint16_t atlasX, atlasY;    // top left corner of the sprite's image in the atlas
+    uint8_t width, height;
+    bool visible;
+} SM_Sprite;
+
+// the sprite being drawn, the sprite being refreshed, and the hardware rows and columns the refreshed sprite covers
+typedef struct SM_SpriteSlot {
+    SM_Sprite draw;
+    SM_Sprite refresh;
+    int16_t hardwareX0, hardwareY0, hardwareX1, hardwareY1;
+} SM_SpriteSlot;
+
+// Sprites are rectangles copied from an atlas of RGB pixels, pixels matching the transparent color aren't drawn
+// Changes to sprites are shown after swapBuffers(), only the rows covered by sprites that changed are refreshed
+template <typename RGB, unsigned int optionFlags>
+class SMLayerSprites : public SM_Layer {
+    public:
+        SMLayerSprites(SM_SpriteSlot * slots, uint8_t maxSprites, uint16_t width, uint16_t height);
+        SMLayerSprites(uint8_t maxSprites, uint16_t width, uint16_t height);
+        void begin(void);
+        void frameRefreshCallback();
+        void fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts = 0);
+        void fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts = 0);
+        void setRotation(rotationDegrees newrotation);
+        bool isRowChanged(uint16_t hardwareY);
+
+        void enableColorCorrection(bool enabled);
+
+        // atlas is width * height pixels, and is read while refreshing, call markAtlasChanged() after changing its pixels
+        // a new atlas or transparent color is applied with the sprite changes by swapBuffers(), changed pixels are shown on the next frame without a swap
+        void setAtlas(const RGB * newAtlas, uint16_t width, uint16_t height);
+        void markAtlasChanged(void);
+        void setTransparentColor(const RGB & newColor);
+
+        void setSpriteImage(uint8_t index, uint16_t atlasX, uint16_t atlasY, uint8_t width, uint8_t height);
+        void moveSprite(uint8_t index, int16_t x, int16_t y);
+        void showSprite(uint8_t index, bool visible);
+        // applies sprite changes on the next frame, wait keeps from returning before they are applied
+        void swapBuffers(bool wait = true);
+
+    private:
+        template <typename RGB_OUT>
+        void fillRefreshRowTemplated(uint16_t hardwareY, RGB_OUT refreshRow[]);
+        void localToHardware(int16_t localX, int16_t localY, int16_t &hardwareX, int16_t &hardwareY);
+        void hardwareToLocal(int16_t hardwareX, int16_t hardwareY, int16_t &localX, int16_t &localY);
+        void updateSpriteBounds(SM_SpriteSlot &slot);
+        void markRowsChanged(const SM_SpriteSlot &slot);
+        bool isTransparent(const RGB &pixel) const;
+        int getRowBitmapSize(void) const { return sizeof(uint32_t) * ((this->matrixHeight + 31) / 32); };
+
+        SM_SpriteSlot * slots;
+        uint8_t maxSprites;
+
+        const RGB * drawAtlas = NULL;
+        uint16_t drawAtlasWidth = 0, drawAtlasHeight = 0;
+        RGB drawTransparentColor;
+        const RGB * atlas = NULL;
+        uint16_t atlasWidth = 0, atlasHeight = 0;
+        RGB transparentColor;
+
+        // changedRows: hardware rows covered by a changed sprite before or after this frame's swap
+        uint32_t *changedRows = NULL;
+        bool allRowsChanged = true;
+        bool refreshedCcEnabled = false;
+        volatile bool atlasChange = false;
+        volatile bool atlasPixelChange = false;
+        volatile bool rotationChange = false;
+
+        bool ccEnabled = sizeof(RGB) <= 3 ? true : false;
+
+        volatile bool swapPending = false;
+        void handleBufferSwap(void);
+};
+
+#include "Layer_Sprites_Impl.h"
+
+#endif
@@ -0,0 +1,341 @@
+/*
+ * SmartMatrix Library - Sprite Layer Class
+ *
+ * Copyright (c) 2020 Louis Beaudoin (Pixelmatix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+
+template <typename RGB, unsigned int optionFlags>
+SMLayerSprites<RGB, optionFlags>::SMLayerSprites(SM_SpriteSlot * slots, uint8_t maxSprites, uint16_t width, uint16_t height) {
+    // size of slots is maxSprites
+    this->slots = slots;
+    this->maxSprites = maxSprites;
+    memset(slots, 0x00, sizeof(SM_SpriteSlot) * maxSprites);
+    this->matrixWidth = width;
+    this->matrixHeight = height;
+    drawTransparentColor = rgb48(0, 0, 0);
+    transparentColor = drawTransparentColor;
+}
+
+template <typename RGB, unsigned int optionFlags>
+SMLayerSprites<RGB, optionFlags>::SMLayerSprites(uint8_t maxSprites, uint16_t width, uint16_t height) {
+    slots = (SM_SpriteSlot *)malloc(sizeof(SM_SpriteSlot) * maxSprites);
+#ifdef ESP32
+    assert(slots != NULL);
+#else
+    this->assert(slots != NULL);
+#endif
+    memset(slots, 0x00, sizeof(SM_SpriteSlot) * maxSprites);
+    this->maxSprites = maxSprites;
+    this->matrixWidth = width;
+    this->matrixHeight = height;
+    drawTransparentColor = rgb48(0, 0, 0);
+    transparentColor = drawTransparentColor;
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::begin(void) {
+    if(!changedRows) {
+        changedRows = (uint32_t *)malloc(getRowBitmapSize());
+        assert(changedRows != NULL);
+    }
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = true;
+
+    for(int i=0; i<maxSprites; i++)
+        updateSpriteBounds(slots[i]);
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::frameRefreshCallback(void) {
+    memset(changedRows, 0x00, getRowBitmapSize());
+    allRowsChanged = false;
+
+    if(this->ccEnabled != refreshedCcEnabled) {
+        refreshedCcEnabled = this->ccEnabled;
+        allRowsChanged = true;
+    }
+
+    // the calc class marks every row changed after a rotation, the bounds still need updating
+    if(rotationChange) {
+        rotationChange = false;
+        for(int i=0; i<maxSprites; i++)
+            updateSpriteBounds(slots[i]);
+    }
+
+    handleBufferSwap();
+
+    // the atlas is read while refreshing, so changed pixels show on every visible sprite now, not after the next swap
+    if(atlasPixelChange) {
+        atlasPixelChange = false;
+        for(int i=0; i<maxSprites; i++)
+            markRowsChanged(slots[i]);
+    }
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::setRotation(rotationDegrees newrotation) {
+    SM_Layer::setRotation(newrotation);
+    rotationChange = true;
+}
+
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerSprites<RGB, optionFlags>::isRowChanged(uint16_t hardwareY) {
+    return allRowsChanged || this->getRowBit(changedRows, hardwareY);
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::localToHardware(int16_t localX, int16_t localY, int16_t &hardwareX, int16_t &hardwareY) {
+    switch( this->layerRotation ) {
+      case rotation180 :
+        hardwareX = (this->matrixWidth - 1) - localX;
+        hardwareY = (this->matrixHeight - 1) - localY;
+        break;
+      case rotation90 :
+        hardwareX = (this->matrixWidth - 1) - localY;
+        hardwareY = localX;
+        break;
+      case rotation270 :
+        hardwareX = localY;
+        hardwareY = (this->matrixHeight - 1) - localX;
+        break;
+      case rotation0 :
+      default:
+        hardwareX = localX;
+        hardwareY = localY;
+        break;
+    };
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::hardwareToLocal(int16_t hardwareX, int16_t hardwareY, int16_t &localX, int16_t &localY) {
+    switch( this->layerRotation ) {
+      case rotation180 :
+        localX = (this->matrixWidth - 1) - hardwareX;
+        localY = (this->matrixHeight - 1) - hardwareY;
+        break;
+      case rotation90 :
+        localX = hardwareY;
+        localY = (this->matrixWidth - 1) - hardwareX;
+        break;
+      case rotation270 :
+        localX = (this->matrixHeight - 1) - hardwareY;
+        localY = hardwareX;
+        break;
+      case rotation0 :
+      default:
+        localX = hardwareX;
+        localY = hardwareY;
+        break;
+    };
+}
+
+// the dirty rectangle of a sprite: the hardware pixels it covers on screen, empty if it isn't visible
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::updateSpriteBounds(SM_SpriteSlot &slot) {
+    const SM_Sprite &sprite = slot.refresh;
+
+    int16_t x0 = sprite.x < 0 ? 0 : sprite.x;
+    int16_t y0 = sprite.y < 0 ? 0 : sprite.y;
+    int16_t x1 = sprite.x + sprite.width - 1;
+    int16_t y1 = sprite.y + sprite.height - 1;
+    if(x1 >= this->localWidth)
+        x1 = this->localWidth - 1;
+    if(y1 >= this->localHeight)
+        y1 = this->localHeight - 1;
+
+    if(!sprite.visible || !sprite.width || !sprite.height || x0 > x1 || y0 > y1) {
+        slot.hardwareX0 = slot.hardwareY0 = 0;
+        slot.hardwareX1 = slot.hardwareY1 = -1;
+        return;
+    }
+
+    int16_t hx0, hy0, hx1, hy1;
+    localToHardware(x0, y0, hx0, hy0);
+    localToHardware(x1, y1, hx1, hy1);
+
+    if(hx0 > hx1)
+        SWAPint(hx0, hx1);
+    if(hy0 > hy1)
+        SWAPint(hy0, hy1);
+
+    slot.hardwareX0 = hx0;
+    slot.hardwareY0 = hy0;
+    slot.hardwareX1 = hx1;
+    slot.hardwareY1 = hy1;
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::markRowsChanged(const SM_SpriteSlot &slot) {
+    this->setRowBits(changedRows, slot.hardwareY0, slot.hardwareY1);
+}
+
+template <typename RGB, unsigned int optionFlags>
+bool SMLayerSprites<RGB, optionFlags>::isTransparent(const RGB &pixel) const {
+    return pixel.red == transparentColor.red && pixel.green == transparentColor.green && pixel.blue == transparentColor.blue;
+}
+
+// sprites are only composed into the rows their dirty rectangle covers, later sprites are drawn on top
+template <typename RGB, unsigned int optionFlags> template <typename RGB_OUT>
+void SMLayerSprites<RGB, optionFlags>::fillRefreshRowTemplated(uint16_t hardwareY, RGB_OUT refreshRow[]) {
+    if(!atlas)
+        return;
+
+    for(int i=0; i<maxSprites; i++) {
+        const SM_SpriteSlot &slot = slots[i];
+
+        if(hardwareY < slot.hardwareY0 || hardwareY > slot.hardwareY1)
+            continue;
+
+        const SM_Sprite &sprite = slot.refresh;
+
+        for(int16_t hardwareX=slot.hardwareX0; hardwareX<=slot.hardwareX1; hardwareX++) {
+            int16_t localX, localY;
+            hardwareToLocal(hardwareX, hardwareY, localX, localY);
+
+            const RGB &currentPixel = atlas[(sprite.atlasY + localY - sprite.y) * atlasWidth + sprite.atlasX + localX - sprite.x];
+            if(isTransparent(currentPixel))
+                continue;
+
+            if(this->ccEnabled)
+                colorCorrection(currentPixel, refreshRow[hardwareX]);
+            else
+                refreshRow[hardwareX] = currentPixel;
+        }
+    }
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb48 refreshRow[], int brightnessShifts) {
+    fillRefreshRowTemplated(hardwareY, refreshRow);
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::fillRefreshRow(uint16_t hardwareY, rgb24 refreshRow[], int brightnessShifts) {
+    fillRefreshRowTemplated(hardwareY, refreshRow);
+}
+
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::enableColorCorrection(bool enabled) {
+    this->ccEnabled = sizeof(RGB) <= 3 ? enabled : false;
+}
+
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::setAtlas(const RGB * newAtlas, uint16_t width, uint16_t height) {
+    drawAtlas = newAtlas;
+    drawAtlasWidth = width;
+    drawAtlasHeight = height;
+    atlasChange = true;
+}
+
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::markAtlasChanged(void) {
+    atlasPixelChange = true;
+}
+
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::setTransparentColor(const RGB & newColor) {
+    drawTransparentColor = newColor;
+    atlasChange = true;
+}
+
+// the image is clipped to the atlas set when this is called
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::setSpriteImage(uint8_t index, uint16_t atlasX, uint16_t atlasY, uint8_t width, uint8_t height) {
+    if(index >= maxSprites)
+        return;
+
+    if(atlasX >= drawAtlasWidth || atlasY >= drawAtlasHeight) {
+        width = height = 0;
+    } else {
+        if(atlasX + width > drawAtlasWidth)
+            width = drawAtlasWidth - atlasX;
+        if(atlasY + height > drawAtlasHeight)
+            height = drawAtlasHeight - atlasY;
+    }
+
+    SM_Sprite &sprite = slots[index].draw;
+    sprite.atlasX = atlasX;
+    sprite.atlasY = atlasY;
+    sprite.width = width;
+    sprite.height = height;
+}
+
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::moveSprite(uint8_t index, int16_t x, int16_t y) {
+    if(index >= maxSprites)
+        return;
+
+    slots[index].draw.x = x;
+    slots[index].draw.y = y;
+}
+
+template<typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::showSprite(uint8_t index, bool visible) {
+    if(index >= maxSprites)
+        return;
+
+    slots[index].draw.visible = visible;
+}
+
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::swapBuffers(bool wait) {
+    while (swapPending);
+
+    swapPending = true;
+
+    if(wait)
+        while(swapPending);
+}
+
+// a changed sprite marks the rows of its old and new dirty rectangles, unchanged sprites cost nothing
+template <typename RGB, unsigned int optionFlags>
+void SMLayerSprites<RGB, optionFlags>::handleBufferSwap(void) {
+    if (!swapPending)
+        return;
+
+    bool redrawAll = atlasChange;
+    atlasChange = false;
+
+    for(int i=0; i<maxSprites; i++) {
+        SM_SpriteSlot &slot = slots[i];
+
+        const SM_Sprite &draw = slot.draw;
+        const SM_Sprite &refresh = slot.refresh;
+        bool spriteChange = draw.x != refresh.x || draw.y != refresh.y || draw.atlasX != refresh.atlasX || draw.atlasY != refresh.atlasY ||
+            draw.width != refresh.width || draw.height != refresh.height || draw.visible != refresh.visible;
+
+        if(!redrawAll && !spriteChange)
+            continue;
+
+        markRowsChanged(slot);
+        slot.refresh = slot.draw;
+        updateSpriteBounds(slot);
+        markRowsChanged(slot);
+    }
+
+    atlas = drawAtlas;
+    atlasWidth = drawAtlasWidth;
+    atlasHeight = drawAtlasHeight;
+    transparentColor = drawTransparentColor;
+
+    swapPending = false;
+}
@@ -1020,6 +1020,13 @@ typedef enum ScrollMode {
     wrapForwardFromLeft = 5
 } ScrollMode;
 
+typedef enum BlendMode {
+    blendNormal = 0,
+    blendAdd = 1,
+    blendMultiply = 2,
+    blendScreen = 3
+} BlendMode;
+
 #ifndef SWAPint
 #define SWAPint(X,Y) { \
         int temp = X ; \
@@ -245,6 +245,7 @@ INLINE void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelTyp
 
     // static to avoid putting large buffer on the stack
     static rgb48 tempRow0[matrixWidth];
+    static rgb48 layerScratchRow[2 * matrixWidth];
 
     // clear buffer to prevent garbage data showing through transparent layers
     memset(tempRow0, 0x00, sizeof(tempRow0));
@@ -252,7 +253,7 @@ INLINE void SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelTyp
     // get pixel data from layers
     SM_Layer * templayer = SmartMatrixApaCalc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
     while(templayer) {
-        templayer->fillRefreshRow(currentRow, &tempRow0[0]);
+        templayer->composeRefreshRow(currentRow, &tempRow0[0], layerScratchRow);
         templayer = templayer->nextLayer;        
     }
 
@@ -28,6 +28,8 @@
 #include "freertos/semphr.h"
 
 SemaphoreHandle_t calcTaskSemaphore;
+SemaphoreHandle_t calcWorkerSemaphore;
+SemaphoreHandle_t calcWorkerDoneSemaphore;
 
 void IRAM_ATTR matrixCalculationsSignal(void) {
     static BaseType_t xHigherPriorityTaskWoken;
@@ -25,6 +25,12 @@
 #define SmartMatrixHUB75Calc_h
 
 extern SemaphoreHandle_t calcTaskSemaphore;
+extern SemaphoreHandle_t calcWorkerSemaphore;
+extern SemaphoreHandle_t calcWorkerDoneSemaphore;
+
+// the calc task loads rows of the frame buffer, with SMARTMATRIX_OPTIONS_ESP32_CALC_DUAL_CORE a worker task on the other core helps
+#define ESP32_NUM_CALC_WORKERS  2
+
 extern void matrixCalculationsSignal(void);
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -51,6 +57,7 @@ public:
     bool getdmaBufferUnderrunFlag(void);
     bool getRefreshRateLoweredFlag(void);
     void setMaxCalculationCpuPercentage(uint8_t newMaxCpuPercentage);
+    uint8_t getCalcCoreUtilization(uint8_t core);
 
     // debug
     int countFPS(void);
@@ -64,21 +71,29 @@ public:
 private:
     static SM_Layer * baseLayer;
 
-    static void * tempRow0Ptr;
-    static void * tempRow1Ptr;
+    static void * tempRow0Ptr[ESP32_NUM_CALC_WORKERS];
+    static void * tempRow1Ptr[ESP32_NUM_CALC_WORKERS];
+    static uint8_t * slicedRowPtr[ESP32_NUM_CALC_WORKERS];
+    static void * layerScratchRowPtr[ESP32_NUM_CALC_WORKERS];
 
     // functions for refreshing
     static void loadMatrixBuffers(int lsbMsbTransitionBit, int numBrightnessShifts = 0);
-    static void loadMatrixBuffers48(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts = 0);
-    static void loadMatrixBuffers24(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts = 0);
+    static void loadMatrixBuffers48(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts, int worker);
+    static void loadMatrixBuffers24(frameStruct * currentFrameDataPtr, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts, int worker);
+    static void loadQueuedRows(int worker);
+    static void calcWorkerTask(void* pvParameters);
+    static int getNumCalcWorkers(void);
+    template <typename RGB>
+    static void fillRefreshRowFromLayer(SM_Layer * layer, int currentRow, uint16_t hardwareY, RGB refreshRow[], int numBrightnessShifts, int worker);
+    static uint32_t getChangedRefreshRows(bool allRowsChanged);
     static void calcTask(void* pvParameters);
-    static void resetMultiRowRefreshMapPosition(void);
-    static void resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(void);
-    static void advanceMultiRowRefreshMapToNextRow(void);
-    static void advanceMultiRowRefreshMapToNextPixelGroup(void);
-    static int getMultiRowRefreshRowOffset(void);
-    static int getMultiRowRefreshNumPixelsToMap(void);
-    static int getMultiRowRefreshPixelGroupOffset(void);
+    static void resetMultiRowRefreshMapPosition(int worker);
+    static void resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(int worker);
+    static void advanceMultiRowRefreshMapToNextRow(int worker);
+    static void advanceMultiRowRefreshMapToNextPixelGroup(int worker);
+    static int getMultiRowRefreshRowOffset(int worker);
+    static int getMultiRowRefreshNumPixelsToMap(int worker);
+    static int getMultiRowRefreshPixelGroupOffset(int worker);
     
     // configuration
     static volatile bool brightnessChange;
@@ -95,11 +110,30 @@ private:
     static bool refreshRateChanged;
     static uint8_t lsbMsbTransitionBit;
     static TaskHandle_t calcTaskHandle;
+
+    // keeping track of refresh rows to skip when loading a frame buffer
+    static volatile bool layerListChange;
+    static int lastNumBrightnessShifts;
+    static uint32_t staleRefreshRows[ESP32_NUM_FRAME_BUFFERS];  // bit per refresh row that needs loading, for each frame buffer
+    static uint8_t refreshRowOfHardwareRow[matrixHeight];       // refresh row + 1 that each hardware row was loaded into, 0 if not loaded yet
     
-    static int multiRowRefresh_mapIndex_CurrentRowGroups;
-    static int multiRowRefresh_mapIndex_CurrentPixelGroup;
-    static int multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
-    static int multiRowRefresh_NumPanelsAlreadyMapped;
+    // position in the multi row refresh map, kept for each worker
+    static int multiRowRefresh_mapIndex_CurrentRowGroups[ESP32_NUM_CALC_WORKERS];
+    static int multiRowRefresh_mapIndex_CurrentPixelGroup[ESP32_NUM_CALC_WORKERS];
+    static int multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped[ESP32_NUM_CALC_WORKERS];
+    static int multiRowRefresh_NumPanelsAlreadyMapped[ESP32_NUM_CALC_WORKERS];
+
+    // frame buffer being loaded by the workers
+    static RowQueue_SM rowQueue;
+    static frameStruct * queuedFrameDataPtr;
+    static int queuedLsbMsbTransitionBit;
+    static int queuedNumBrightnessShifts;
+
+    // keeping track of time spent loading rows
+    static TaskHandle_t calcWorkerTaskHandle;
+    static int calcWorkerCore[ESP32_NUM_CALC_WORKERS];
+    static uint32_t calcWorkerBusyMicros[ESP32_NUM_CALC_WORKERS];
+    static uint32_t calcWorkerLastReportMicros[ESP32_NUM_CALC_WORKERS];
 };
 
 #endif
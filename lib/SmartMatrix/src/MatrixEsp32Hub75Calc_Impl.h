@@ -40,10 +40,16 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 SM_Layer * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow0Ptr;
+void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow0Ptr[ESP32_NUM_CALC_WORKERS];
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow1Ptr;
+void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::tempRow1Ptr[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::slicedRowPtr[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::layerScratchRowPtr[ESP32_NUM_CALC_WORKERS];
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 volatile bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::dmaBufferUnderrun = false;
@@ -62,16 +68,40 @@ template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char pan
 uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::lsbMsbTransitionBit;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentRowGroups = 0;
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentRowGroups[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentPixelGroup[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_NumPanelsAlreadyMapped[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+RowQueue_SM SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowQueue;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_mapIndex_CurrentPixelGroup = -1;
+typename SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::frameStruct * SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::queuedFrameDataPtr;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped = 0;
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::queuedLsbMsbTransitionBit;
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::multiRowRefresh_NumPanelsAlreadyMapped = 0;
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::queuedNumBrightnessShifts;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+TaskHandle_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerTaskHandle;
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerCore[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerBusyMicros[ESP32_NUM_CALC_WORKERS];
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerLastReportMicros[ESP32_NUM_CALC_WORKERS];
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::SmartMatrixHub75Calc(void) {
@@ -87,6 +117,7 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     } else {
         baseLayer = newlayer;
     }
+    layerListChange = true;
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
@@ -158,6 +189,7 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     lastMillisStart = millis();
 
     // do once-per-frame updates
+    bool rotationApplied = rotationChange;
     if (rotationChange) {
         templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
         while(templayer) {
@@ -168,6 +200,7 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     }
 
     int largestRequestedBrightnessShifts = 0;
+    bool compositionChange = false;
 
     templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
     while(templayer) {
@@ -177,6 +210,9 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
 
         templayer->frameRefreshCallback();
 
+        if(templayer->getCompositionChanged())
+            compositionChange = true;
+
         int tempval = templayer->getRequestedBrightnessShifts();
         if(tempval > largestRequestedBrightnessShifts)
             largestRequestedBrightnessShifts = tempval;
@@ -193,6 +229,14 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
         brightnessChange = true;
     }
 
+    // every frame buffer holds an older frame, so a changed row needs loading into each of them
+    bool allRowsChanged = rotationApplied || brightnessChange || layerListChange || compositionChange || (largestRequestedBrightnessShifts != lastNumBrightnessShifts);
+    uint32_t changedRefreshRows = getChangedRefreshRows(allRowsChanged);
+    for(int i=0; i<ESP32_NUM_FRAME_BUFFERS; i++)
+        staleRefreshRows[i] |= changedRefreshRows;
+    layerListChange = false;
+    lastNumBrightnessShifts = largestRequestedBrightnessShifts;
+
     if (brightnessChange) {
         SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setBrightness(shiftedBrightness);
         brightnessChange = false;
@@ -205,6 +249,43 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     lastMillisEnd = millis();
 }
 
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getChangedRefreshRows(bool allRowsChanged) {
+    static_assert(MATRIX_SCAN_MOD <= 32, "staleRefreshRows needs a bit per refresh row");
+
+    uint32_t changedRefreshRows = 0;
+
+    for(int y=0; y<matrixHeight && !allRowsChanged; y++) {
+        SM_Layer * templayer = SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::baseLayer;
+        while(templayer) {
+            if(templayer->isRowChanged(y))
+                break;
+            templayer = templayer->nextLayer;
+        }
+
+        if(!templayer)
+            continue;
+
+        // a row that wasn't loaded yet could be anywhere
+        if(!refreshRowOfHardwareRow[y])
+            allRowsChanged = true;
+        else
+            changedRefreshRows |= (uint32_t)1 << (refreshRowOfHardwareRow[y] - 1);
+    }
+
+    if(allRowsChanged)
+        changedRefreshRows = 0xFFFFFFFF;
+
+    return changedRefreshRows;
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+template <typename RGB>
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::fillRefreshRowFromLayer(SM_Layer * layer, int currentRow, uint16_t hardwareY, RGB refreshRow[], int numBrightnessShifts, int worker) {
+    refreshRowOfHardwareRow[hardwareY] = currentRow + 1;
+    layer->composeRefreshRow(hardwareY, refreshRow, (RGB*)layerScratchRowPtr[worker], numBrightnessShifts);
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setRotation(rotationDegrees newrotation) {
     rotation = newrotation;
@@ -234,6 +315,14 @@ volatile bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, pane
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 volatile bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rotationChange = true;
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+volatile bool SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::layerListChange = false;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::lastNumBrightnessShifts = 0;
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint32_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::staleRefreshRows[ESP32_NUM_FRAME_BUFFERS];
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::refreshRowOfHardwareRow[matrixHeight];
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 rotationDegrees SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rotation = rotation0;
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::shiftedBrightness;
@@ -264,6 +353,32 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     maxCalcCpuPercentage = newMaxCpuPercentage;
 }
 
+// returns the percentage of time since the last call that the calc workers on the given core spent loading rows
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+uint8_t SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getCalcCoreUtilization(uint8_t core) {
+    for(int worker = 0; worker < getNumCalcWorkers(); worker++) {
+        if(calcWorkerCore[worker] != core)
+            continue;
+
+        uint32_t now = micros();
+        uint32_t busyMicros = __atomic_exchange_n(&calcWorkerBusyMicros[worker], 0, __ATOMIC_RELAXED);
+        uint32_t elapsedMicros = now - calcWorkerLastReportMicros[worker];
+        calcWorkerLastReportMicros[worker] = now;
+
+        if(!elapsedMicros)
+            return 0;
+
+        uint64_t percentage = ((uint64_t)busyMicros * 100) / elapsedMicros;
+        return (percentage > 100) ? 100 : percentage;
+    }
+    return 0;
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNumCalcWorkers(void) {
+    return (optionFlags & SMARTMATRIX_OPTIONS_ESP32_CALC_DUAL_CORE) ? ESP32_NUM_CALC_WORKERS : 1;
+}
+
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setCalcRefreshRateDivider(uint8_t newDivider) {
     // TODO: improve so fractional results don't screw up the calc_refreshRate divider
@@ -337,6 +452,27 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     }
 }
 
+// helps the calc task load the frame buffer from the other core, each pass loads the rows it can claim from rowQueue
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::calcWorkerTask(void* pvParameters)
+{
+    static long lastMillis = 0;
+    while(1) {
+        if( xSemaphoreTake(calcWorkerSemaphore, portMAX_DELAY) == pdTRUE ) {
+            long currentMillis = millis();
+            if(currentMillis - lastMillis >= 4500){
+                // sleep a bit to reset the watchdog (default is 5000ms between resets)
+                vTaskDelay(1);
+                lastMillis = currentMillis;
+            }
+
+            loadQueuedRows(1);
+
+            xSemaphoreGive(calcWorkerDoneSemaphore);
+        }
+    }
+}
+
 #define MATRIX_CALC_TASK_DEFAULT_PRIORITY   2
 #define MATRIX_CALC_TASK_LOW_PRIORITY      1
 
@@ -365,6 +501,17 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
 
     // TODO: fine tune stack size: 1000 works with 64x64/32-24bit, 500 doesn't, does it change based on matrix size, depth?
     xTaskCreatePinnedToCore(calcTask, "SmartMatrixCalc", 1000, NULL, taskPriority, &calcTaskHandle, calcTaskCore);
+    calcWorkerCore[0] = calcTaskCore;
+    calcWorkerLastReportMicros[0] = micros();
+
+    // the second worker runs on the core the calc task isn't using, with the same priority
+    if(getNumCalcWorkers() > 1) {
+        calcWorkerSemaphore = xSemaphoreCreateBinary();
+        calcWorkerDoneSemaphore = xSemaphoreCreateBinary();
+        calcWorkerCore[1] = !calcTaskCore;
+        calcWorkerLastReportMicros[1] = micros();
+        xTaskCreatePinnedToCore(calcWorkerTask, "SmartMatrixCalcWorker", 1000, NULL, taskPriority, &calcWorkerTaskHandle, calcWorkerCore[1]);
+    }
 
     printf("SmartMatrix Layers Allocated from Heap:\r\n");
     show_esp32_heap_mem();
@@ -373,16 +520,24 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
     // malloc temporary buffers needed for loadMatrixBuffers
     int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
 
-    if((COLOR_DEPTH_BITS == 12) || (COLOR_DEPTH_BITS == 16)){
-        tempRow0Ptr = malloc(sizeof(rgb48) * numPixelsPerTempRow);
-        tempRow1Ptr = malloc(sizeof(rgb48) * numPixelsPerTempRow);
-    } else {
-        tempRow0Ptr = malloc(sizeof(rgb24) * numPixelsPerTempRow);
-        tempRow1Ptr = malloc(sizeof(rgb24) * numPixelsPerTempRow);
-    }
+    for(int worker = 0; worker < getNumCalcWorkers(); worker++) {
+        if((COLOR_DEPTH_BITS == 12) || (COLOR_DEPTH_BITS == 16)){
+            tempRow0Ptr[worker] = malloc(sizeof(rgb48) * numPixelsPerTempRow);
+            tempRow1Ptr[worker] = malloc(sizeof(rgb48) * numPixelsPerTempRow);
+        } else {
+            tempRow0Ptr[worker] = malloc(sizeof(rgb24) * numPixelsPerTempRow);
+            tempRow1Ptr[worker] = malloc(sizeof(rgb24) * numPixelsPerTempRow);
+        }
 
-    assert(tempRow0Ptr != NULL);
-    assert(tempRow1Ptr != NULL);
+        slicedRowPtr[worker] = (uint8_t*)malloc(COLOR_DEPTH_BITS * numPixelsPerTempRow);
+        // used by layers that are blended with the layers below, large enough for either color depth
+        layerScratchRowPtr[worker] = malloc(sizeof(rgb48) * 2 * matrixWidth);
+
+        assert(tempRow0Ptr[worker] != NULL);
+        assert(tempRow1Ptr[worker] != NULL);
+        assert(slicedRowPtr[worker] != NULL);
+        assert(layerScratchRowPtr[worker] != NULL);
+    }
 #endif
 
     SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::setMatrixCalculationsCallback(matrixCalculationsSignal);
@@ -401,86 +556,86 @@ void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, op
 #define IS_LAST_PANEL_MAP_ENTRY(x) (!x.rowOffset && !x.bufferOffset && !x.numPixels)
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::resetMultiRowRefreshMapPosition(void) {   
-    multiRowRefresh_mapIndex_CurrentRowGroups = 0;
-    resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::resetMultiRowRefreshMapPosition(int worker) {   
+    multiRowRefresh_mapIndex_CurrentRowGroups[worker] = 0;
+    resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(worker);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(void) {   
-    multiRowRefresh_mapIndex_CurrentPixelGroup = multiRowRefresh_mapIndex_CurrentRowGroups;
-    multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped = 0;
-    multiRowRefresh_NumPanelsAlreadyMapped = 0;
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(int worker) {   
+    multiRowRefresh_mapIndex_CurrentPixelGroup[worker] = multiRowRefresh_mapIndex_CurrentRowGroups[worker];
+    multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped[worker] = 0;
+    multiRowRefresh_NumPanelsAlreadyMapped[worker] = 0;
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::advanceMultiRowRefreshMapToNextRow(void) {   
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::advanceMultiRowRefreshMapToNextRow(int worker) {   
     static const PanelMappingEntry * map = getMultiRowRefreshPanelMap(panelType);
 
-    int currentRowOffset = map[multiRowRefresh_mapIndex_CurrentRowGroups].rowOffset;
+    int currentRowOffset = map[multiRowRefresh_mapIndex_CurrentRowGroups[worker]].rowOffset;
 
     // advance until end of table, or entry with new row nubmer is found
-    while(!IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentRowGroups])) {
-        multiRowRefresh_mapIndex_CurrentRowGroups++;
+    while(!IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentRowGroups[worker]])) {
+        multiRowRefresh_mapIndex_CurrentRowGroups[worker]++;
 
-        if(map[multiRowRefresh_mapIndex_CurrentRowGroups].rowOffset != currentRowOffset)
+        if(map[multiRowRefresh_mapIndex_CurrentRowGroups[worker]].rowOffset != currentRowOffset)
             break;
     }
 
-    resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
+    resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(worker);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::advanceMultiRowRefreshMapToNextPixelGroup(void) {   
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::advanceMultiRowRefreshMapToNextPixelGroup(int worker) {   
     static const PanelMappingEntry * map = getMultiRowRefreshPanelMap(panelType);
 
-    int currentRowOffset = map[multiRowRefresh_mapIndex_CurrentPixelGroup].rowOffset;
+    int currentRowOffset = map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker]].rowOffset;
 
     // don't change if we're already on the end
-    if(IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentPixelGroup])) {
+    if(IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker]])) {
         return;
     }
 
-    if(!IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentPixelGroup + 1]) &&
+    if(!IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker] + 1]) &&
         // go to the next entry if it's in the same row offset
-        (map[multiRowRefresh_mapIndex_CurrentPixelGroup + 1].rowOffset == currentRowOffset)) {
-        multiRowRefresh_mapIndex_CurrentPixelGroup++;
+        (map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker] + 1].rowOffset == currentRowOffset)) {
+        multiRowRefresh_mapIndex_CurrentPixelGroup[worker]++;
     } else {
         // else we just finished mapping a panel and we're wrapping to the beginning of this row in the list
         // keep going back until we get to the first entry, or the first entry in this row
-        while((multiRowRefresh_mapIndex_CurrentPixelGroup > 0) && (map[multiRowRefresh_mapIndex_CurrentPixelGroup - 1].rowOffset == currentRowOffset))
-            multiRowRefresh_mapIndex_CurrentPixelGroup--;
+        while((multiRowRefresh_mapIndex_CurrentPixelGroup[worker] > 0) && (map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker] - 1].rowOffset == currentRowOffset))
+            multiRowRefresh_mapIndex_CurrentPixelGroup[worker]--;
 
         // we need to set the total offset to the beginning offset of the next panel.  Calculate what that would be
-        multiRowRefresh_NumPanelsAlreadyMapped++;
-        multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped = multiRowRefresh_NumPanelsAlreadyMapped * COLS_PER_PANEL * PHYSICAL_ROWS_PER_REFRESH_ROW;
+        multiRowRefresh_NumPanelsAlreadyMapped[worker]++;
+        multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped[worker] = multiRowRefresh_NumPanelsAlreadyMapped[worker] * COLS_PER_PANEL * PHYSICAL_ROWS_PER_REFRESH_ROW;
     }
 }
 
 // returns the row offset from the map, or -1 if we've gone through the whole map already
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMultiRowRefreshRowOffset(void) {   
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMultiRowRefreshRowOffset(int worker) {   
     static const PanelMappingEntry * map = getMultiRowRefreshPanelMap(panelType);
 
-    if(IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentRowGroups])){
+    if(IS_LAST_PANEL_MAP_ENTRY(map[multiRowRefresh_mapIndex_CurrentRowGroups[worker]])){
         return -1;
     }
 
-    return map[multiRowRefresh_mapIndex_CurrentRowGroups].rowOffset;    
+    return map[multiRowRefresh_mapIndex_CurrentRowGroups[worker]].rowOffset;    
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMultiRowRefreshNumPixelsToMap(void) {        
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMultiRowRefreshNumPixelsToMap(int worker) {        
     static const PanelMappingEntry * map = getMultiRowRefreshPanelMap(panelType);
 
-    return map[multiRowRefresh_mapIndex_CurrentPixelGroup].numPixels;    
+    return map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker]].numPixels;    
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMultiRowRefreshPixelGroupOffset(void) {        
+int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getMultiRowRefreshPixelGroupOffset(int worker) {        
     static const PanelMappingEntry * map = getMultiRowRefreshPanelMap(panelType);
 
-    return map[multiRowRefresh_mapIndex_CurrentPixelGroup].bufferOffset + multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped;
+    return map[multiRowRefresh_mapIndex_CurrentPixelGroup[worker]].bufferOffset + multiRowRefresh_PixelOffsetFromPanelsAlreadyMapped[worker];
 }
 
 #define REFRESH_PRINTFS 0
@@ -489,7 +644,7 @@ int SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, opt
 #define OEPWM_THRESHOLD_BIT 1
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts) {
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers48(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts, int worker) {
     int i;
     int multiRowRefreshRowOffset = 0;
     int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
@@ -500,16 +655,18 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
 
 #if defined(ESP32)
     // use buffers malloc'd previously
-    rgb48 * tempRow0 = (rgb48*)tempRow0Ptr;
-    rgb48 * tempRow1 = (rgb48*)tempRow1Ptr;
+    rgb48 * tempRow0 = (rgb48*)tempRow0Ptr[worker];
+    rgb48 * tempRow1 = (rgb48*)tempRow1Ptr[worker];
+    uint8_t * slicedRow = slicedRowPtr[worker];
 #else
     // static to avoid putting large buffer on the stack
     static rgb48 tempRow0[numPixelsPerTempRow];
     static rgb48 tempRow1[numPixelsPerTempRow];
+    static uint8_t slicedRow[COLOR_DEPTH_BITS * numPixelsPerTempRow];
 #endif
 
     int c = 0;
-    resetMultiRowRefreshMapPosition();
+    resetMultiRowRefreshMapPosition(worker);
 
     // go through this process for each physical row that is contained in the refresh row
     do {
@@ -529,62 +686,58 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
                     (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     // fill data from bottom to top, so bottom panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                 // Z-shape, top to bottom
                 } else if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
                     !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     // fill data from top to bottom, so top panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + i*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + i*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + i*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + i*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                 // C-shape, bottom to top
                 } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
                     (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     // alternate direction of filling (or loading) for each matrixwidth
                     // swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half)
                     if((MATRIX_STACK_HEIGHT-i+1)%2) {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     } else {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     }
                 // C-shape, top to bottom
                 } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && 
                     !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     if((MATRIX_STACK_HEIGHT-i)%2) {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     } else {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     }
                 }
             }
             templayer = templayer->nextLayer;        
         }
 
+        // slice the data bits of every bitplane out of each pixel pair at once, instead of masking the channels once per bitplane
+        // 36-bit color uses the upper 12 bits of each rgb48 channel
+        static_assert(BIT_R1 == BITSLICE_R1_BIT && BIT_G1 == BITSLICE_G1_BIT && BIT_B1 == BITSLICE_B1_BIT &&
+            BIT_R2 == BITSLICE_R2_BIT && BIT_G2 == BITSLICE_G2_BIT && BIT_B2 == BITSLICE_B2_BIT, "RGB data pins must be in bit slice order");
+        bitSliceRow<COLOR_DEPTH_BITS, (COLOR_DEPTH_BITS == 12) ? 4 : 0>(tempRow0, tempRow1, numPixelsPerTempRow, slicedRow);
+
         for(int j=0; j<COLOR_DEPTH_BITS; j++) {
-            int maskoffset = 0;
-            if(COLOR_DEPTH_BITS == 12)   // 36-bit color
-                maskoffset = 4;
-            else if (COLOR_DEPTH_BITS == 16) // 48-bit color
-                maskoffset = 0;
-            else if (COLOR_DEPTH_BITS == 8)  // 24-bit color
-                maskoffset = 0;
-
-            uint16_t mask = (1 << (j + maskoffset));
-            
             SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowBitStruct *p=&(frameBuffer->rowdata[currentRow].rowbits[j]); //bitplane location to write to
             
             int i=0;
 
             // reset pixel map offset so we start filling from the first panel again
-            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
+            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(worker);
 
             while(i < numPixelsPerTempRow) {
                 // get number of pixels to go through with current pass
-                int numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
+                int numPixelsToMap = getMultiRowRefreshNumPixelsToMap(worker);
 
 #if (REFRESH_PRINTFS >= 1)
                 printf("numPixelsToMap = %d\r\n", numPixelsToMap);
@@ -597,7 +750,7 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 }
 
                 // get offset where pixels are written in the refresh buffer
-                int currentMapOffset = getMultiRowRefreshPixelGroupOffset();
+                int currentMapOffset = getMultiRowRefreshPixelGroupOffset(worker);
 
 #if (REFRESH_PRINTFS >= 1)
                 printf("currentMapOffset = %d\r\n", currentMapOffset);
@@ -681,18 +834,8 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                     if((refreshBufferPosition)>=PIXELS_PER_LATCH-2) v|=BIT_OE;
 #endif
 
-                    if (tempRow0[i+k].red & mask)
-                        v|=BIT_R1;
-                    if (tempRow0[i+k].green & mask)
-                        v|=BIT_G1;
-                    if (tempRow0[i+k].blue & mask)
-                        v|=BIT_B1;
-                    if (tempRow1[i+k].red & mask)
-                        v|=BIT_R2;
-                    if (tempRow1[i+k].green & mask)
-                        v|=BIT_G2;
-                    if (tempRow1[i+k].blue & mask)
-                        v|=BIT_B2;
+                    // the sliced bits are in the same order as the RGB data pins
+                    v |= slicedRow[(i+k)*COLOR_DEPTH_BITS + j];
 
                     if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
                         // HUB12 format inverts the data (assume we're only using R1 for now), and OE signals
@@ -737,7 +880,7 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 }
 
                 i += numPixelsToMap; // keep track of current position on this temp buffer
-                advanceMultiRowRefreshMapToNextPixelGroup();
+                advanceMultiRowRefreshMapToNextPixelGroup(worker);
             }
 
             // TODO: insert latch data for all color depth bits all at once at the end, saving a few cycles?
@@ -806,29 +949,31 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
 
         c += numPixelsPerTempRow; // keep track of cumulative number of pixels filled in refresh buffer before this temp buffer
 
-        advanceMultiRowRefreshMapToNextRow();
-        multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
+        advanceMultiRowRefreshMapToNextRow(worker);
+        multiRowRefreshRowOffset = getMultiRowRefreshRowOffset(worker);
     } while (multiRowRefreshRowOffset > 0);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
-INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers24(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts) {
+INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers24(frameStruct * frameBuffer, int currentRow, int lsbMsbTransitionBit, int numBrightnessShifts, int worker) {
     int i;
     int multiRowRefreshRowOffset = 0;
     int numPixelsPerTempRow = PIXELS_PER_LATCH/PHYSICAL_ROWS_PER_REFRESH_ROW;
 
 #if defined(ESP32)
     // use buffers malloc'd previously
-    rgb24 * tempRow0 = (rgb24*)tempRow0Ptr;
-    rgb24 * tempRow1 = (rgb24*)tempRow1Ptr;
+    rgb24 * tempRow0 = (rgb24*)tempRow0Ptr[worker];
+    rgb24 * tempRow1 = (rgb24*)tempRow1Ptr[worker];
+    uint8_t * slicedRow = slicedRowPtr[worker];
 #else
     // static to avoid putting large buffer on the stack
     static rgb24 tempRow0[numPixelsPerTempRow];
     static rgb24 tempRow1[numPixelsPerTempRow];
+    static uint8_t slicedRow[COLOR_DEPTH_BITS * numPixelsPerTempRow];
 #endif
 
     int c = 0;
-    resetMultiRowRefreshMapPosition();
+    resetMultiRowRefreshMapPosition(worker);
 
     // go through this process for each physical row that is contained in the refresh row
     do {
@@ -844,62 +989,57 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
                     (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     // fill data from bottom to top, so bottom panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                 // Z-shape, top to bottom
                 } else if(!(optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
                     !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     // fill data from top to bottom, so top panel is the one closest to Teensy
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + i*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                    templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + i*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + i*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                    fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + i*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                 // C-shape, bottom to top
                 } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) &&
                     (optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     // alternate direction of filling (or loading) for each matrixwidth
                     // swap row order from top to bottom for each stack (tempRow1 filled with top half of panel, tempRow0 filled with bottom half)
                     if((MATRIX_STACK_HEIGHT-i+1)%2) {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     } else {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + (i)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (i)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     }
                 // C-shape, top to bottom
                 } else if((optionFlags & SMARTMATRIX_OPTIONS_C_SHAPE_STACKING) && 
                     !(optionFlags & SMARTMATRIX_OPTIONS_BOTTOM_TO_TOP_STACKING)) {
                     if((MATRIX_STACK_HEIGHT-i)%2) {
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (currentRow + multiRowRefreshRowOffset) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     } else {
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts);
-                        templayer->fillRefreshRow((MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + ROW_PAIR_OFFSET + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow0[i*matrixWidth], numBrightnessShifts, worker);
+                        fillRefreshRowFromLayer(templayer, currentRow, (MATRIX_SCAN_MOD-(currentRow + multiRowRefreshRowOffset)-1) + (MATRIX_STACK_HEIGHT-i-1)*MATRIX_PANEL_HEIGHT, &tempRow1[i*matrixWidth], numBrightnessShifts, worker);
                     }
                 }
             }
             templayer = templayer->nextLayer;        
         }
-  
+
+        // slice the data bits of every bitplane out of each pixel pair at once, instead of masking the channels once per bitplane
+        static_assert(BIT_R1 == BITSLICE_R1_BIT && BIT_G1 == BITSLICE_G1_BIT && BIT_B1 == BITSLICE_B1_BIT &&
+            BIT_R2 == BITSLICE_R2_BIT && BIT_G2 == BITSLICE_G2_BIT && BIT_B2 == BITSLICE_B2_BIT, "RGB data pins must be in bit slice order");
+        bitSliceRow<COLOR_DEPTH_BITS, 0>(tempRow0, tempRow1, numPixelsPerTempRow, slicedRow);
+
         for(int j=0; j<COLOR_DEPTH_BITS; j++) {
-            int maskoffset = 0;
-            if(COLOR_DEPTH_BITS == 12)   // 36-bit color
-                maskoffset = 4;
-            else if (COLOR_DEPTH_BITS == 16) // 48-bit color
-                maskoffset = 0;
-            else if (COLOR_DEPTH_BITS == 8)  // 24-bit color
-                maskoffset = 0;
-
-            uint16_t mask = (1 << (j + maskoffset));
-            
             SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::rowBitStruct *p=&(frameBuffer->rowdata[currentRow].rowbits[j]); //bitplane location to write to
             
             int i=0;
 
             // reset pixel map offset so we start filling from the first panel again
-            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow();
+            resetMultiRowRefreshMapPositionPixelGroupToStartOfRow(worker);
 
             while(i < numPixelsPerTempRow) {
                 // get number of pixels to go through with current pass
-                int numPixelsToMap = getMultiRowRefreshNumPixelsToMap();
+                int numPixelsToMap = getMultiRowRefreshNumPixelsToMap(worker);
 
                 bool reversePixelBlock = false;
                 if(numPixelsToMap < 0) {
@@ -908,7 +1048,7 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 }
 
                 // get offset where pixels are written in the refresh buffer
-                int currentMapOffset = getMultiRowRefreshPixelGroupOffset();
+                int currentMapOffset = getMultiRowRefreshPixelGroupOffset(worker);
 
                 // parse through grouping of pixels, loading from temp buffer and writing to refresh buffer
                 for(int k=0; k < numPixelsToMap; k++) {
@@ -966,18 +1106,8 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                     if((refreshBufferPosition)>=PIXELS_PER_LATCH-2) v|=BIT_OE;
 #endif
 
-                    if (tempRow0[i+k].red & mask)
-                        v|=BIT_R1;
-                    if (tempRow0[i+k].green & mask)
-                        v|=BIT_G1;
-                    if (tempRow0[i+k].blue & mask)
-                        v|=BIT_B1;
-                    if (tempRow1[i+k].red & mask)
-                        v|=BIT_R2;
-                    if (tempRow1[i+k].green & mask)
-                        v|=BIT_G2;
-                    if (tempRow1[i+k].blue & mask)
-                        v|=BIT_B2;
+                    // the sliced bits are in the same order as the RGB data pins
+                    v |= slicedRow[(i+k)*COLOR_DEPTH_BITS + j];
 
                     if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
                         // HUB12 format inverts the data (assume we're only using R1 for now), and OE signals
@@ -1022,7 +1152,7 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 }
 
                 i += numPixelsToMap; // keep track of current position on this temp buffer
-                advanceMultiRowRefreshMapToNextPixelGroup();
+                advanceMultiRowRefreshMapToNextPixelGroup(worker);
             }
 
 #if (CLKS_DURING_LATCH > 0)
@@ -1081,26 +1211,50 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
 
         c += numPixelsPerTempRow; // keep track of cumulative number of pixels filled in refresh buffer before this temp buffer
 
-        advanceMultiRowRefreshMapToNextRow();
-        multiRowRefreshRowOffset = getMultiRowRefreshRowOffset();
+        advanceMultiRowRefreshMapToNextRow(worker);
+        multiRowRefreshRowOffset = getMultiRowRefreshRowOffset(worker);
     } while (multiRowRefreshRowOffset > 0);
 }
 
 template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
 INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadMatrixBuffers(int lsbMsbTransitionBit, int numBrightnessShifts) {
 #if 1
-    unsigned char currentRow;
+    int frameBufferIndex = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextFrameBufferIndex();
 
-    frameStruct * currentFrameDataPtr = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextFrameBufferPtr();
+    queuedFrameDataPtr = SmartMatrixHub75Refresh<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::getNextFrameBufferPtr();
+    queuedLsbMsbTransitionBit = lsbMsbTransitionBit;
+    queuedNumBrightnessShifts = numBrightnessShifts;
 
-    for(currentRow = 0; currentRow < MATRIX_SCAN_MOD; currentRow++) {
+    // only the refresh rows the frame buffer doesn't already hold from the last time it was loaded are queued
+    rqInit(&rowQueue, MATRIX_SCAN_MOD, staleRefreshRows[frameBufferIndex]);
+
+    // both workers claim rows from the queue until it's empty, the frame buffer isn't handed to refresh until both are done
+    if(getNumCalcWorkers() > 1)
+        xSemaphoreGive(calcWorkerSemaphore);
+
+    loadQueuedRows(0);
+
+    if(getNumCalcWorkers() > 1)
+        xSemaphoreTake(calcWorkerDoneSemaphore, portMAX_DELAY);
+
+    staleRefreshRows[frameBufferIndex] = 0;
+#endif
+}
+
+template <int refreshDepth, int matrixWidth, int matrixHeight, unsigned char panelType, uint32_t optionFlags>
+void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelType, optionFlags>::loadQueuedRows(int worker) {
+    int currentRow;
+    uint32_t startMicros = micros();
+
+    while((currentRow = rqClaim(&rowQueue)) >= 0) {
         // TODO: support rgb36/48 with same function, copy function to rgb24
         if(COLOR_DEPTH_BITS == 16)
-            loadMatrixBuffers48(currentFrameDataPtr, currentRow, lsbMsbTransitionBit, numBrightnessShifts);
+            loadMatrixBuffers48(queuedFrameDataPtr, currentRow, queuedLsbMsbTransitionBit, queuedNumBrightnessShifts, worker);
         else if(COLOR_DEPTH_BITS == 12)
-            loadMatrixBuffers48(currentFrameDataPtr, currentRow, lsbMsbTransitionBit, numBrightnessShifts);
+            loadMatrixBuffers48(queuedFrameDataPtr, currentRow, queuedLsbMsbTransitionBit, queuedNumBrightnessShifts, worker);
         else if(COLOR_DEPTH_BITS == 8)
-            loadMatrixBuffers24(currentFrameDataPtr, currentRow, lsbMsbTransitionBit, numBrightnessShifts);
+            loadMatrixBuffers24(queuedFrameDataPtr, currentRow, queuedLsbMsbTransitionBit, queuedNumBrightnessShifts, worker);
     }
-#endif
+
+    __atomic_fetch_add(&calcWorkerBusyMicros[worker], micros() - startMicros, __ATOMIC_RELAXED);
 }
@@ -51,6 +51,7 @@ public:
 
     // refresh API
     static frameStruct * getNextFrameBufferPtr(void);
+    static int getNextFrameBufferIndex(void);
     static void writeFrameBuffer(uint8_t currentFrame);
     static void recoverFromDmaUnderrun(void);
     static bool isFrameBufferFree(void);
@@ -21,63 +21,63 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <stddef.h>
+#include <string.h>
 #include "MatrixFontCommon.h"
 
-// depends on letters in font->Index table being arranged in ascending order
-// save location of last lookup to speed up repeated lookups of the same letter
-// TODO: use successive approximation to located index faster
+// the built-in fonts come with a table of every letter's location, other fonts are searched
 int getBitmapFontLocation(unsigned char letter, const bitmap_font *font) {
-    static int location = 0;
-
-    if(location < 0)
-        location = 0;
-
-    if(font->Index[location] == letter)
-        return location;
-
-    if(font->Index[location] < letter) {
-        for (; location < font->Chars; location++) {
-            if (font->Index[location] == letter)
-                return location;
-        }
-    } else {
-        for (; location >= 0; location--) {
-            if (font->Index[location] == letter)
-                return location;
-        }
+    int i;
+
+    if (font->Locations)
+        return font->Locations[letter];
+
+    for (i = 0; i < font->Chars; i++) {
+        if (font->Index[i] == letter)
+            return i;
     }
 
     return -1;
 }
 
+// returns font->Height rows of the glyph, one byte per row with the leftmost pixel in the MSB, or NULL if the font doesn't have the letter
+const unsigned char *getBitmapFontGlyph(unsigned char letter, const bitmap_font *font) {
+    int location = getBitmapFontLocation(letter, font);
+
+    if (location < 0)
+        return NULL;
+
+    return &font->Bitmap[location * font->Height];
+}
+
 bool getBitmapFontPixelAtXY(unsigned char letter, unsigned char x, unsigned char y, const bitmap_font *font)
 {
-    int location;
+    const unsigned char *glyph;
     if (y >= font->Height)
         return false;
 
-    location = getBitmapFontLocation(letter, font);
+    glyph = getBitmapFontGlyph(letter, font);
 
-    if (location < 0)
+    if (!glyph)
         return false;
 
-    if (font->Bitmap[(location * font->Height) + y] & (0x80 >> x))
+    if (glyph[y] & (0x80 >> x))
         return true;
     else
         return false;
 }
 
 uint16_t getBitmapFontRowAtXY(unsigned char letter, unsigned char y, const bitmap_font *font) {
-    int location;
+    const unsigned char *glyph;
     if (y >= font->Height)
         return 0x0000;
 
-    location = getBitmapFontLocation(letter, font);
+    glyph = getBitmapFontGlyph(letter, font);
 
-    if (location < 0)
+    if (!glyph)
         return 0x0000;
 
-    return(font->Bitmap[(location * font->Height) + y]);
+    return(glyph[y]);
 }
 
 bool getBitmapPixelAtXY(uint8_t x, uint8_t y, uint8_t width, uint8_t height, const uint8_t *bitmap) {
@@ -35,6 +35,7 @@ typedef struct bitmap_font {
 	const unsigned char *Widths;	///< width of each character
 	const unsigned short *Index;	///< encoding to character index
 	const unsigned char *Bitmap;	///< bitmap of all characters
+	const short *Locations;		///< character index of encodings 0-255, -1 if missing, NULL to search Index (last, so positional initializers leave it NULL)
 } bitmap_font;
 
 
@@ -57,6 +58,7 @@ typedef enum fontChoices {
 bool getBitmapFontPixelAtXY(unsigned char letter, unsigned char x, unsigned char y, const bitmap_font *font);
 const bitmap_font *fontLookup(fontChoices font);
 uint16_t getBitmapFontRowAtXY(unsigned char letter, unsigned char y, const bitmap_font *font);
+const unsigned char *getBitmapFontGlyph(unsigned char letter, const bitmap_font *font);
 bool getBitmapPixelAtXY(uint8_t x, uint8_t y, uint8_t width, uint8_t height, const uint8_t *bitmap);
 
 /// @{ defines to have human readable font files
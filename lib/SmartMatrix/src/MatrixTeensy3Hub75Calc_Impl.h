@@ -352,6 +352,7 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
     // static to avoid putting large buffer on the stack
     static RGB_TEMP tempRow0[numPixelsPerTempRow];
     static RGB_TEMP tempRow1[numPixelsPerTempRow];
+    static RGB_TEMP layerScratchRow[2 * matrixWidth];
 
     int c = 0;
 
@@ -416,8 +417,8 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                         y0 = y1 + ROW_PAIR_OFFSET;
                     }
                 }
-                templayer->fillRefreshRow(y0, &tempRow0[i * matrixWidth]);
-                templayer->fillRefreshRow(y1, &tempRow1[i * matrixWidth]);
+                templayer->composeRefreshRow(y0, &tempRow0[i * matrixWidth], layerScratchRow);
+                templayer->composeRefreshRow(y1, &tempRow1[i * matrixWidth], layerScratchRow);
             }
             templayer = templayer->nextLayer;        
         }
@@ -493,36 +494,26 @@ INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight, panelT
                 g1 = tempRow1[ind].green;
                 b1 = tempRow1[ind].blue;
 
-                // loop through each bitplane in the current pixel's RGB values and format the bits to match the FlexIO pin configuration
-                int sizeOfSourceColor = (sizeof(RGB_TEMP) <= 3) ? 8 : 16;
-                uint8_t shift = (sizeOfSourceColor - COLOR_DEPTH_BITS);
-                uint16_t mask = 1 << shift;
+                // slice the data bits of every bitplane out of the current pixel's RGB values at once, then format the bits of each bitplane to match the pin configuration
+                const int sizeOfSourceColor = (sizeof(RGB_TEMP) <= 3) ? 8 : 16;
+                uint8_t planes[COLOR_DEPTH_BITS];
+                bitSliceChannels<COLOR_DEPTH_BITS, sizeOfSourceColor - COLOR_DEPTH_BITS>(r0, g0, b0, r1, g1, b1, planes);
 
                 for (int bitindex = 0; bitindex < COLOR_DEPTH_BITS; bitindex++) {
+                    uint8_t dataBits = planes[bitindex];
                     o0.word = 0x00;
 
-                    if (r0 & mask)
-                        o0.hub75_r0 = 1;
-                    if (g0 & mask)
-                        o0.hub75_g0 = 1;
-                    if (b0 & mask)
-                        o0.hub75_b0 = 1;
-                    if (r1 & mask)
-                        o0.hub75_r1 = 1;
-                    if (g1 & mask)
-                        o0.hub75_g1 = 1;
-                    if (b1 & mask)
-                        o0.hub75_b1 = 1;
+                    o0.hub75_r0 = !!(dataBits & BITSLICE_R1_BIT);
+                    o0.hub75_g0 = !!(dataBits & BITSLICE_G1_BIT);
+                    o0.hub75_b0 = !!(dataBits & BITSLICE_B1_BIT);
+                    o0.hub75_r1 = !!(dataBits & BITSLICE_R2_BIT);
+                    o0.hub75_g1 = !!(dataBits & BITSLICE_G2_BIT);
+                    o0.hub75_b1 = !!(dataBits & BITSLICE_B2_BIT);
 
                     if(optionFlags & SMARTMATRIX_OPTIONS_HUB12_MODE) {
                         // HUB12 format inverts the data (assume we're only using R1 for now)
-                        if (r0 & mask)
-                            o0.hub75_r0 = 0;
-                        else
-                            o0.hub75_r0 = 1;                        
-                    }               
-
-                    mask <<= 1;
+                        o0.hub75_r0 = !(dataBits & BITSLICE_R1_BIT);
+                    }
 
                     // store these pixel bits in the rowDataBuffer, leaving the initial pixels as padding
                     currentRowDataPtr->rowbits[bitindex].data[((refreshBufferPosition)*DMA_UPDATES_PER_CLOCK)] = o0.word;
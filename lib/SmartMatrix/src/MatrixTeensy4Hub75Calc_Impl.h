@@ -370,6 +370,7 @@ FASTRUN INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight
     // Temporary buffers to store rgb pixel data for reformatting (static to avoid putting large buffer on the stack)
     static rgb48 tempRow0[numPixelsPerTempRow];
     static rgb48 tempRow1[numPixelsPerTempRow];
+    static rgb48 layerScratchRow[2 * matrixWidth];
 
     int c = 0;
 
@@ -436,8 +437,8 @@ FASTRUN INLINE void SmartMatrixHub75Calc<refreshDepth, matrixWidth, matrixHeight
                         y0 = y1 + ROW_PAIR_OFFSET;
                     }
                 }
-                templayer->fillRefreshRow(y0, &tempRow0[i * matrixWidth]);
-                templayer->fillRefreshRow(y1, &tempRow1[i * matrixWidth]);
+                templayer->composeRefreshRow(y0, &tempRow0[i * matrixWidth], layerScratchRow);
+                templayer->composeRefreshRow(y1, &tempRow1[i * matrixWidth], layerScratchRow);
             }
             templayer = templayer->nextLayer;
         }
@@ -0,0 +1,41 @@
+#ifndef _SMARTMATRIX_ROWQUEUE_H_
+#define _SMARTMATRIX_ROWQUEUE_H_
+
+#include <stdint.h>
+
+/* Queue of refresh rows shared by the workers loading a frame buffer
+ *
+ * Workers claim one row at a time instead of getting a fixed half of the rows, so a worker slowed down by other
+ * tasks on its core ends up loading fewer rows instead of holding up the frame.  Rows that aren't in the mask are
+ * skipped without being handed out.  Claiming is a single atomic add, so there is no lock and the workers don't
+ * need to know about each other.
+ *
+ * The functions don't depend on FreeRTOS, the queue can be exercised on a host with threads standing in for tasks.
+ */
+typedef struct {
+    uint32_t    rows;       /* bit per refresh row to be loaded     */
+    int         numRows;    /* number of refresh rows, 32 at most   */
+    int         next;       /* next refresh row to claim            */
+} RowQueue_SM;
+
+/* call before handing the queue to the workers, the workers must be started after this (e.g. by giving a semaphore) */
+static inline void rqInit(RowQueue_SM *rq, int numRows, uint32_t rows) {
+    rq->rows = rows;
+    rq->numRows = numRows;
+    __atomic_store_n(&rq->next, 0, __ATOMIC_RELEASE);
+}
+
+/* returns the next refresh row to load, or -1 when all rows are claimed */
+static inline int rqClaim(RowQueue_SM *rq) {
+    for (;;) {
+        int row = __atomic_fetch_add(&rq->next, 1, __ATOMIC_ACQ_REL);
+
+        if (row >= rq->numRows)
+            return -1;
+
+        if (rq->rows & ((uint32_t)1 << row))
+            return row;
+    }
+}
+
+#endif
@@ -49,10 +49,13 @@
 
 #include "MatrixCommon.h"
 #include "CircularBuffer_SM.h"
+#include "RowQueue_SM.h"
+#include "BitSlice_SM.h"
 
 #include "Layer_Scrolling.h"
 #include "Layer_Indexed.h"
 #include "Layer_Background.h"
+#include "Layer_Sprites.h"
 
 // For backwards compatiblity, this needs to be defined at the top of the sketch, so that "Adafruit_GFX.h" is only included if desired
 #ifdef USE_ADAFRUIT_GFX_LAYERS
@@ -206,6 +209,17 @@
 #endif
 #endif
 
+#if defined(ESP32)
+    #define SMARTMATRIX_ALLOCATE_SPRITES_LAYER(layer_name, width, height, storage_depth, max_sprites, sprites_options) \
+        typedef RGB_TYPE(storage_depth) SM_RGB;                                                                 \
+        static SMLayerSprites<RGB_TYPE(storage_depth), sprites_options> layer_name(max_sprites, width, height)  
+#else
+    #define SMARTMATRIX_ALLOCATE_SPRITES_LAYER(layer_name, width, height, storage_depth, max_sprites, sprites_options) \
+        typedef RGB_TYPE(storage_depth) SM_RGB;                                                                 \
+        static SM_SpriteSlot layer_name##Slots[max_sprites];                                              \
+        static SMLayerSprites<RGB_TYPE(storage_depth), sprites_options> layer_name(layer_name##Slots, max_sprites, width, height)  
+#endif
+
 // platform-specific
 #if defined(__arm__) && defined(CORE_TEENSY) && !defined(__IMXRT1062__)  // Teensy 3.x
     #include "MatrixTeensy3Hub75Refresh_Impl.h"
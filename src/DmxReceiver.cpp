@@ -0,0 +1,276 @@
+/*
+  DmxReceiver.cpp
+  Realtime E1.31 (sACN) and Art-Net receiver.
+*/
+#include "DmxReceiver.h"
+
+static_assert(DMX_JITTER_DEPTH < DMX_JITTER_SLOTS, "the jitter buffer needs a slot to receive into");
+
+#define ARTNET_HEADER_SIZE 18
+#define ARTNET_OP_DMX 0x5000
+#define ARTNET_OP_SYNC 0x5200
+
+#define E131_HEADER_SIZE 126
+#define E131_SYNC_SIZE 49
+#define E131_VECTOR_ROOT_DATA 0x00000004
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_VECTOR_FRAMING_DATA 0x00000002
+#define E131_VECTOR_FRAMING_SYNC 0x00000001
+#define E131_OPTION_PREVIEW 0x80
+#define E131_OPTION_TERMINATED 0x40
+
+static inline uint16_t be16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+static inline uint32_t be32(const uint8_t *p) { return ((uint32_t)be16(p) << 16) | be16(p + 2); }
+
+bool DmxReceiver::begin(DmxProtocol protocol, uint16_t count, uint16_t firstUniverse)
+{
+  end();
+  _universes = (count + DMX_LEDS_PER_UNIVERSE - 1) / DMX_LEDS_PER_UNIVERSE;
+  if (protocol == DMX_OFF || count == 0 || _universes > DMX_MAX_UNIVERSES)
+  {
+    return false;
+  }
+
+  _ring = (CRGB *)calloc((size_t)DMX_JITTER_SLOTS * count, sizeof(CRGB));
+  if (!_ring)
+  {
+    return false;
+  }
+  if (!_udp.begin(protocol == DMX_ARTNET ? DMX_ARTNET_PORT : DMX_E131_PORT))
+  {
+    free(_ring);
+    _ring = nullptr;
+    return false;
+  }
+
+  _protocol = protocol;
+  _count = count;
+  _firstUniverse = firstUniverse;
+  _received = 0;
+  _read = 0;
+  _queued = 0;
+  _latch = false;
+  _playing = false;
+  _syncAddress = 0;
+  _lastSync = millis() - DMX_SYNC_TIMEOUT_MS;
+  _lastFrame = 0;
+  _period = 25; // 40 fps until measured
+  frames = overruns = underruns = syncs = 0;
+  return true;
+}
+
+void DmxReceiver::end()
+{
+  if (_protocol == DMX_OFF)
+  {
+    return;
+  }
+  _udp.stop();
+  free(_ring);
+  _ring = nullptr;
+  _protocol = DMX_OFF;
+}
+
+void DmxReceiver::handle()
+{
+  for (uint8_t i = 0; active() && i < DMX_MAX_PACKETS; i++)
+  {
+    int size = _udp.parsePacket();
+    if (size <= 0)
+    {
+      break;
+    }
+    if (_protocol == DMX_ARTNET)
+    {
+      _receiveArtnet(size);
+    }
+    else
+    {
+      _receiveE131(size);
+    }
+    _udp.flush();
+  }
+}
+
+bool DmxReceiver::_receiveArtnet(int size)
+{
+  uint8_t h[ARTNET_HEADER_SIZE];
+  if (size < 12 || _udp.read(h, 12) != 12 || memcmp(h, "Art-Net", 8))
+  {
+    return false;
+  }
+
+  uint16_t op = h[8] | (h[9] << 8);
+  if (op == ARTNET_OP_SYNC)
+  {
+    syncs++;
+    _lastSync = millis();
+    _complete(true);
+    return true;
+  }
+  if (op != ARTNET_OP_DMX || size < ARTNET_HEADER_SIZE || _udp.read(h + 12, ARTNET_HEADER_SIZE - 12) != ARTNET_HEADER_SIZE - 12)
+  {
+    return false;
+  }
+
+  // 15 bit port address: Net, Sub-Net and Universe
+  uint16_t universe = h[14] | ((h[15] & 0x7f) << 8);
+  uint16_t length = std::min<int>(be16(h + 16), size - ARTNET_HEADER_SIZE);
+  _receiveUniverse(universe, length);
+  return true;
+}
+
+bool DmxReceiver::_receiveE131(int size)
+{
+  uint8_t h[E131_HEADER_SIZE];
+  if (size < E131_SYNC_SIZE || _udp.read(h, E131_SYNC_SIZE) != E131_SYNC_SIZE || memcmp(h + 4, "ASC-E1.17", 10))
+  {
+    return false;
+  }
+
+  uint32_t rootVector = be32(h + 18);
+  uint32_t framingVector = be32(h + 40);
+  if (rootVector == E131_VECTOR_ROOT_EXTENDED && framingVector == E131_VECTOR_FRAMING_SYNC)
+  {
+    if (_syncAddress && be16(h + 45) == _syncAddress)
+    {
+      syncs++;
+      _lastSync = millis();
+      _complete(true);
+    }
+    return true;
+  }
+  if (rootVector != E131_VECTOR_ROOT_DATA || framingVector != E131_VECTOR_FRAMING_DATA || size < E131_HEADER_SIZE ||
+      _udp.read(h + E131_SYNC_SIZE, E131_HEADER_SIZE - E131_SYNC_SIZE) != E131_HEADER_SIZE - E131_SYNC_SIZE)
+  {
+    return false;
+  }
+
+  // Only live DMX levels (start code 0) are shown
+  if ((h[112] & (E131_OPTION_PREVIEW | E131_OPTION_TERMINATED)) || h[125] != 0)
+  {
+    return false;
+  }
+  // The property count includes the start code
+  uint16_t properties = be16(h + 123);
+  if (properties < 1)
+  {
+    return false;
+  }
+  _syncAddress = be16(h + 109);
+  uint16_t channels = std::min<int>(properties - 1, size - E131_HEADER_SIZE);
+  _receiveUniverse(be16(h + 113), channels);
+  return true;
+}
+
+void DmxReceiver::_receiveUniverse(uint16_t universe, uint16_t channels)
+{
+  if (universe < _firstUniverse || universe >= _firstUniverse + _universes)
+  {
+    return;
+  }
+
+  bool syncing = millis() - _lastSync < DMX_SYNC_TIMEOUT_MS;
+  uint8_t u = universe - _firstUniverse;
+  uint32_t bit = 1UL << u;
+
+  // A repeated universe starts the next frame, unless the sync packet
+  // decides where frames end
+  if ((_received & bit) && !syncing)
+  {
+    _complete(false);
+  }
+
+  // The channel data goes straight from the UDP buffer into the frame
+  uint16_t start = u * DMX_LEDS_PER_UNIVERSE;
+  uint16_t n = std::min<uint16_t>(channels / 3, _count - start);
+  _udp.read((uint8_t *)(_slot(_queued) + start), n * sizeof(CRGB));
+  _received |= bit;
+
+  uint32_t all = (_universes == 32) ? 0xffffffffUL : (1UL << _universes) - 1;
+  if (_received == all && !syncing)
+  {
+    _complete(false);
+  }
+}
+
+void DmxReceiver::_complete(bool synced)
+{
+  if (!_received)
+  {
+    return;
+  }
+
+  uint32_t now = millis();
+  if (_lastFrame)
+  {
+    _period = (_period * 7 + (now - _lastFrame)) / 8;
+  }
+  _lastFrame = now;
+  frames++;
+
+  CRGB *done = _slot(_queued);
+  if (_queued == DMX_JITTER_SLOTS - 1)
+  {
+    // Drop the oldest frame to free a slot
+    _read = (_read + 1) % DMX_JITTER_SLOTS;
+    _queued--;
+    overruns++;
+  }
+  _queued++;
+
+  // Universes that are not resent keep their values in the next frame
+  memcpy(_slot(_queued), done, _count * sizeof(CRGB));
+  _received = 0;
+  _latch |= synced;
+}
+
+bool DmxReceiver::render(CRGB *leds)
+{
+  if (!active())
+  {
+    return false;
+  }
+
+  uint32_t now = millis();
+  if (_latch)
+  {
+    // Show the synced frame now, skipping anything older
+    _read = (_read + _queued - 1) % DMX_JITTER_SLOTS;
+    _queued = 1;
+    _latch = false;
+    _playing = false;
+  }
+  else
+  {
+    if (!_playing)
+    {
+      if (_queued < DMX_JITTER_DEPTH || _queued == 0)
+      {
+        return false;
+      }
+      _playing = true;
+      _nextPlay = now;
+    }
+    if ((int32_t)(now - _nextPlay) < 0)
+    {
+      return false;
+    }
+    if (_queued == 0)
+    {
+      underruns++;
+      _playing = false;
+      return false;
+    }
+    _nextPlay += _period;
+    if ((int32_t)(now - _nextPlay) > (int32_t)_period)
+    {
+      _nextPlay = now + _period;
+    }
+  }
+
+  memcpy(leds, _slot(0), _count * sizeof(CRGB));
+  _read = (_read + 1) % DMX_JITTER_SLOTS;
+  _queued--;
+  return true;
+}
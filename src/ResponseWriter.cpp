@@ -0,0 +1,72 @@
+/*
+  ResponseWriter.cpp
+  Append-only HTTP response writer backed by a fixed arena.
+*/
+#include "ResponseWriter.h"
+
+char ResponseWriter::_arena[RESPONSE_ARENA_SIZE];
+
+void ResponseWriter::begin(int code, const char *contentType)
+{
+  _len = 0;
+  _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _server.send(code, contentType, emptyString);
+  _started = true;
+}
+
+void ResponseWriter::begin(int code, const __FlashStringHelper *contentType)
+{
+  _len = 0;
+  _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _server.send(code, contentType, emptyString);
+  _started = true;
+}
+
+void ResponseWriter::end()
+{
+  if (!_started)
+  {
+    return;
+  }
+  _flush();
+  // A zero length chunk terminates a chunked body, and is a no-op otherwise
+  _server.chunkedResponseFinalize();
+  _started = false;
+}
+
+size_t ResponseWriter::write(uint8_t c)
+{
+  if (_len == sizeof(_arena))
+  {
+    _flush();
+  }
+  _arena[_len++] = (char)c;
+  return 1;
+}
+
+size_t ResponseWriter::write(const uint8_t *buf, size_t size)
+{
+  size_t written = size;
+  while (size)
+  {
+    if (_len == sizeof(_arena))
+    {
+      _flush();
+    }
+    size_t n = std::min(size, sizeof(_arena) - _len);
+    memcpy(_arena + _len, buf, n);
+    _len += n;
+    buf += n;
+    size -= n;
+  }
+  return written;
+}
+
+void ResponseWriter::_flush()
+{
+  if (_len)
+  {
+    _server.sendContent(_arena, _len);
+    _len = 0;
+  }
+}
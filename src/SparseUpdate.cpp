@@ -0,0 +1,104 @@
+/*
+  SparseUpdate.cpp
+  UDP listener for partial LED updates.
+*/
+#include "SparseUpdate.h"
+
+bool SparseUpdate::begin(CRGB *leds, uint16_t count, uint16_t port)
+{
+  _leds = leds;
+  _count = count;
+  _synced = false;
+  return _udp.begin(port);
+}
+
+bool SparseUpdate::handle()
+{
+  bool changed = false;
+  for (uint8_t i = 0; i < SPARSE_MAX_PACKETS; i++)
+  {
+    int size = _udp.parsePacket();
+    if (size <= 0)
+    {
+      break;
+    }
+    changed |= _apply(size);
+    _udp.flush();
+  }
+  return changed;
+}
+
+bool SparseUpdate::_read16(uint16_t &v)
+{
+  uint8_t b[2];
+  if (_udp.read(b, sizeof(b)) != sizeof(b))
+  {
+    return false;
+  }
+  v = b[0] | (b[1] << 8);
+  return true;
+}
+
+bool SparseUpdate::_apply(int size)
+{
+  uint8_t header[6];
+  if (size < (int)sizeof(header) || _udp.read(header, sizeof(header)) != sizeof(header) ||
+      header[0] != 'L' || header[1] != 'S' || header[2] != SPARSE_VERSION)
+  {
+    malformed++;
+    return false;
+  }
+
+  uint16_t seq = header[4] | (header[5] << 8);
+  if (_synced && (int16_t)(seq - _seq) <= 0 && millis() - _lastAccept < SPARSE_RESYNC_MS)
+  {
+    stale++;
+    return false;
+  }
+  _seq = seq;
+  _synced = true;
+  _lastAccept = millis();
+  accepted++;
+
+  bool changed = false;
+  int op;
+  while ((op = _udp.read()) >= 0)
+  {
+    uint16_t start, count;
+    if (!_read16(start) || !_read16(count) || start > _count || count > _count - start)
+    {
+      malformed++;
+      break;
+    }
+
+    if (op == SPARSE_RECORD_RANGE)
+    {
+      // CRGB is three packed bytes in r, g, b order, so the payload can
+      // be received straight into the frame buffer
+      size_t len = count * sizeof(CRGB);
+      if ((size_t)_udp.read((uint8_t *)&_leds[start], len) != len)
+      {
+        malformed++;
+        changed = true;
+        break;
+      }
+    }
+    else if (op == SPARSE_RECORD_RUN)
+    {
+      CRGB colour;
+      if (_udp.read(colour.raw, sizeof(colour.raw)) != sizeof(colour.raw))
+      {
+        malformed++;
+        break;
+      }
+      fill_solid(&_leds[start], count, colour);
+    }
+    else
+    {
+      malformed++;
+      break;
+    }
+    changed = true;
+  }
+  return changed;
+}
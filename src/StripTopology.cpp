@@ -0,0 +1,396 @@
+/*
+  StripTopology.cpp
+  Runtime description of the LED strips attached to the controller.
+*/
+#include <ArduinoJson.h>
+#include "StripTopology.h"
+
+FASTLED_USING_NAMESPACE
+
+/*
+   FastLED.addLeds<> needs the chipset, pin and colour order at compile
+   time, so every combination that may be selected at runtime is
+   instantiated once here and dispatched through a table. Each entry
+   costs flash for its controller, so keep the lists to the pins that
+   are actually wired on the board.
+*/
+typedef CLEDController &(*AddLedsFn)(CRGB *data, int count);
+
+struct StripDriver
+{
+  uint8_t chipset;
+  uint8_t pin;
+  EOrder order;
+  AddLedsFn addLeds;
+};
+
+template <template <uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t PIN, EOrder ORDER>
+static CLEDController &addLedsFor(CRGB *data, int count)
+{
+  return FastLED.addLeds<CHIPSET, PIN, ORDER>(data, count);
+}
+
+#define STRIP_DRIVER(chipset, pin, order) {STRIP_##chipset, pin, order, addLedsFor<chipset, pin, order>}
+#define STRIP_DRIVERS_FOR_PIN(pin)                                             \
+  STRIP_DRIVER(WS2812B, pin, GRB), STRIP_DRIVER(WS2812B, pin, RGB),            \
+      STRIP_DRIVER(WS2811, pin, RGB), STRIP_DRIVER(WS2811, pin, GRB),          \
+      STRIP_DRIVER(SK6812, pin, GRB), STRIP_DRIVER(SK6812, pin, RGB)
+
+// D5, D6 and D7 are taken by the MAX7219 matrix
+static const StripDriver drivers[] = {
+    STRIP_DRIVERS_FOR_PIN(1),
+    STRIP_DRIVERS_FOR_PIN(2),
+    STRIP_DRIVERS_FOR_PIN(3),
+    STRIP_DRIVERS_FOR_PIN(4),
+};
+
+#if TOPOLOGY_PARALLEL_LANES && defined(FASTLED_HAS_BLOCKLESS)
+/*
+   Block controller that sends the lane buffer rather than its own data.
+   It is registered on leds[] with the lane length, so FastLED.show()
+   hands it the logical buffer, which is scattered into the lanes first.
+   The WS2811_PORTA timings are used, which also suit WS2812B and SK6812.
+*/
+template <uint8_t LANES, EOrder ORDER>
+class MappedBlockController : public InlineBlockClocklessController<LANES, PORTA_FIRST_PIN, NS(320), NS(320), NS(640), ORDER>
+{
+  typedef InlineBlockClocklessController<LANES, PORTA_FIRST_PIN, NS(320), NS(320), NS(640), ORDER> Base;
+
+public:
+  explicit MappedBlockController(const StripTopology &topology) : _topology(topology) {}
+
+protected:
+  virtual void show(const struct CRGB *data, int nLeds, CRGB scale)
+  {
+    Base::show(_topology.scatter(data), nLeds, scale);
+  }
+
+private:
+  const StripTopology &_topology;
+};
+#endif
+
+static const StripDriver *findDriver(const StripSegment &seg)
+{
+  for (const StripDriver &d : drivers)
+  {
+    if (d.chipset == seg.chipset && d.pin == seg.pin && d.order == seg.order)
+    {
+      return &d;
+    }
+  }
+  return nullptr;
+}
+
+static const struct
+{
+  const char *name;
+  EOrder order;
+} orderNames[] = {
+    {"RGB", RGB},
+    {"RBG", RBG},
+    {"GRB", GRB},
+    {"GBR", GBR},
+    {"BRG", BRG},
+    {"BGR", BGR},
+};
+
+uint8_t StripTopology::chipsetFromName(const char *name)
+{
+  if (!strcmp(name, "WS2812B") || !strcmp(name, "WS2812"))
+  {
+    return STRIP_WS2812B;
+  }
+  if (!strcmp(name, "WS2811"))
+  {
+    return STRIP_WS2811;
+  }
+  if (!strcmp(name, "SK6812"))
+  {
+    return STRIP_SK6812;
+  }
+  return STRIP_UNKNOWN;
+}
+
+bool StripTopology::orderFromName(const char *name, EOrder &order)
+{
+  for (const auto &o : orderNames)
+  {
+    if (!strcmp(name, o.name))
+    {
+      order = o.order;
+      return true;
+    }
+  }
+  return false;
+}
+
+void StripTopology::reset(uint8_t chipset, uint8_t pin, EOrder order, uint16_t count)
+{
+  _segments = 0;
+  _parallel = false;
+  _append(_segment, _segments, chipset, pin, order, count);
+}
+
+bool StripTopology::_append(StripSegment *list, uint8_t &n, uint8_t chipset, uint8_t pin, EOrder order, uint16_t count)
+{
+  if (n >= TOPOLOGY_MAX_SEGMENTS || count == 0)
+  {
+    return false;
+  }
+  list[n].chipset = chipset;
+  list[n].pin = pin;
+  list[n].order = order;
+  list[n].offset = 0;
+  list[n].count = count;
+  list[n].reverse = false;
+  n++;
+  return true;
+}
+
+bool StripTopology::load(FS &fs, const char *path)
+{
+  File file = fs.open(path, "r");
+  if (!file)
+  {
+    return false;
+  }
+
+  StaticJsonDocument<TOPOLOGY_JSON_SIZE> doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  if (err)
+  {
+    Serial.printf("%s: %s\n", path, err.c_str());
+    return false;
+  }
+
+  StripSegment list[TOPOLOGY_MAX_SEGMENTS];
+  uint8_t n = 0;
+  uint32_t total = 0;
+  bool parallel = doc["parallel"] | false;
+  for (JsonObject seg : doc["segments"].as<JsonArray>())
+  {
+    // Parallel lanes are numbered in order rather than by pin
+    uint8_t pin = parallel ? n : (uint8_t)(seg["pin"] | 0);
+    uint16_t count = seg["count"] | 0;
+
+    // Later segments of a pin inherit its chipset and order, and so do
+    // all lanes of the block controller
+    const StripSegment *chained = nullptr;
+    for (uint8_t i = 0; i < n; i++)
+    {
+      if (list[i].pin == pin || parallel)
+      {
+        chained = &list[i];
+        break;
+      }
+    }
+
+    uint8_t chipset = chained ? chained->chipset : (uint8_t)STRIP_WS2812B;
+    EOrder order = chained ? chained->order : GRB;
+    if (seg.containsKey("chipset"))
+    {
+      chipset = chipsetFromName(seg["chipset"] | "");
+    }
+    if (seg.containsKey("order") && !orderFromName(seg["order"] | "", order))
+    {
+      Serial.printf("%s: bad order on pin %u\n", path, pin);
+      return false;
+    }
+    if (chipset == STRIP_UNKNOWN)
+    {
+      Serial.printf("%s: unknown chipset on pin %u\n", path, pin);
+      return false;
+    }
+    if (chained && (chained->chipset != chipset || chained->order != order))
+    {
+      Serial.printf("%s: segments on pin %u disagree on chipset or order\n", path, pin);
+      return false;
+    }
+    total += count;
+    if (total > TOPOLOGY_MAX_LEDS || !_append(list, n, chipset, pin, order, count))
+    {
+      Serial.printf("%s: too many segments or LEDs\n", path);
+      return false;
+    }
+    list[n - 1].reverse = seg["reverse"] | false;
+  }
+
+  if (n == 0)
+  {
+    return false;
+  }
+  if (parallel && (n > TOPOLOGY_PARALLEL_LANES || list[0].order != TOPOLOGY_PARALLEL_ORDER))
+  {
+    Serial.printf("%s: parallel output is built for %u lanes, order %03o\n", path, TOPOLOGY_PARALLEL_LANES, TOPOLOGY_PARALLEL_ORDER);
+    return false;
+  }
+  memcpy(_segment, list, n * sizeof(StripSegment));
+  _segments = n;
+  _parallel = parallel;
+  return true;
+}
+
+/*
+   Group the segments by pin, keeping the order in which pins first
+   appear, and assign their offsets in the LED buffer. Parallel lanes
+   have distinct pins and so keep their order.
+*/
+void StripTopology::_layout()
+{
+  StripSegment sorted[TOPOLOGY_MAX_SEGMENTS];
+  uint8_t n = 0;
+  uint16_t offset = 0;
+
+  for (uint8_t i = 0; i < _segments; i++)
+  {
+    bool seen = false;
+    for (uint8_t j = 0; j < i; j++)
+    {
+      seen |= (_segment[j].pin == _segment[i].pin);
+    }
+    if (seen)
+    {
+      continue;
+    }
+    for (uint8_t j = i; j < _segments; j++)
+    {
+      if (_segment[j].pin == _segment[i].pin)
+      {
+        sorted[n] = _segment[j];
+        sorted[n].offset = offset;
+        offset += sorted[n].count;
+        n++;
+      }
+    }
+  }
+  memcpy(_segment, sorted, n * sizeof(StripSegment));
+  _count = offset;
+}
+
+bool StripTopology::begin()
+{
+  if (_leds || _segments == 0)
+  {
+    return false;
+  }
+  if (_parallel)
+  {
+    return _beginParallel();
+  }
+
+  for (uint8_t i = 0; i < _segments; i++)
+  {
+    if (!findDriver(_segment[i]))
+    {
+      Serial.printf("No LED driver built for chipset %u, pin %u, order %03o\n", _segment[i].chipset, _segment[i].pin, _segment[i].order);
+      return false;
+    }
+  }
+
+  _layout();
+  _leds = (CRGB *)calloc(_count, sizeof(CRGB));
+  if (!_leds)
+  {
+    Serial.printf("Cannot allocate %u LEDs\n", _count);
+    _count = 0;
+    return false;
+  }
+
+  // One controller per pin, spanning all of its chained segments
+  uint8_t i = 0;
+  while (i < _segments)
+  {
+    uint8_t j = i;
+    uint16_t count = 0;
+    while (j < _segments && _segment[j].pin == _segment[i].pin)
+    {
+      count += _segment[j++].count;
+    }
+    findDriver(_segment[i])->addLeds(_leds + _segment[i].offset, count).setCorrection(TypicalLEDStrip);
+    i = j;
+  }
+  return true;
+}
+
+bool StripTopology::_beginParallel()
+{
+#if TOPOLOGY_PARALLEL_LANES && defined(FASTLED_HAS_BLOCKLESS)
+  _layout();
+  _laneLength = 0;
+  bool identity = (_segments == TOPOLOGY_PARALLEL_LANES);
+  for (uint8_t i = 0; i < _segments; i++)
+  {
+    _laneLength = std::max(_laneLength, _segment[i].count);
+    identity &= !_segment[i].reverse;
+  }
+  for (uint8_t i = 0; i < _segments; i++)
+  {
+    identity &= (_segment[i].count == _laneLength);
+  }
+
+  _leds = (CRGB *)calloc(_count, sizeof(CRGB));
+  _lanes = identity ? _leds : (CRGB *)calloc(TOPOLOGY_PARALLEL_LANES * _laneLength, sizeof(CRGB));
+  if (!_leds || !_lanes)
+  {
+    Serial.printf("Cannot allocate %u LEDs on %u lanes\n", _count, _segments);
+    free(_leds);
+    _leds = _lanes = nullptr;
+    _count = 0;
+    return false;
+  }
+
+  static MappedBlockController<TOPOLOGY_PARALLEL_LANES, TOPOLOGY_PARALLEL_ORDER> controller(*this);
+  FastLED.addLeds(&controller, _leds, _laneLength).setCorrection(TypicalLEDStrip);
+  return true;
+#else
+  Serial.println(F("Parallel output is not built, set TOPOLOGY_PARALLEL_LANES"));
+  return false;
+#endif
+}
+
+uint16_t StripTopology::physicalIndex(uint16_t i) const
+{
+  if (!_parallel)
+  {
+    return i;
+  }
+  for (uint8_t s = 0; s < _segments; s++)
+  {
+    const StripSegment &seg = _segment[s];
+    if (i < seg.offset + seg.count)
+    {
+      uint16_t j = i - seg.offset;
+      return s * _laneLength + (seg.reverse ? seg.count - 1 - j : j);
+    }
+  }
+  return i;
+}
+
+const CRGB *StripTopology::scatter(const CRGB *data) const
+{
+  if (_lanes == data)
+  {
+    return data;
+  }
+  // Padding at the end of short lanes and unused lanes stay black
+  for (uint8_t s = 0; s < _segments; s++)
+  {
+    const StripSegment &seg = _segment[s];
+    const CRGB *src = data + seg.offset;
+    CRGB *dst = _lanes + s * _laneLength;
+    if (seg.reverse)
+    {
+      for (uint16_t j = 0; j < seg.count; j++)
+      {
+        dst[seg.count - 1 - j] = src[j];
+      }
+    }
+    else
+    {
+      memcpy(dst, src, seg.count * sizeof(CRGB));
+    }
+  }
+  return _lanes;
+}
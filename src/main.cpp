@@ -34,6 +34,10 @@ typedef ESP8266WebServer WiFiWebServer;
 typedef WebServer WiFiWebServer;
 #endif
 #include <AutoConnect.h>
+#include "ResponseWriter.h"
+#include "StripTopology.h"
+#include "SparseUpdate.h"
+#include "DmxReceiver.h"
 
 #ifdef INCLUDE_FALLBACK_INDEX_HTM
 #include "extras/index_htm.h"
@@ -137,11 +141,29 @@ FASTLED_USING_NAMESPACE
 #define PRINTS(s)    // Print a string
 #endif
 
-// #define CLK_PIN   4
-#define LED_TYPE WS2812B
+// Fallback strip topology, used when TOPOLOGY_PATH is missing or invalid
+#define LED_TYPE STRIP_WS2812B
 #define COLOR_ORDER GRB
 #define NUM_LEDS 60
-CRGB leds[NUM_LEDS];
+
+StripTopology topology;
+CRGB *leds = nullptr; // sized by the topology at boot
+uint16_t numLeds = 0;
+
+SparseUpdate sparseUpdate;
+DmxReceiver dmxReceiver;
+
+// Milliseconds from boot until WiFi connected and until the first frame
+// was sent, 0 until reached
+uint32_t bootToConnected = 0;
+uint32_t bootToFirstFrame = 0;
+
+// Frames rendered during the last OTA update and the longest gap
+// between them in milliseconds
+bool otaActive = false;
+uint32_t otaLastFrame = 0;
+uint32_t otaFrames = 0;
+uint32_t otaMaxFrameGap = 0;
 
 #define BRIGHTNESS 40
 #define FRAMES_PER_SECOND 100 // 120
@@ -1233,36 +1255,54 @@ String checkForUnsupportedPath(String filename)
 // Request handlers
 
 /*
-   Return the FS type, status and size info
+   Return the FS type, status and size info, plus the heap state so that
+   fragmentation can be followed over a long uptime
 */
 void handleStatus()
 {
-  DBG_OUTPUT_PORT.println("handleStatus");
+  DBG_OUTPUT_PORT.println(F("handleStatus"));
   FSInfo fs_info;
-  String json;
-  json.reserve(128);
+  ResponseWriter json(server);
 
-  json = "{\"type\":\"";
-  json += fsName;
-  json += "\", \"isOk\":";
+  json.begin(200, "application/json");
+  json.print(F("{\"type\":\""));
+  json.print(fsName);
+  json.print(F("\", \"isOk\":"));
   if (fsOK)
   {
     fileSystem->info(fs_info);
-    json += F("\"true\", \"totalBytes\":\"");
-    json += fs_info.totalBytes;
-    json += F("\", \"usedBytes\":\"");
-    json += fs_info.usedBytes;
-    json += "\"";
+    json.print(F("\"true\", \"totalBytes\":\""));
+    json.print(fs_info.totalBytes);
+    json.print(F("\", \"usedBytes\":\""));
+    json.print(fs_info.usedBytes);
+    json.print('"');
   }
   else
   {
-    json += "\"false\"";
-  }
-  json += F(",\"unsupportedFiles\":\"");
-  json += unsupportedFiles;
-  json += "\"}";
-
-  server.send(200, "application/json", json);
+    json.print(F("\"false\""));
+  }
+  json.print(F(",\"unsupportedFiles\":\""));
+  json.print(unsupportedFiles);
+  json.print(F("\",\"freeHeap\":"));
+  json.print(ESP.getFreeHeap());
+  json.print(F(",\"maxFreeBlock\":"));
+  json.print(ESP.getMaxFreeBlockSize());
+  json.print(F(",\"heapFragmentation\":"));
+  json.print(ESP.getHeapFragmentation());
+  json.print(F(",\"bootToConnected\":"));
+  json.print(bootToConnected);
+  json.print(F(",\"bootToFirstFrame\":"));
+  json.print(bootToFirstFrame);
+  json.print(F(",\"fastReconnect\":"));
+  json.print((portal.portalStatus() & AutoConnect::AC_FASTRECONNECT) ? F("true") : F("false"));
+  json.print(F(",\"handleClientMaxUs\":"));
+  json.print(portal.handleClientMaxTime());
+  json.print(F(",\"otaFrames\":"));
+  json.print(otaFrames);
+  json.print(F(",\"otaMaxFrameGap\":"));
+  json.print(otaMaxFrameGap);
+  json.print('}');
+  json.end();
 }
 
 /*
@@ -1660,30 +1700,31 @@ void handleNotFound()
     return;
   }
 
+  DBG_OUTPUT_PORT.print(F("handleNotFound: "));
+  DBG_OUTPUT_PORT.println(uri);
+
   // Dump debug data
-  String message;
-  message.reserve(100);
-  message = F("Error: File not found\n\nURI: ");
-  message += uri;
-  message += F("\nMethod: ");
-  message += (server.method() == HTTP_GET) ? "GET" : "POST";
-  message += F("\nArguments: ");
-  message += server.args();
-  message += '\n';
+  ResponseWriter message(server);
+  message.begin(404, FPSTR(TEXT_PLAIN));
+  message.print(F("Error: File not found\n\nURI: "));
+  message.print(uri);
+  message.print(F("\nMethod: "));
+  message.print((server.method() == HTTP_GET) ? F("GET") : F("POST"));
+  message.print(F("\nArguments: "));
+  message.print(server.args());
+  message.print('\n');
   for (uint8_t i = 0; i < server.args(); i++)
   {
-    message += F(" NAME:");
-    message += server.argName(i);
-    message += F("\n VALUE:");
-    message += server.arg(i);
-    message += '\n';
+    message.print(F(" NAME:"));
+    message.print(server.argName(i));
+    message.print(F("\n VALUE:"));
+    message.print(server.arg(i));
+    message.print('\n');
   }
-  message += "path=";
-  message += server.arg("path");
-  message += '\n';
-  DBG_OUTPUT_PORT.print(message);
-
-  return replyNotFound(message);
+  message.print(F("path="));
+  message.print(server.arg("path"));
+  message.print('\n');
+  message.end();
 }
 
 /*
@@ -1741,9 +1782,11 @@ void handleLightsOff()
     return replyServerError(str);
   }
 
-  DBG_OUTPUT_PORT.println(String("handleLightsOff"));
+  DBG_OUTPUT_PORT.println(F("handleLightsOff"));
 
   FastLED.clear(true);
+  // clear() only zeroes one lane's worth of a parallel controller's data
+  fill_solid(leds, numLeds, CRGB::Black);
    //FastLED.show();
   runAnimation = false;
   replyOK();
@@ -1752,8 +1795,8 @@ void handleLightsOff()
 void handleLightsOn()
 {
 
-  DBG_OUTPUT_PORT.println(String("handleLightsOn"));
-  fill_solid(leds, NUM_LEDS, CRGB::White);
+  DBG_OUTPUT_PORT.println(F("handleLightsOn"));
+  fill_solid(leds, numLeds, CRGB::White);
 
    FastLED.show();
   //runAnimation = true;
@@ -1763,15 +1806,12 @@ void handleLightsOn()
 void handleSetBrightness()
 {
 
-  DBG_OUTPUT_PORT.println(String("handleSetBrightness"));
-  String message;
-  message.reserve(100);
-  message += "brightness=";
-  message += server.arg("brightness");
-  message += '\n';
-  DBG_OUTPUT_PORT.print(message);
+  DBG_OUTPUT_PORT.println(F("handleSetBrightness"));
+  const String &arg = server.arg("brightness");
+  DBG_OUTPUT_PORT.print(F("brightness="));
+  DBG_OUTPUT_PORT.println(arg);
 
-  uint16_t brightness = server.arg("brightness").toInt();
+  uint16_t brightness = arg.toInt();
 
   if (brightness < 0 || brightness > 255)
   {
@@ -1788,18 +1828,12 @@ void handleSetBrightness()
 void handleSetColour()
 {
 
-  DBG_OUTPUT_PORT.println(String("handleSetColour"));
-  String message;
-  message.reserve(100);
-  message += "colour=";
-  message += server.arg("colour");
-  message += '\n';
-  DBG_OUTPUT_PORT.print(message);
-
-  fill_solid(leds, NUM_LEDS, CRGB::White);
+  DBG_OUTPUT_PORT.println(F("handleSetColour"));
+  const String &arg = server.arg("colour");
+  DBG_OUTPUT_PORT.print(F("colour="));
+  DBG_OUTPUT_PORT.println(arg);
 
-  uint32_t colour = server.arg("colour").toInt()
-  ;
+  uint32_t colour = arg.toInt();
 
   CRGB colourPreset; 
 
@@ -1838,7 +1872,7 @@ void handleSetColour()
     break;
   }
 
-  fill_solid(leds, NUM_LEDS,colourPreset);
+  fill_solid(leds, numLeds, colourPreset);
 
 
   runAnimation = false;
@@ -1846,13 +1880,59 @@ void handleSetColour()
   replyOK();
 }
 
+/*
+   Switch the realtime DMX receiver mode:
+   /realtime?protocol=artnet|e131|off[&universe=first universe]
+   While it is on, received universes replace the patterns.
+*/
+void handleRealtime()
+{
+  DBG_OUTPUT_PORT.println(F("handleRealtime"));
+  const String &protocol = server.arg("protocol");
+  DmxProtocol p;
+  uint16_t firstUniverse;
+
+  if (protocol == "off")
+  {
+    dmxReceiver.end();
+    runAnimation = true;
+    return replyOK();
+  }
+  else if (protocol == "artnet")
+  {
+    p = DMX_ARTNET;
+    firstUniverse = 0;
+  }
+  else if (protocol == "e131")
+  {
+    p = DMX_E131;
+    firstUniverse = 1;
+  }
+  else
+  {
+    return replyBadRequest(F("PROTOCOL ARG MISSING"));
+  }
+  if (server.hasArg("universe"))
+  {
+    firstUniverse = server.arg("universe").toInt();
+  }
+
+  if (!dmxReceiver.begin(p, numLeds, firstUniverse))
+  {
+    return replyServerError(F("REALTIME START FAILED"));
+  }
+  runAnimation = false;
+  replyOK();
+}
+
 void handleResumeAnimation()
 {
 
-  DBG_OUTPUT_PORT.println(String("handleResumeAnimation"));
+  DBG_OUTPUT_PORT.println(F("handleResumeAnimation"));
 
   // FastLED.setBrightness(255);
 
+  dmxReceiver.end();
   runAnimation = true;
 
   replyOK();
@@ -1861,7 +1941,7 @@ void handleResumeAnimation()
 void handlePauseAnimation()
 {
 
-  DBG_OUTPUT_PORT.println(String("handlePauseAnimation"));
+  DBG_OUTPUT_PORT.println(F("handlePauseAnimation"));
 
   // FastLED.setBrightness(255);
 
@@ -1873,7 +1953,7 @@ void handlePauseAnimation()
 void rainbow()
 {
   // FastLED's built-in rainbow generator
-  fill_rainbow(leds, NUM_LEDS, gHue, 7);
+  fill_rainbow(leds, numLeds, gHue, 7);
 }
 
 void addGlitter(fract8 chanceOfGlitter)
@@ -1883,8 +1963,8 @@ void addGlitter(fract8 chanceOfGlitter)
   {
     // FastLED.setBrightness(BRIGHTNESS);
     // FastLED.show(BRIGHTNESS / 2)
-    leds[random16(NUM_LEDS)] += CRGB::White;
-    // leds[random16(NUM_LEDS)] +=
+    leds[random16(numLeds)] += CRGB::White;
+    // leds[random16(numLeds)] +=
   }
 }
 void rainbowWithGlitter()
@@ -1897,16 +1977,16 @@ void rainbowWithGlitter()
 void confetti()
 {
   // random colored speckles that blink in and fade smoothly
-  fadeToBlackBy(leds, NUM_LEDS, 10);
-  int pos = random16(NUM_LEDS);
+  fadeToBlackBy(leds, numLeds, 10);
+  int pos = random16(numLeds);
   leds[pos] += CHSV(gHue + random8(64), 200, 255);
 }
 
 void sinelon()
 {
   // a colored dot sweeping back and forth, with fading trails
-  fadeToBlackBy(leds, NUM_LEDS, 20);
-  int pos = beatsin16(13, 0, NUM_LEDS - 1);
+  fadeToBlackBy(leds, numLeds, 20);
+  int pos = beatsin16(13, 0, numLeds - 1);
   leds[pos] += CHSV(gHue, 255, 192);
 }
 
@@ -1916,7 +1996,7 @@ void bpm()
   uint8_t BeatsPerMinute = 62;
   CRGBPalette16 palette = PartyColors_p;
   uint8_t beat = beatsin8(BeatsPerMinute, 64, 255);
-  for (int i = 0; i < NUM_LEDS; i++)
+  for (int i = 0; i < numLeds; i++)
   { // 9948
     leds[i] = ColorFromPalette(palette, gHue + (i * 2), beat - gHue + (i * 10));
   }
@@ -1925,11 +2005,11 @@ void bpm()
 void juggle()
 {
   // eight colored dots, weaving in and out of sync with each other
-  fadeToBlackBy(leds, NUM_LEDS, 20);
+  fadeToBlackBy(leds, numLeds, 20);
   uint8_t dothue = 0;
   for (int i = 0; i < 8; i++)
   {
-    leds[beatsin16(i + 7, 0, NUM_LEDS - 1)] |= CHSV(dothue, 200, 255);
+    leds[beatsin16(i + 7, 0, numLeds - 1)] |= CHSV(dothue, 200, 255);
     dothue += 32;
   }
 }
@@ -1942,34 +2022,96 @@ void nextPattern()
   gCurrentPatternNumber = (gCurrentPatternNumber + 1) % ARRAY_SIZE(gPatterns);
 }
 
+// An update streams inside a single ArduinoOTA.handle() or
+// portal.handleClient() call, so loop() does not run until it ends.
+// The progress callbacks, called between the flash writes, render the
+// frames at a reduced rate meanwhile and show the progress on the matrix.
+#define OTA_FRAME_INTERVAL 40 // ms, 25 fps
+
+void otaBegin()
+{
+  otaActive = true;
+  otaLastFrame = millis();
+  otaFrames = 0;
+  otaMaxFrameGap = 0;
+  mx.clear();
+}
+
+void otaFrame(uint32_t done, uint32_t total)
+{
+  uint32_t now = millis();
+  if (!otaActive || now - otaLastFrame < OTA_FRAME_INTERVAL)
+  {
+    return;
+  }
+  otaMaxFrameGap = std::max(otaMaxFrameGap, now - otaLastFrame);
+  otaLastFrame = now;
+  otaFrames++;
+
+  if (runAnimation)
+  {
+    gPatterns[gCurrentPatternNumber]();
+    gHue++;
+  }
+  FastLED.show();
+
+  // Progress bar across the middle rows of the matrix
+  uint16_t columns = mx.getColumnCount();
+  uint16_t lit = total ? std::min<uint32_t>((uint64_t)done * columns / total, columns) : 0;
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  for (uint16_t i = 0; i < columns; i++)
+  {
+    mx.setColumn(columns - 1 - i, i < lit ? 0x3c : 0x00);
+  }
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::ON);
+}
+
+void otaEnd()
+{
+  if (!otaActive)
+  {
+    return;
+  }
+  otaActive = false;
+  mx.clear();
+  DBG_OUTPUT_PORT.printf("OTA rendered %u frames, longest gap %u ms (target %u ms)\n", otaFrames, otaMaxFrameGap, OTA_FRAME_INTERVAL);
+}
+
 void exitOTAStart()
 {
   Serial.println("OTA started");
+  otaBegin();
 }
 
 void exitOTAProgress(unsigned int amount, unsigned int sz)
 {
   Serial.printf("OTA in progress: received %d bytes, total %d bytes\n", sz, amount);
+  // The amount counts the uploaded bytes, compressed or not, so the
+  // request body is the total; its multipart framing adds only a few
+  // hundred bytes
+  otaFrame(amount, server.clientContentLength());
 }
 
 void exitOTAEnd()
 {
   Serial.println("OTA ended");
+  otaEnd();
 }
 
 void exitOTAError(uint8_t err)
 {
   Serial.printf("OTA error occurred %d\n", err);
+  otaEnd();
 }
 
-static const char PAGE_AUTH[] PROGMEM = R"(
-{
-  "uri": "/tt",
-  "title": "Auth",
-  "menu": true,
-  "auth": "basic"
-}
-)";
+// Precompiled with auxtable.py from
+// {"uri": "/tt", "title": "Auth", "menu": true, "auth": "basic"}
+static const char PAGE_AUTH_URI[] PROGMEM = "/tt";
+static const char PAGE_AUTH_TITLE[] PROGMEM = "Auth";
+
+static const AutoConnectAux::ACPage_t PAGE_AUTH PROGMEM = {
+  PAGE_AUTH_URI, PAGE_AUTH_TITLE, true, nullptr, 0, AC_AUTH_BASIC
+};
 
 void setup()
 {
@@ -1987,6 +2129,24 @@ void setup()
   fsOK = fileSystem->begin();
   DBG_OUTPUT_PORT.println(fsOK ? F("Filesystem initialized.") : F("Filesystem init failed!"));
 
+  ////////////////////////////////
+  // LED STRIP INIT
+  // Allocate the LED buffer before WiFi starts carving up the heap
+
+  if (!fsOK || !topology.load(*fileSystem))
+  {
+    DBG_OUTPUT_PORT.println(F("Using the built-in strip topology"));
+    topology.reset(LED_TYPE, DATA_PIN_STRIP, COLOR_ORDER, NUM_LEDS);
+  }
+  if (!topology.begin())
+  {
+    topology.reset(LED_TYPE, DATA_PIN_STRIP, COLOR_ORDER, NUM_LEDS);
+    topology.begin();
+  }
+  leds = topology.leds();
+  numLeds = topology.count();
+  DBG_OUTPUT_PORT.printf("%u LEDs on %u %s\n", numLeds, topology.segments(), topology.parallel() ? "parallel lanes" : "segments");
+
   ArduinoOTA.setHostname((config.hostName + "-ota").c_str());
 
   ArduinoOTA.onStart([]()
@@ -1999,13 +2159,17 @@ void setup()
     }
 
     // NOTE: if updating FS this would be the place to unmount FS using FS.end()
-    Serial.println("Start updating " + type); });
+    Serial.println("Start updating " + type);
+    otaBegin(); });
   ArduinoOTA.onEnd([]()
-                   { Serial.println("\nEnd"); });
+                   { Serial.println("\nEnd");
+                     otaEnd(); });
   ArduinoOTA.onProgress([](unsigned int progress, unsigned int total)
-                        { Serial.printf("Progress: %u%%\r", (progress / (total / 100))); });
+                        { Serial.printf("Progress: %u%%\r", (progress / (total / 100)));
+                          otaFrame(progress, total); });
   ArduinoOTA.onError([](ota_error_t error)
                      {
+    otaEnd();
     Serial.printf("Error[%u]: ", error);
     if (error == OTA_AUTH_ERROR) {
       Serial.println("Auth Failed");
@@ -2076,6 +2240,7 @@ __AC_LINK__
   server.on("/pauseanimation", HTTP_GET, handlePauseAnimation);
   server.on("/lightson", HTTP_GET, handleLightsOn);
   server.on("/lightsoff", HTTP_GET, handleLightsOff);
+  server.on("/realtime", HTTP_GET, handleRealtime);
 
   // Using AutoConnect does not require the HTTP server to be started
   // intentionally. It is launched inside AutoConnect.begin.
@@ -2090,14 +2255,17 @@ __AC_LINK__
   config.password = "password";
   config.auth = AC_AUTH_BASIC;
   config.authScope = AC_AUTHSCOPE_PARTIAL;
+  // Reconnect to the last access point without scanning after a reset
+  config.fastReconnect = true;
 
   portal.config(config);
   portal.append("/edit", "Edit");
   portal.append("/list?dir=\"/\"", "List");
-  portal.load(FPSTR(PAGE_AUTH));
+  portal.load(PAGE_AUTH);
   if (portal.begin())
   {
-    DBG_OUTPUT_PORT.print(F("Connected! IP address: "));
+    bootToConnected = millis();
+    DBG_OUTPUT_PORT.printf("Connected in %u ms%s! IP address: ", bootToConnected, (portal.portalStatus() & AutoConnect::AC_FASTRECONNECT) ? " (cached AP)" : "");
     DBG_OUTPUT_PORT.println(WiFi.localIP());
   }
   else
@@ -2129,10 +2297,6 @@ __AC_LINK__
   portal.begin();
 
   DBG_OUTPUT_PORT.println(F("Setup FastLED"));
-  // tell FastLED about the LED strip configuration
-  FastLED.addLeds<LED_TYPE, DATA_PIN_STRIP, COLOR_ORDER>(leds, NUM_LEDS).setCorrection(TypicalLEDStrip);
-  // FastLED.addLeds<LED_TYPE,DATA_PIN,CLK_PIN,COLOR_ORDER>(leds, NUM_LEDS).setCorrection(TypicalLEDStrip);
-
   // set master brightness control
   FastLED.setBrightness(BRIGHTNESS);
 
@@ -2174,6 +2338,8 @@ __AC_LINK__
   dnsServer.setErrorReplyCode(DNSReplyCode::NoError);
   dnsServer.start(DNS_PORT, "*", apIP);
 
+  sparseUpdate.begin(leds, numLeds);
+
   mx.begin();
   prevTimeAnim = millis();
 #if RUN_DEMO
@@ -2198,10 +2364,32 @@ void loop()
   MDNS.update();
   ArduinoOTA.handle();
 
+  // In realtime mode the DMX stream is the only source of frames
+  if (dmxReceiver.active())
+  {
+    dmxReceiver.handle();
+    dmxReceiver.render(leds);
+  }
+  // Partial updates from the network take over from the built-in patterns
+  else if (sparseUpdate.handle())
+  {
+    runAnimation = false;
+  }
+
       FastLED.show();
+    if (!bootToFirstFrame)
+    {
+      bootToFirstFrame = millis();
+      DBG_OUTPUT_PORT.printf("First frame %u ms after boot\n", bootToFirstFrame);
+    }
     // insert a delay to keep the framerate modest
     FastLED.delay(1000 / FRAMES_PER_SECOND);
 
+  if (!bootToConnected && WiFi.status() == WL_CONNECTED)
+  {
+    bootToConnected = millis();
+  }
+
   if (runAnimation)
   {
     // Call the current pattern function once, updating the 'leds' array
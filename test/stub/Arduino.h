@@ -0,0 +1,286 @@
+/*
+  Arduino.h
+  Host stand-in for the parts of the Arduino core used by the code under
+  test in the native environment. Flash is ordinary memory on the host,
+  so the PROGMEM accessors are plain reads.
+*/
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using std::max;
+using std::min;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+static inline unsigned long millis()
+{
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static inline unsigned long micros()
+{
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+static inline void yield() { std::this_thread::yield(); }
+
+// Like the ESP8266 String, an explicitly destroyed String is left empty
+// and usable, which PageBuilder relies on.
+class String
+{
+public:
+  String() : _s(nullptr) {}
+  String(const char *s) : _s(nullptr) { _assign(s ? s : "", s ? strlen(s) : 0); }
+  String(const char *s, size_t n) : _s(nullptr) { _assign(s, n); }
+  String(const std::string &s) : _s(nullptr) { _assign(s.data(), s.size()); }
+  String(const __FlashStringHelper *s) : String(reinterpret_cast<const char *>(s)) {}
+  String(const String &s) : _s(nullptr) { _assign(s.c_str(), s.length()); }
+  String(String &&s) : _s(s._s) { s._s = nullptr; }
+  explicit String(char c) : _s(nullptr) { _assign(&c, 1); }
+  explicit String(int v) : String(std::to_string(v)) {}
+  explicit String(unsigned int v) : String(std::to_string(v)) {}
+  explicit String(long v) : String(std::to_string(v)) {}
+  explicit String(unsigned long v) : String(std::to_string(v)) {}
+  ~String()
+  {
+    delete _s;
+    _s = nullptr;
+    // keep the store above, the object stays in use after an explicit ~String()
+    __asm__ __volatile__("" : : "r"(this) : "memory");
+  }
+
+  String &operator=(const String &s)
+  {
+    if (this != &s)
+      _assign(s.c_str(), s.length());
+    return *this;
+  }
+  String &operator=(String &&s)
+  {
+    std::swap(_s, s._s);
+    return *this;
+  }
+  String &operator=(const char *s)
+  {
+    _assign(s ? s : "", s ? strlen(s) : 0);
+    return *this;
+  }
+
+  unsigned int length() const { return _s ? (unsigned int)_s->size() : 0; }
+  const char *c_str() const { return _s ? _s->c_str() : ""; }
+  const char *begin() const { return c_str(); }
+  const char *end() const { return c_str() + length(); }
+  bool isEmpty() const { return !length(); }
+  void clear()
+  {
+    if (_s)
+      _s->clear();
+  }
+  bool reserve(unsigned int n)
+  {
+    _str().reserve(n);
+    return true;
+  }
+
+  bool concat(const char *s, unsigned int n)
+  {
+    _str().append(s, n);
+    return true;
+  }
+  bool concat(const char *s) { return concat(s, strlen(s)); }
+  bool concat(const String &s) { return concat(s.c_str(), s.length()); }
+  bool concat(const __FlashStringHelper *s) { return concat(reinterpret_cast<const char *>(s)); }
+  bool concat(char c) { return concat(&c, 1); }
+  template <typename T>
+  String &operator+=(const T &v)
+  {
+    concat(v);
+    return *this;
+  }
+  friend String operator+(const String &a, const String &b)
+  {
+    String r(a);
+    r.concat(b);
+    return r;
+  }
+
+  char operator[](unsigned int i) const { return i < length() ? (*_s)[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  bool operator==(const String &s) const { return length() == s.length() && !memcmp(c_str(), s.c_str(), length()); }
+  bool operator==(const char *s) const { return !strcmp(c_str(), s); }
+  bool operator!=(const String &s) const { return !(*this == s); }
+  bool operator!=(const char *s) const { return !(*this == s); }
+  bool equals(const String &s) const { return *this == s; }
+  bool equalsIgnoreCase(const String &s) const { return !strcasecmp(c_str(), s.c_str()); }
+  bool startsWith(const String &s) const { return !strncmp(c_str(), s.c_str(), s.length()); }
+
+  int indexOf(const char *s, unsigned int from = 0) const
+  {
+    const char *p = from <= length() ? strstr(c_str() + from, s) : nullptr;
+    return p ? (int)(p - c_str()) : -1;
+  }
+  int indexOf(char c, unsigned int from = 0) const
+  {
+    const char *p = from < length() ? strchr(c_str() + from, c) : nullptr;
+    return p ? (int)(p - c_str()) : -1;
+  }
+  String substring(unsigned int from, unsigned int to = (unsigned int)-1) const
+  {
+    to = std::min(to, length());
+    return from < to ? String(c_str() + from, to - from) : String();
+  }
+  long toInt() const { return atol(c_str()); }
+
+private:
+  std::string &_str()
+  {
+    if (!_s)
+      _s = new std::string;
+    return *_s;
+  }
+  void _assign(const char *s, size_t n) { _str().assign(s, n); }
+
+  std::string *_s;
+};
+
+static const String emptyString;
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+      n += write(*buf++);
+    return n;
+  }
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+
+  size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+  size_t print(const String &s) { return write(s.c_str(), s.length()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v) { return print((unsigned long)v); }
+  size_t print(int v) { return print((long)v); }
+  size_t print(unsigned int v) { return print((unsigned long)v); }
+  // formatted on the stack, like printNumber() of the core
+  size_t print(long v)
+  {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", v);
+    return write(buf);
+  }
+  size_t print(unsigned long v)
+  {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%lu", v);
+    return write(buf);
+  }
+  size_t print(double v, int digits = 2)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+  }
+  template <typename T>
+  size_t println(const T &v)
+  {
+    size_t n = print(v);
+    return n + write("\r\n");
+  }
+  size_t println() { return write("\r\n"); }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+inline size_t Print::printf(const char *format, ...)
+{
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  return n > 0 ? write(buf, std::min((size_t)n, sizeof(buf) - 1)) : 0;
+}
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+  virtual size_t readBytes(char *buf, size_t length)
+  {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0)
+      buf[n++] = (char)c;
+    return n;
+  }
+  size_t readBytes(uint8_t *buf, size_t length) { return readBytes((char *)buf, length); }
+};
+
+class HostSerial : public Stream
+{
+public:
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  template <typename... Args>
+  void printf_P(const char *format, Args... args) { ::printf(format, args...); }
+};
+
+static HostSerial Serial __attribute__((unused));
+
+class EspClass
+{
+public:
+  uint32_t getFreeHeap() { return 40 * 1024; }
+  uint32_t getMaxFreeBlockSize() { return 40 * 1024; }
+  uint8_t getHeapFragmentation() { return 0; }
+  uint32_t getSketchSize() { return 0; }
+  void restart() {}
+};
+
+static EspClass ESP __attribute__((unused));
@@ -0,0 +1,123 @@
+/*
+  ESP8266WebServer.h
+  Host stand-in for the web server: everything a handler sends is
+  collected in memory so a test can inspect the response.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <functional>
+#include <vector>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+enum HTTPMethod
+{
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_POST,
+  HTTP_PUT,
+  HTTP_PATCH,
+  HTTP_DELETE,
+  HTTP_OPTIONS
+};
+
+enum class HTTPAuthMethod
+{
+  BASIC_AUTH,
+  DIGEST_AUTH
+};
+
+struct HTTPUpload
+{
+};
+
+class ESP8266WebServer;
+
+class RequestHandler
+{
+public:
+  virtual ~RequestHandler() {}
+  virtual bool canHandle(HTTPMethod, const String &) { return false; }
+  virtual bool canUpload(const String &) { return false; }
+  virtual bool handle(ESP8266WebServer &, HTTPMethod, const String &) { return false; }
+  virtual void upload(ESP8266WebServer &, const String &, HTTPUpload &) {}
+};
+
+class ESP8266WebServer
+{
+public:
+  int code = 0;
+  String contentType;
+  std::string body;                // everything sent after the headers
+  std::vector<size_t> chunks;      // length of each sendContent() call
+  size_t contentLength = CONTENT_LENGTH_NOT_SET;
+  bool finalized = false;
+  size_t lateChunks = 0;           // content sent after an empty chunk ended the response
+
+  void reset()
+  {
+    code = 0;
+    contentType.clear();
+    body.clear();
+    chunks.clear();
+    contentLength = CONTENT_LENGTH_NOT_SET;
+    finalized = false;
+    lateChunks = 0;
+  }
+
+  int args() { return 0; }
+  String argName(int) { return String(); }
+  String arg(int) { return String(); }
+  String arg(const String &) { return String(); }
+  HTTPMethod method() { return HTTP_GET; }
+  void sendHeader(const String &, const String &, bool = false) {}
+  void enableCORS(bool) {}
+  bool authenticate(const char *, const char *) { return true; }
+  void requestAuthentication(HTTPAuthMethod, const char *, const String &) {}
+  void onNotFound(std::function<void()>) {}
+  void addHandler(RequestHandler *) {}
+
+  WiFiClient client()
+  {
+    WiFiClient c;
+    c.out = &body;
+    return c;
+  }
+
+  void setContentLength(size_t length) { contentLength = length; }
+  void send(int status, const char *type, const String &content)
+  {
+    code = status;
+    contentType = type;
+    body.append(content.c_str(), content.length());
+  }
+  void send(int status, const __FlashStringHelper *type, const String &content)
+  {
+    send(status, reinterpret_cast<const char *>(type), content);
+  }
+  void sendContent(const char *content, size_t size)
+  {
+    // an empty chunk terminates the chunked transfer, the client drops the rest
+    if (!size)
+    {
+      finalized = true;
+      return;
+    }
+    if (finalized)
+    {
+      lateChunks++;
+      return;
+    }
+    chunks.push_back(size);
+    body.append(content, size);
+  }
+  void sendContent(const char *content) { sendContent(content, strlen(content)); }
+  void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+  void sendContent_P(PGM_P content) { sendContent(content); }
+  void sendContent_P(PGM_P content, size_t size) { sendContent(content, size); }
+  void chunkedResponseFinalize() { finalized = true; }
+};
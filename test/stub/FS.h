@@ -0,0 +1,65 @@
+/*
+  FS.h
+  Host stand-in for the SPI flash file system: files are kept in memory
+  and read back through File like on the device.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+
+class File : public Stream
+{
+public:
+  File() : _pos(0) {}
+  explicit File(std::shared_ptr<const std::string> content, const char *name) : _content(content), _name(name), _pos(0) {}
+
+  operator bool() const { return _content != nullptr; }
+  const char *name() const { return _name.c_str(); }
+  size_t size() const { return _content ? _content->size() : 0; }
+  void close() { _content.reset(); }
+
+  int available() override { return _content ? (int)(_content->size() - _pos) : 0; }
+  int read() override { return available() ? (uint8_t)(*_content)[_pos++] : -1; }
+  int peek() override { return available() ? (uint8_t)(*_content)[_pos] : -1; }
+  size_t readBytes(char *buf, size_t length) override
+  {
+    size_t n = std::min(length, (size_t)available());
+    if (n)
+      memcpy(buf, _content->data() + _pos, n);
+    _pos += n;
+    return n;
+  }
+  size_t write(uint8_t) override { return 0; }
+
+private:
+  std::shared_ptr<const std::string> _content;
+  std::string _name;
+  size_t _pos;
+};
+
+namespace fs
+{
+
+class FS
+{
+public:
+  bool begin() { return true; }
+  bool exists(const char *path) { return _files.count(path) != 0; }
+  File open(const char *path, const char *mode)
+  {
+    (void)mode;
+    auto it = _files.find(path);
+    return it == _files.end() ? File() : File(it->second, path);
+  }
+  // Host side only: places a file in the file system
+  void put(const char *path, const std::string &content) { _files[path] = std::make_shared<const std::string>(content); }
+
+private:
+  std::map<std::string, std::shared_ptr<const std::string>> _files;
+};
+
+} // namespace fs
+
+using fs::FS;
@@ -0,0 +1,4 @@
+#pragma once
+#include <FS.h>
+
+static fs::FS LittleFS __attribute__((unused));
@@ -0,0 +1,30 @@
+/*
+  WiFiClient.h
+  Host stand-in for a client connection writing into a string.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+class WiFiClient : public Print
+{
+public:
+  std::string *out = nullptr;
+
+  size_t write(uint8_t c) override
+  {
+    if (out)
+      out->push_back((char)c);
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t size) override
+  {
+    if (out)
+      out->append((const char *)buf, size);
+    return size;
+  }
+  using Print::write;
+  void flush() {}
+  void stop() {}
+  uint8_t connected() { return out != nullptr; }
+};
@@ -0,0 +1,283 @@
+/*
+  Golden output test and host benchmark of the SMLayerBackground rows.
+
+  fillRefreshRow used to branch on color correction and the source depth
+  for every pixel and shift by a runtime amount. It now dispatches once
+  per row to loadRefreshRow<colorCorrection, numShifts>. Every
+  specialisation, shifts 0-4 with color correction on and off and the
+  runtime shift of other values, must give the same rows as the old
+  per-pixel expressions for rgb24 and rgb48 sources into rgb24 and
+  rgb48 rows, including widths that are not a multiple of the four
+  pixel batch. The benchmark times a row both ways at 64, 128 and 256
+  pixels.
+*/
+// the layers are built as for the ESP32, as the buffers are given to the constructor
+#define ESP32
+#include <Arduino.h>
+#include <unity.h>
+#include <assert.h>
+#include <vector>
+#include "Layer.cpp"
+#include "Layer_Background.h"
+#include "Font_apple4x6_256.c"
+
+namespace
+{
+
+const int HEIGHT = 4;
+const int WIDTHS[] = {1, 3, 61, 64, 67, 128, 256};
+const int BENCH_WIDTHS[] = {64, 128, 256};
+const int ROWS = 20000;
+
+// large enough for every shifted index of both source depths
+color_chan_t lut[65536];
+
+// fillRefreshRow(rgb48) before the specialisation
+template <typename RGB>
+void oldFillRefreshRow(const RGB *ptr, int width, bool ccEnabled, rgb48 refreshRow[], int brightnessShifts)
+{
+  RGB currentPixel;
+  int i;
+
+  if (ccEnabled)
+  {
+    for (i = 0; i < width; i++)
+    {
+      currentPixel = *ptr++;
+      if (sizeof(RGB) <= 3)
+      {
+        refreshRow[i] = rgb48(lut[currentPixel.red << brightnessShifts],
+                              lut[currentPixel.green << brightnessShifts],
+                              lut[currentPixel.blue << brightnessShifts]);
+      }
+      else
+      {
+        refreshRow[i] = rgb48(lut[currentPixel.red >> (4 - brightnessShifts)],
+                              lut[currentPixel.green >> (4 - brightnessShifts)],
+                              lut[currentPixel.blue >> (4 - brightnessShifts)]);
+      }
+    }
+  }
+  else
+  {
+    for (i = 0; i < width; i++)
+    {
+      currentPixel = *ptr++;
+      if (sizeof(RGB) <= 3)
+      {
+        refreshRow[i] = rgb48(currentPixel.red << (brightnessShifts + 8),
+                              currentPixel.green << (brightnessShifts + 8),
+                              currentPixel.blue << (brightnessShifts + 8));
+      }
+      else
+      {
+        refreshRow[i] = rgb48(currentPixel.red << brightnessShifts,
+                              currentPixel.green << brightnessShifts,
+                              currentPixel.blue << brightnessShifts);
+      }
+    }
+  }
+}
+
+// fillRefreshRow(rgb24) before the specialisation
+template <typename RGB>
+void oldFillRefreshRow(const RGB *ptr, int width, bool ccEnabled, rgb24 refreshRow[], int brightnessShifts)
+{
+  RGB currentPixel;
+  int i;
+
+  if (ccEnabled)
+  {
+    for (i = 0; i < width; i++)
+    {
+      currentPixel = *ptr++;
+      if (sizeof(RGB) <= 3)
+      {
+        refreshRow[i] = rgb48(lut[currentPixel.red << brightnessShifts],
+                              lut[currentPixel.green << brightnessShifts],
+                              lut[currentPixel.blue << brightnessShifts]);
+      }
+      else
+      {
+        refreshRow[i] = rgb48(lut[currentPixel.red >> (4 - brightnessShifts)],
+                              lut[currentPixel.green >> (4 - brightnessShifts)],
+                              lut[currentPixel.blue >> (4 - brightnessShifts)]);
+      }
+    }
+  }
+  else
+  {
+    for (i = 0; i < width; i++)
+    {
+      currentPixel = *ptr++;
+      if (sizeof(RGB) <= 3)
+      {
+        refreshRow[i] = rgb24(currentPixel.red << brightnessShifts,
+                              currentPixel.green << brightnessShifts,
+                              currentPixel.blue << brightnessShifts);
+      }
+      else
+      {
+        refreshRow[i] = rgb48(currentPixel.red << brightnessShifts,
+                              currentPixel.green << brightnessShifts,
+                              currentPixel.blue << brightnessShifts);
+      }
+    }
+  }
+}
+
+void randomPixel(rgb24 &p)
+{
+  p = rgb24((uint8_t)rand(), (uint8_t)rand(), (uint8_t)rand());
+}
+
+void randomPixel(rgb48 &p)
+{
+  p = rgb48((uint16_t)rand(), (uint16_t)rand(), (uint16_t)rand());
+}
+
+template <typename RGB>
+bool samePixel(const RGB &a, const RGB &b)
+{
+  return a.red == b.red && a.green == b.green && a.blue == b.blue;
+}
+
+// a layer refreshing from a buffer of random pixels
+template <typename RGB>
+struct Background
+{
+  std::vector<RGB> buffer;
+  SMLayerBackground<RGB, 0> layer;
+
+  Background(int width)
+    : buffer(2 * width * HEIGHT), layer(buffer.data(), width, HEIGHT, lut)
+  {
+    for (auto &p : buffer)
+      randomPixel(p);
+    layer.setRotation(rotation0);
+    layer.begin();
+  }
+
+  // begin() makes the second buffer the refresh buffer
+  const RGB *refreshRow(int width, int y) const
+  {
+    return buffer.data() + width * HEIGHT + y * width;
+  }
+};
+
+template <typename RGB, typename RGB_OUT>
+long rowMismatches(int width, bool cc, int shifts)
+{
+  Background<RGB> background(width);
+  background.layer.enableColorCorrection(cc);
+
+  long mismatches = 0;
+  std::vector<RGB_OUT> row(width), expected(width);
+  for (int y = 0; y < HEIGHT; y++)
+  {
+    background.layer.fillRefreshRow(y, row.data(), shifts);
+    oldFillRefreshRow(background.refreshRow(width, y), width, cc, expected.data(), shifts);
+    for (int x = 0; x < width; x++)
+      if (!samePixel(row[x], expected[x]))
+        mismatches++;
+  }
+  return mismatches;
+}
+
+template <typename RGB, typename RGB_OUT>
+long allMismatches(void)
+{
+  long mismatches = 0;
+  for (int width : WIDTHS)
+  {
+    for (int shifts = 0; shifts <= 4; shifts++)
+    {
+      mismatches += rowMismatches<RGB, RGB_OUT>(width, false, shifts);
+      mismatches += rowMismatches<RGB, RGB_OUT>(width, true, shifts);
+    }
+    // other shifts take the runtime shift, the 12-bit LUT index of a
+    // 16-bit channel is only defined up to 4
+    for (int shifts = 5; shifts <= 6; shifts++)
+    {
+      mismatches += rowMismatches<RGB, RGB_OUT>(width, false, shifts);
+      if (sizeof(RGB) <= 3)
+        mismatches += rowMismatches<RGB, RGB_OUT>(width, true, shifts);
+    }
+  }
+  return mismatches;
+}
+
+template <typename Fill>
+double rowMicros(Fill fill)
+{
+  unsigned long start = micros();
+  for (int r = 0; r < ROWS; r++)
+    fill(r % HEIGHT);
+  return (double)(micros() - start) / ROWS;
+}
+
+template <typename RGB, typename RGB_OUT>
+void benchmark(const char *name)
+{
+  for (int width : BENCH_WIDTHS)
+  {
+    Background<RGB> background(width);
+    static RGB_OUT row[256];
+    double micros[2][2];
+    for (int cc = 0; cc < 2; cc++)
+    {
+      background.layer.enableColorCorrection(cc);
+      micros[cc][0] = rowMicros([&](int y) {
+        oldFillRefreshRow(background.refreshRow(width, y), width, cc, row, 0);
+      });
+      micros[cc][1] = rowMicros([&](int y) {
+        background.layer.fillRefreshRow(y, row, 0);
+      });
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "%s %d px, us/row: cc off %.3f -> %.3f, cc on %.3f -> %.3f",
+             name, width, micros[0][0], micros[0][1], micros[1][0], micros[1][1]);
+    TEST_MESSAGE(line);
+  }
+}
+
+} // namespace
+
+void setUp(void)
+{
+  srand(1);
+  for (auto &v : lut)
+    v = (color_chan_t)rand();
+}
+
+void tearDown(void) {}
+
+void test_rgb24_rows_match(void)
+{
+  TEST_ASSERT_EQUAL(0, (allMismatches<rgb24, rgb48>()));
+  TEST_ASSERT_EQUAL(0, (allMismatches<rgb24, rgb24>()));
+}
+
+void test_rgb48_rows_match(void)
+{
+  TEST_ASSERT_EQUAL(0, (allMismatches<rgb48, rgb48>()));
+  TEST_ASSERT_EQUAL(0, (allMismatches<rgb48, rgb24>()));
+}
+
+void test_row_benchmark(void)
+{
+  benchmark<rgb24, rgb48>("rgb24->rgb48");
+  benchmark<rgb48, rgb48>("rgb48->rgb48");
+  benchmark<rgb24, rgb24>("rgb24->rgb24");
+  benchmark<rgb48, rgb24>("rgb48->rgb24");
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_rgb24_rows_match);
+  RUN_TEST(test_rgb48_rows_match);
+  RUN_TEST(test_row_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,155 @@
+/*
+  Golden output test and host benchmark of BitSlice_SM.
+
+  The HUB75 packers used to test each of the six channels of a pixel
+  pair against a mask once per bitplane. bitSliceChannels must give
+  the same R1..B2 bits for every plane configuration the calcs use,
+  including planes that span both bytes of a 16-bit channel. The
+  benchmark times a 128 pixel, 48-bit row both ways and checks that the
+  outputs are identical.
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include "MatrixCommon.h"
+#include "BitSlice_SM.h"
+
+namespace
+{
+
+const int RANDOM_PIXELS = 200000;
+const int ROW_PIXELS = 128;
+const int ROW_PLANES = 16;
+const int ROWS = 20000;
+
+// six data bits of bitplane bit, one mask test per channel
+uint8_t maskedBits(const uint16_t c[6], int bit)
+{
+  uint8_t bits = 0;
+  for (int k = 0; k < 6; k++)
+    if (c[k] & (1 << bit))
+      bits |= 1 << k;
+  return bits;
+}
+
+template <int numPlanes, int firstBit>
+long sliceMismatches(int channelBits)
+{
+  long mismatches = 0;
+  for (int i = 0; i < RANDOM_PIXELS; i++)
+  {
+    uint16_t c[6];
+    for (auto &v : c)
+      v = rand() & ((1 << channelBits) - 1);
+    uint8_t planes[numPlanes];
+    bitSliceChannels<numPlanes, firstBit>(c[0], c[1], c[2], c[3], c[4], c[5], planes);
+    for (int j = 0; j < numPlanes; j++)
+      if (planes[j] != maskedBits(c, firstBit + j))
+        mismatches++;
+  }
+  return mismatches;
+}
+
+rgb48 upper[ROW_PIXELS], lower[ROW_PIXELS];
+uint8_t maskedRow[ROW_PLANES][ROW_PIXELS];
+uint8_t slicedRow[ROW_PLANES][ROW_PIXELS];
+
+// the packer before slicing: six mask tests per pixel per bitplane
+void packMasked(void)
+{
+  for (int j = 0; j < ROW_PLANES; j++)
+  {
+    uint16_t mask = 1 << j;
+    for (int k = 0; k < ROW_PIXELS; k++)
+    {
+      uint8_t v = 0;
+      if (upper[k].red & mask) v |= BITSLICE_R1_BIT;
+      if (upper[k].green & mask) v |= BITSLICE_G1_BIT;
+      if (upper[k].blue & mask) v |= BITSLICE_B1_BIT;
+      if (lower[k].red & mask) v |= BITSLICE_R2_BIT;
+      if (lower[k].green & mask) v |= BITSLICE_G2_BIT;
+      if (lower[k].blue & mask) v |= BITSLICE_B2_BIT;
+      maskedRow[j][k] = v;
+    }
+  }
+}
+
+void packSliced(void)
+{
+  static uint8_t planes[ROW_PIXELS * ROW_PLANES];
+  bitSliceRow<ROW_PLANES, 0>(upper, lower, ROW_PIXELS, planes);
+  for (int j = 0; j < ROW_PLANES; j++)
+    for (int k = 0; k < ROW_PIXELS; k++)
+      slicedRow[j][k] = planes[k * ROW_PLANES + j];
+}
+
+template <typename Pack>
+double rowMicros(Pack pack)
+{
+  unsigned long start = micros();
+  for (int r = 0; r < ROWS; r++)
+  {
+    upper[r % ROW_PIXELS].red ^= r;
+    pack();
+  }
+  return (double)(micros() - start) / ROWS;
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_transpose8x8(void)
+{
+  for (int n = 0; n < RANDOM_PIXELS; n++)
+  {
+    uint8_t in[8], out[8];
+    for (auto &b : in)
+      b = rand();
+    bitSliceTranspose8x8(in, out);
+    for (int b = 0; b < 8; b++)
+      for (int i = 0; i < 8; i++)
+        TEST_ASSERT_EQUAL((in[i] >> b) & 1, (out[b] >> i) & 1);
+  }
+}
+
+void test_slice_matches_masks(void)
+{
+  // 24-bit color
+  TEST_ASSERT_EQUAL(0, (sliceMismatches<8, 0>(8)));
+  // 36-bit color, the upper 12 bits of a 16-bit channel
+  TEST_ASSERT_EQUAL(0, (sliceMismatches<12, 4>(16)));
+  // 48-bit color
+  TEST_ASSERT_EQUAL(0, (sliceMismatches<16, 0>(16)));
+  // planes that start in the low byte and end in the high byte
+  TEST_ASSERT_EQUAL(0, (sliceMismatches<4, 6>(16)));
+}
+
+void test_slice_row_benchmark(void)
+{
+  for (int k = 0; k < ROW_PIXELS; k++)
+  {
+    upper[k] = rgb48(rand(), rand(), rand());
+    lower[k] = rgb48(rand(), rand(), rand());
+  }
+
+  double masked = rowMicros(packMasked);
+  double sliced = rowMicros(packSliced);
+
+  packMasked();
+  packSliced();
+  TEST_ASSERT_EQUAL_MEMORY(maskedRow, slicedRow, sizeof(maskedRow));
+
+  char line[160];
+  snprintf(line, sizeof(line), "%d pixel 48-bit row, us/row: masks %.2f, bit-sliced %.2f", ROW_PIXELS, masked, sliced);
+  TEST_MESSAGE(line);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_transpose8x8);
+  RUN_TEST(test_slice_matches_masks);
+  RUN_TEST(test_slice_row_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,116 @@
+/*
+  Single producer / single consumer test of CircularBuffer_SM.
+
+  The buffer only holds indexes into the caller's storage, like the
+  refresh row buffers of SmartMatrix. A producer thread fills the
+  element at cbGetNextWrite with a running value before cbWrite, as the
+  calc task does, and the consumer checks that every value arrives once
+  and in order, as the refresh ISR must. The sizes cover the row buffer
+  counts that are not a power of two.
+*/
+#include <unity.h>
+#include <thread>
+#include "CircularBuffer_SM.cpp"
+
+namespace
+{
+
+const int SIZES[] = {1, 2, 3, 4, 5, 7, 8};
+const long VALUES = 200000;
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_single_thread_semantics(void)
+{
+  for (int size : SIZES)
+  {
+    CircularBuffer_SM cb;
+    cbInit(&cb, size);
+
+    // wrap the positions around a few times
+    for (int i = 0; i < 3 * size + 1; i++)
+    {
+      cbWrite(&cb);
+      cbRead(&cb);
+    }
+    TEST_ASSERT_TRUE(cbIsEmpty(&cb));
+
+    for (int i = 0; i < size; i++)
+    {
+      TEST_ASSERT_FALSE(cbIsFull(&cb));
+      TEST_ASSERT_EQUAL(i, cbCount(&cb));
+      cbWrite(&cb);
+    }
+    TEST_ASSERT_TRUE(cbIsFull(&cb));
+    TEST_ASSERT_FALSE(cbIsEmpty(&cb));
+
+    // a write to a full buffer is dropped
+    int next = cbGetNextWrite(&cb);
+    cbWrite(&cb);
+    TEST_ASSERT_EQUAL(size, cbCount(&cb));
+    TEST_ASSERT_EQUAL(next, cbGetNextWrite(&cb));
+
+    for (int i = 0; i < size; i++)
+    {
+      TEST_ASSERT_FALSE(cbIsEmpty(&cb));
+      cbRead(&cb);
+    }
+    TEST_ASSERT_TRUE(cbIsEmpty(&cb));
+
+    // a read from an empty buffer is ignored
+    cbRead(&cb);
+    TEST_ASSERT_TRUE(cbIsEmpty(&cb));
+    TEST_ASSERT_FALSE(cbIsFull(&cb));
+  }
+}
+
+void test_producer_consumer_threads(void)
+{
+  static long slots[16];
+
+  for (int size : SIZES)
+  {
+    CircularBuffer_SM cb;
+    cbInit(&cb, size);
+
+    std::thread producer([&cb]() {
+      for (long v = 1; v <= VALUES; v++)
+      {
+        while (cbIsFull(&cb))
+          std::this_thread::yield();
+        slots[cbGetNextWrite(&cb)] = v;
+        cbWrite(&cb);
+      }
+    });
+
+    long expect = 1;
+    long mismatches = 0;
+    while (expect <= VALUES)
+    {
+      if (cbIsEmpty(&cb))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      if (slots[cbGetNextRead(&cb)] != expect)
+        mismatches++;
+      expect++;
+      cbRead(&cb);
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL(0, mismatches);
+    TEST_ASSERT_TRUE(cbIsEmpty(&cb));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_single_thread_semantics);
+  RUN_TEST(test_producer_consumer_threads);
+  return UNITY_END();
+}
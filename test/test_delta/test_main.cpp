@@ -0,0 +1,321 @@
+/*
+  Round trip of deltapatch.py through AutoConnectDelta.
+
+  Patches between generated pairs of images are made by the script and
+  applied to the old image with the patch split at random points, from
+  single bytes to more than a TCP segment. The pairs cover small edits,
+  inserted, deleted and moved blocks, growth and shrinking, identical
+  images and unrelated ones. A corrupted or truncated patch must not
+  give an image that would be committed. A patch made against another
+  image is refused by a verifier that checks the source size and MD5
+  like AutoConnectOTA does, before anything is written.
+  The script is run with python3 from the project directory.
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <string>
+#include <vector>
+#include "AutoConnectDelta.cpp"
+
+namespace
+{
+
+const char *DELTAPATCH = "lib/AutoConnect/src/updateserver/python3/deltapatch.py";
+const int SPLITS = 10;
+const size_t MAX_PIECE = 2000;
+
+std::string workDir;
+
+std::vector<uint8_t> readFile(const std::string &path)
+{
+  std::vector<uint8_t> data;
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return data;
+  int c;
+  while ((c = fgetc(f)) != EOF)
+    data.push_back((uint8_t)c);
+  fclose(f);
+  return data;
+}
+
+void writeFile(const std::string &path, const std::vector<uint8_t> &data)
+{
+  FILE *f = fopen(path.c_str(), "wb");
+  TEST_ASSERT_NOT_NULL(f);
+  fwrite(data.data(), 1, data.size(), f);
+  fclose(f);
+}
+
+// Hex MD5 of a file, as ESP.getSketchMD5 returns for the running image
+std::string md5File(const std::string &path)
+{
+  std::string cmd = "md5sum " + path;
+  char hex[33] = "";
+  FILE *p = popen(cmd.c_str(), "r");
+  TEST_ASSERT_NOT_NULL(p);
+  TEST_ASSERT_EQUAL(1, fscanf(p, "%32s", hex));
+  pclose(p);
+  return hex;
+}
+
+std::vector<uint8_t> deltapatch(const std::vector<uint8_t> &oldImage, const std::vector<uint8_t> &newImage)
+{
+  std::string oldPath = workDir + "/old.bin";
+  std::string newPath = workDir + "/new.bin";
+  std::string patchPath = workDir + "/patch.bin";
+  writeFile(oldPath, oldImage);
+  writeFile(newPath, newImage);
+  std::string cmd = "python3 " + std::string(DELTAPATCH) + " " + oldPath + " " + newPath + " " + patchPath + " > /dev/null";
+  TEST_ASSERT_EQUAL(0, system(cmd.c_str()));
+  return readFile(patchPath);
+}
+
+uint32_t seed = 1;
+uint32_t next(void)
+{
+  return seed = seed * 1103515245 + 12345;
+}
+
+// Instruction-like words mixed with strings
+std::vector<uint8_t> codeImage(size_t size)
+{
+  const char *strings[] = {"AutoConnect", "/_ac/update", "SmartMatrix", "application/json", "Content-Length"};
+  std::vector<uint8_t> code;
+  while (code.size() < size)
+  {
+    uint32_t r = next() >> 8;
+    if (r % 5 == 0)
+    {
+      const char *s = strings[r % 3 + (r >> 20) % 3];
+      code.insert(code.end(), s, s + strlen(s) + 1);
+    }
+    else
+    {
+      code.push_back(0x20 | (r & 0x0f));
+      code.push_back((r >> 4) & 0x3f);
+      code.push_back(r >> 12);
+    }
+  }
+  code.resize(size);
+  return code;
+}
+
+struct Pair
+{
+  const char *name;
+  std::vector<uint8_t> oldImage;
+  std::vector<uint8_t> newImage;
+};
+
+// Deterministic pairs of the old and the new image
+std::vector<Pair> generatePairs(void)
+{
+  std::vector<Pair> pairs;
+  const std::vector<uint8_t> base = codeImage(20000);
+
+  pairs.push_back({"identical", base, base});
+
+  std::vector<uint8_t> edited = base;
+  for (int i = 0; i < 40; i++)
+    edited[next() % edited.size()] += 1 + next() % 255;
+  pairs.push_back({"scattered edits", base, edited});
+
+  std::vector<uint8_t> inserted = base;
+  std::vector<uint8_t> block = codeImage(700);
+  inserted.insert(inserted.begin() + 5000, block.begin(), block.end());
+  pairs.push_back({"inserted block", base, inserted});
+
+  std::vector<uint8_t> deleted = base;
+  deleted.erase(deleted.begin() + 8000, deleted.begin() + 9500);
+  pairs.push_back({"deleted block", base, deleted});
+
+  // the relocated tail makes the source position seek backwards
+  std::vector<uint8_t> moved(base.begin() + 15000, base.end());
+  moved.insert(moved.end(), base.begin(), base.begin() + 15000);
+  pairs.push_back({"moved block", base, moved});
+
+  std::vector<uint8_t> grown = edited;
+  std::vector<uint8_t> tail = codeImage(6000);
+  grown.insert(grown.end(), tail.begin(), tail.end());
+  pairs.push_back({"grown", base, grown});
+
+  pairs.push_back({"shrunk", base, std::vector<uint8_t>(base.begin(), base.begin() + 12345)});
+
+  std::vector<uint8_t> noise(9000);
+  for (auto &b : noise)
+    b = next() >> 16;
+  pairs.push_back({"unrelated", base, noise});
+
+  return pairs;
+}
+
+struct Result
+{
+  bool ok;
+  bool refused;
+  size_t writes;
+  std::vector<uint8_t> image;
+};
+
+// Applies the patch in pieces of random sizes, or of the given size
+Result apply(const std::vector<uint8_t> &source, const std::string &sourceMD5, const std::vector<uint8_t> &patch, size_t piece = 0)
+{
+  Result r = {true, false, 0, {}};
+  AutoConnectDelta delta(
+      [&source](uint32_t offset, uint8_t *buf, size_t size) {
+        if (offset + size > source.size())
+          return false;
+        memcpy(buf, source.data() + offset, size);
+        return true;
+      },
+      [&r](const uint8_t *buf, size_t size) {
+        r.writes++;
+        r.image.insert(r.image.end(), buf, buf + size);
+        return true;
+      },
+      [&source, &sourceMD5, &r](const AutoConnectDelta::AC_DELTAHEADER_t &header) {
+        char md5[sizeof(header.srcMD5) * 2 + 1];
+        for (size_t i = 0; i < sizeof(header.srcMD5); i++)
+          snprintf(md5 + i * 2, 3, "%02x", header.srcMD5[i]);
+        r.refused = header.srcSize != source.size() || strcasecmp(md5, sourceMD5.c_str());
+        return !r.refused;
+      });
+
+  for (size_t i = 0; i < patch.size() && r.ok;)
+  {
+    size_t n = std::min(piece ? piece : 1 + next() % MAX_PIECE, patch.size() - i);
+    r.ok = delta.feed(patch.data() + i, n) == n;
+    i += n;
+  }
+  r.ok = r.ok && delta.end();
+  return r;
+}
+
+// The image would be committed only if it is complete and has the MD5 of the header
+bool committed(const Result &r, const std::vector<uint8_t> &newImage)
+{
+  return r.ok && r.image == newImage;
+}
+
+} // namespace
+
+void setUp(void)
+{
+  seed = 1;
+}
+
+void tearDown(void) {}
+
+void test_round_trip(void)
+{
+  std::string sourcePath = workDir + "/source.bin";
+  for (const Pair &pair : generatePairs())
+  {
+    std::vector<uint8_t> patch = deltapatch(pair.oldImage, pair.newImage);
+    TEST_ASSERT_TRUE(AutoConnectDelta::isPatch(patch.data(), patch.size()));
+    writeFile(sourcePath, pair.oldImage);
+    std::string sourceMD5 = md5File(sourcePath);
+
+    for (int split = 0; split < SPLITS; split++)
+    {
+      Result r = apply(pair.oldImage, sourceMD5, patch);
+      char msg[160];
+      snprintf(msg, sizeof(msg), "%s, random split %d", pair.name, split);
+      TEST_ASSERT_TRUE_MESSAGE(r.ok, msg);
+      TEST_ASSERT_TRUE_MESSAGE(r.image == pair.newImage, msg);
+    }
+    Result bytes = apply(pair.oldImage, sourceMD5, patch, 1);
+    TEST_ASSERT_TRUE_MESSAGE(bytes.ok && bytes.image == pair.newImage, pair.name);
+
+    char line[160];
+    snprintf(line, sizeof(line), "%s: %zu to %zu bytes, patch %zu bytes", pair.name, pair.oldImage.size(), pair.newImage.size(), patch.size());
+    TEST_MESSAGE(line);
+  }
+}
+
+void test_corrupted_patch(void)
+{
+  std::vector<Pair> pairs = generatePairs();
+  const Pair &pair = pairs[2];
+  std::vector<uint8_t> patch = deltapatch(pair.oldImage, pair.newImage);
+  std::string sourcePath = workDir + "/source.bin";
+  writeFile(sourcePath, pair.oldImage);
+  std::string sourceMD5 = md5File(sourcePath);
+
+  // a flipped byte anywhere after the header
+  const size_t HEADER = 44;
+  for (int i = 0; i < 200; i++)
+  {
+    std::vector<uint8_t> corrupted = patch;
+    corrupted[HEADER + next() % (patch.size() - HEADER)] ^= 1 << (next() % 8);
+    TEST_ASSERT_FALSE(committed(apply(pair.oldImage, sourceMD5, corrupted), pair.newImage));
+  }
+
+  // the block structure itself is refused by the applier, a seek past the source
+  std::vector<uint8_t> seek = patch;
+  seek.insert(seek.begin() + HEADER, {0xfe, 0xff, 0x03, 0, 0});
+  TEST_ASSERT_FALSE(apply(pair.oldImage, sourceMD5, seek).ok);
+
+  std::vector<uint8_t> truncated(patch.begin(), patch.end() - 1);
+  TEST_ASSERT_FALSE(apply(pair.oldImage, sourceMD5, truncated).ok);
+
+  std::vector<uint8_t> trailing = patch;
+  trailing.push_back(0);
+  TEST_ASSERT_FALSE(apply(pair.oldImage, sourceMD5, trailing).ok);
+
+  std::vector<uint8_t> magic = patch;
+  magic[3] = '2';
+  TEST_ASSERT_FALSE(AutoConnectDelta::isPatch(magic.data(), magic.size()));
+  TEST_ASSERT_FALSE(apply(pair.oldImage, sourceMD5, magic).ok);
+}
+
+void test_source_mismatch(void)
+{
+  std::vector<Pair> pairs = generatePairs();
+  const Pair &pair = pairs[1];
+  std::vector<uint8_t> patch = deltapatch(pair.oldImage, pair.newImage);
+  std::string sourcePath = workDir + "/source.bin";
+
+  // same size, another MD5
+  std::vector<uint8_t> other = pair.oldImage;
+  other[other.size() / 3] ^= 0x01;
+  writeFile(sourcePath, other);
+  Result r = apply(other, md5File(sourcePath), patch);
+  TEST_ASSERT_FALSE(r.ok);
+  TEST_ASSERT_TRUE(r.refused);
+  TEST_ASSERT_EQUAL(0, r.writes);
+
+  // another size
+  std::vector<uint8_t> shorter(pair.oldImage.begin(), pair.oldImage.end() - 16);
+  writeFile(sourcePath, shorter);
+  r = apply(shorter, md5File(sourcePath), patch);
+  TEST_ASSERT_FALSE(r.ok);
+  TEST_ASSERT_TRUE(r.refused);
+  TEST_ASSERT_EQUAL(0, r.writes);
+
+  // the right image is still accepted
+  writeFile(sourcePath, pair.oldImage);
+  r = apply(pair.oldImage, md5File(sourcePath), patch);
+  TEST_ASSERT_FALSE(r.refused);
+  TEST_ASSERT_TRUE(committed(r, pair.newImage));
+}
+
+int main(int argc, char **argv)
+{
+  char dir[] = "/tmp/deltapatchXXXXXX";
+  if (!mkdtemp(dir))
+    return 1;
+  workDir = dir;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_corrupted_patch);
+  RUN_TEST(test_source_mismatch);
+  int result = UNITY_END();
+
+  system(("rm -rf " + workDir).c_str());
+  return result;
+}
@@ -0,0 +1,197 @@
+/*
+  Round trip of otacompress.py through AutoConnectExpander.
+
+  Every image of the corpus is compressed by the script with a few
+  window and lookahead settings and the output is fed to the expander
+  in pieces of several sizes, from single bytes to a TCP segment and
+  more than a window. The corpus holds generated images that cover the
+  window wrap-around, incompressible data and long runs, plus the
+  firmware.bin of every environment built under .pio/build.
+  The script is run with python3 from the project directory.
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include <glob.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "AutoConnectExpander.cpp"
+
+namespace
+{
+
+const char *OTACOMPRESS = "lib/AutoConnect/src/updateserver/python3/otacompress.py";
+const size_t CHUNKS[] = {1, 7, 64, 1460, 5000};
+
+struct Setting
+{
+  int window;
+  int lookahead;
+};
+const Setting SETTINGS[] = {{12, 5}, {8, 4}, {10, 3}};
+
+std::string workDir;
+
+std::vector<uint8_t> readFile(const std::string &path)
+{
+  std::vector<uint8_t> data;
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return data;
+  int c;
+  while ((c = fgetc(f)) != EOF)
+    data.push_back((uint8_t)c);
+  fclose(f);
+  return data;
+}
+
+void writeFile(const std::string &path, const std::vector<uint8_t> &data)
+{
+  FILE *f = fopen(path.c_str(), "wb");
+  TEST_ASSERT_NOT_NULL(f);
+  fwrite(data.data(), 1, data.size(), f);
+  fclose(f);
+}
+
+int otacompress(const std::string &in, const std::string &out, const Setting &s)
+{
+  char cmd[512];
+  snprintf(cmd, sizeof(cmd), "python3 %s -w %d -l %d %s %s > /dev/null", OTACOMPRESS, s.window, s.lookahead, in.c_str(), out.c_str());
+  return system(cmd);
+}
+
+// Deterministic images of the corpus
+std::vector<std::string> generateCorpus(void)
+{
+  std::vector<std::string> corpus;
+  uint32_t seed = 1;
+  auto next = [&seed]() { return seed = seed * 1103515245 + 12345; };
+  auto add = [&](const char *name, const std::vector<uint8_t> &data) {
+    std::string path = workDir + "/" + name;
+    writeFile(path, data);
+    corpus.push_back(path);
+  };
+
+  add("one.bin", {0xe9});
+
+  add("zeros.bin", std::vector<uint8_t>(10000, 0));
+
+  std::vector<uint8_t> noise(9000);
+  for (auto &b : noise)
+    b = next() >> 16;
+  add("noise.bin", noise);
+
+  // Instruction-like words mixed with strings, spanning several windows
+  std::vector<uint8_t> code;
+  const char *strings[] = {"AutoConnect", "/_ac/update", "SmartMatrix", "application/json", "Content-Length"};
+  while (code.size() < 3 * 4096 + 17)
+  {
+    uint32_t r = next() >> 8;
+    if (r % 5 == 0)
+    {
+      const char *s = strings[r % 3 + (r >> 20) % 3];
+      code.insert(code.end(), s, s + strlen(s) + 1);
+    }
+    else
+    {
+      code.push_back(0x20 | (r & 0x0f));
+      code.push_back((r >> 4) & 0x3f);
+      code.push_back(r >> 12);
+    }
+  }
+  add("code.bin", code);
+
+  glob_t builds;
+  if (!glob(".pio/build/*/firmware.bin", 0, nullptr, &builds))
+  {
+    for (size_t i = 0; i < builds.gl_pathc; i++)
+      corpus.push_back(builds.gl_pathv[i]);
+    globfree(&builds);
+  }
+  return corpus;
+}
+
+std::vector<uint8_t> expand(const std::vector<uint8_t> &image, size_t chunk, bool &ok)
+{
+  std::vector<uint8_t> out;
+  AutoConnectExpander expander([&out](const uint8_t *buf, size_t size) {
+    out.insert(out.end(), buf, buf + size);
+    return true;
+  });
+  ok = true;
+  for (size_t i = 0; i < image.size() && ok; i += chunk)
+  {
+    size_t n = std::min(chunk, image.size() - i);
+    ok = expander.feed(image.data() + i, n) == n;
+  }
+  ok = ok && expander.end();
+  return out;
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_round_trip(void)
+{
+  std::vector<std::string> corpus = generateCorpus();
+  std::string compressed = workDir + "/image.acz";
+  for (const std::string &path : corpus)
+  {
+    std::vector<uint8_t> original = readFile(path);
+    for (const Setting &s : SETTINGS)
+    {
+      TEST_ASSERT_EQUAL_MESSAGE(0, otacompress(path, compressed, s), path.c_str());
+      std::vector<uint8_t> image = readFile(compressed);
+      TEST_ASSERT_TRUE(AutoConnectExpander::isCompressed(image.data(), image.size()));
+      for (size_t chunk : CHUNKS)
+      {
+        bool ok;
+        std::vector<uint8_t> out = expand(image, chunk, ok);
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%s -w %d -l %d, %zu byte pieces", path.c_str(), s.window, s.lookahead, chunk);
+        TEST_ASSERT_TRUE_MESSAGE(ok, msg);
+        TEST_ASSERT_TRUE_MESSAGE(out == original, msg);
+      }
+    }
+    char line[160];
+    snprintf(line, sizeof(line), "%s: %zu bytes", path.c_str(), original.size());
+    TEST_MESSAGE(line);
+  }
+}
+
+void test_corrupted_image(void)
+{
+  std::string compressed = workDir + "/image.acz";
+  TEST_ASSERT_EQUAL(0, otacompress(workDir + "/code.bin", compressed, SETTINGS[0]));
+  std::vector<uint8_t> image = readFile(compressed);
+  image[image.size() / 2] ^= 0x10;
+  bool ok;
+  expand(image, 1460, ok);
+  TEST_ASSERT_FALSE(ok);
+}
+
+void test_empty_input_refused(void)
+{
+  std::string empty = workDir + "/empty.bin";
+  writeFile(empty, std::vector<uint8_t>());
+  TEST_ASSERT_NOT_EQUAL(0, otacompress(empty, workDir + "/empty.acz", SETTINGS[0]));
+}
+
+int main(int argc, char **argv)
+{
+  char dir[] = "/tmp/otacompressXXXXXX";
+  if (!mkdtemp(dir))
+    return 1;
+  workDir = dir;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_corrupted_image);
+  RUN_TEST(test_empty_input_refused);
+  int result = UNITY_END();
+
+  system(("rm -rf " + workDir).c_str());
+  return result;
+}
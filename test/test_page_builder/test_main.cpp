@@ -0,0 +1,265 @@
+/*
+  Host test and benchmark of PageBuilder page generation.
+
+  Small fixture pages built like AutoConnect's portal pages (a head, CSS
+  fragments in PROGMEM, a menu and a status table with many rows) are
+  served through PageBuilder::handle and the number of pages per second
+  is reported. Each request builds its PageElement and token bindings
+  like AutoConnect does. The same molds are also served as file: molds,
+  which are still read lexically one character at a time, and every
+  transfer of the compiled molds must match that output: the ByteStream
+  build, and the chunked transfer that fills the tokens and then sends
+  the literal spans and fragments straight from the mold. A chunked
+  transfer must not send an empty chunk before its end, as that
+  terminates the response.
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include "PageBuilder.cpp"
+#include "PageStream.cpp"
+
+namespace
+{
+
+const unsigned REQUESTS = 2000;
+const int TABLE_ROWS = 40;
+
+const char ELM_HEAD[] PROGMEM = {
+  "<!DOCTYPE html>"
+  "<html>"
+  "<head>"
+  "<meta charset=\"UTF-8\" name=\"viewport\" content=\"width=device-width,initial-scale=1\">"
+};
+
+const char CSS_BASE[] PROGMEM = {
+  "html{font-family:Helvetica,Arial,sans-serif;font-size:16px}"
+  "body{margin:0;padding:0}"
+  ".base-panel{margin:0 22px 0 22px}"
+};
+
+// fragments are sent as they are, a token in one is not replaced
+const char CSS_TABLE[] PROGMEM = {
+  "table.info{border:none;width:100%}"
+  "table.info td{padding:0.2em}"
+  "/*{{NOT_A_TOKEN}}*/"
+};
+
+const char ELM_MENU_PRE[] PROGMEM = {
+  "<header id=\"lb\" class=\"lb-fixed\"><ul class=\"lb-navigation\">"
+};
+
+const char ELM_MENU_POST[] PROGMEM = {
+  "</ul></header>"
+};
+
+// starts with a token, and tokens next to each other leave empty spans
+const char PAGE_STAT[] PROGMEM = {
+  "{{HEAD}}"
+    "<title>Statistics</title>"
+    "<style type=\"text/css\">"
+      "{{CSS_BASE}}{{CSS_TABLE}}"
+    "</style>"
+  "</head>"
+  "<body>"
+    "{{MENU_PRE}}{{MENU_AUX}}{{MENU_POST}}"
+    "<div class=\"base-panel\">"
+      "<table class=\"info\">"
+        "<tr><td>Established connection</td><td>{{ESTAB_SSID}}</td></tr>"
+        "<tr><td>Mode</td><td>{{WIFI_MODE}}({{WIFI_STATUS}})</td></tr>"
+        "<tr><td>IP</td><td>{{LOCAL_IP}}</td></tr>"
+        "{{ROWS}}"
+      "</table>"
+    "</div>"
+  "</body>"
+  "</html>"
+};
+
+// a page of one block
+const char PAGE_SMALL[] PROGMEM = {
+  "{{HEAD}}<title>{{TITLE}}</title></head><body>{{MENU_AUX}}<p>{{UPTIME}}</p></body></html>"
+};
+
+String text(const char *s) { return String(s); }
+
+void headTokens(PageElement &elm)
+{
+  elm.addToken(FPSTR("HEAD"), FPSTR(ELM_HEAD));
+  // an empty replacement, like the menu of a page with no custom pages
+  elm.addToken(FPSTR("MENU_AUX"), [](PageArgument &) { return String(); });
+}
+
+void statTokens(PageElement &elm)
+{
+  headTokens(elm);
+  elm.addToken(FPSTR("CSS_BASE"), FPSTR(CSS_BASE));
+  elm.addToken(FPSTR("CSS_TABLE"), FPSTR(CSS_TABLE));
+  elm.addToken(FPSTR("MENU_PRE"), [](PageArgument &) { return String(FPSTR(ELM_MENU_PRE)); });
+  elm.addToken(FPSTR("MENU_POST"), FPSTR(ELM_MENU_POST));
+  elm.addToken(FPSTR("ESTAB_SSID"), [](PageArgument &) { return text("lights-net"); });
+  elm.addToken(FPSTR("WIFI_MODE"), [](PageArgument &) { return text("STA"); });
+  elm.addToken(FPSTR("WIFI_STATUS"), [](PageArgument &) { return String(3); });
+  elm.addToken(FPSTR("LOCAL_IP"), [](PageArgument &) { return text("192.168.1.42"); });
+  elm.addToken(FPSTR("ROWS"), [](PageArgument &) {
+    String rows;
+    for (int i = 0; i < TABLE_ROWS; i++)
+    {
+      char row[80];
+      snprintf(row, sizeof(row), "<tr><td>network-%d</td><td>%d dBm</td></tr>", i, -40 - i);
+      rows += row;
+    }
+    return rows;
+  });
+}
+
+void smallTokens(PageElement &elm)
+{
+  headTokens(elm);
+  elm.addToken(FPSTR("TITLE"), [](PageArgument &) { return text("Uptime"); });
+  elm.addToken(FPSTR("UPTIME"), [](PageArgument &) { return text("3 days 04:12:55"); });
+}
+
+struct Page
+{
+  const char *name;
+  const char *uri;
+  const char *mold;
+  const char *file;
+  void (*tokens)(PageElement &);
+};
+
+const Page pages[] = {
+    {"status", "/_ac", PAGE_STAT, "/stat.htm", statTokens},
+    {"small", "/_ac/uptime", PAGE_SMALL, "/small.htm", smallTokens},
+};
+
+std::string filePath(const Page &page)
+{
+  return std::string(PAGEELEMENT_TOKENIDENTIFIER_FILE) + page.file;
+}
+
+// One request as AutoConnect serves it: a fresh element and bindings
+void serve(ESP8266WebServer &server, const Page &page, const char *mold, PageBuilder::TransferEncoding_t enc = PageBuilder::ByteStream)
+{
+  PageElement elm(mold);
+  page.tokens(elm);
+  PageBuilder builder(page.uri, {elm}, HTTP_ANY, true, false, enc);
+  server.reset();
+  TEST_ASSERT_TRUE(builder.handle(server, HTTP_GET, String(page.uri)));
+  TEST_ASSERT_EQUAL(200, server.code);
+  TEST_ASSERT_TRUE(server.finalized);
+  TEST_ASSERT_EQUAL(0, server.lateChunks);
+}
+
+double pagesPerSecond(ESP8266WebServer &server, const Page &page, const char *mold)
+{
+  unsigned long start = micros();
+  for (unsigned i = 0; i < REQUESTS; i++)
+    serve(server, page, mold);
+  return REQUESTS * 1e6 / (micros() - start);
+}
+
+} // namespace
+
+void setUp(void)
+{
+  for (auto &page : pages)
+    LittleFS.put(page.file, page.mold);
+}
+
+void tearDown(void) {}
+
+void test_pages_per_second(void)
+{
+  ESP8266WebServer server;
+
+  for (auto &page : pages)
+  {
+    std::string path = filePath(page);
+    serve(server, page, path.c_str());
+    std::string lexical = server.body;
+    serve(server, page, page.mold);
+    TEST_ASSERT_TRUE(server.body == lexical);
+    for (size_t chunk : server.chunks)
+      TEST_ASSERT_LESS_OR_EQUAL(PAGEBUILDER_CONTENTBLOCK_SIZE, chunk);
+    // the status page takes more than one block
+    if (page.mold == PAGE_STAT)
+      TEST_ASSERT_GREATER_THAN(1, server.chunks.size());
+
+    double spans = pagesPerSecond(server, page, page.mold);
+    double chars = pagesPerSecond(server, page, path.c_str());
+
+    char line[160];
+    snprintf(line, sizeof(line), "%s: %zu bytes, %.0f pages/s from spans, %.0f pages/s read lexically",
+             page.name, lexical.size(), spans, chars);
+    TEST_MESSAGE(line);
+  }
+}
+
+void test_chunked_fill_send(void)
+{
+  ESP8266WebServer server;
+
+  for (auto &page : pages)
+  {
+    std::string path = filePath(page);
+    serve(server, page, path.c_str());
+    std::string lexical = server.body;
+
+    serve(server, page, page.mold, PageBuilder::Chunked);
+    TEST_ASSERT_TRUE(server.body == lexical);
+    TEST_ASSERT_EQUAL(CONTENT_LENGTH_UNKNOWN, server.contentLength);
+
+    // the fragments go out as they are in flash, one chunk each
+    size_t head = 0;
+    for (size_t chunk : server.chunks)
+      if (chunk == strlen_P(ELM_HEAD))
+        head++;
+    TEST_ASSERT_EQUAL(1, head);
+
+    // a file: mold has no spans and is built whole in the chunked transfer
+    serve(server, page, path.c_str(), PageBuilder::Chunked);
+    TEST_ASSERT_TRUE(server.body == lexical);
+  }
+
+  // the elements of a page are sent one after another
+  PageElement stat(PAGE_STAT), small(PAGE_SMALL);
+  statTokens(stat);
+  smallTokens(small);
+  PageBuilder builder("/both", {stat, small}, HTTP_ANY, true, false, PageBuilder::Chunked);
+  server.reset();
+  TEST_ASSERT_TRUE(builder.handle(server, HTTP_GET, String("/both")));
+  TEST_ASSERT_TRUE(server.finalized);
+  TEST_ASSERT_EQUAL(0, server.lateChunks);
+  std::string both = server.body;
+
+  std::string expected;
+  for (auto &page : pages)
+  {
+    serve(server, page, filePath(page).c_str());
+    expected += server.body;
+  }
+  TEST_ASSERT_TRUE(both == expected);
+  TEST_ASSERT_TRUE(expected.find("{{NOT_A_TOKEN}}") != std::string::npos);
+}
+
+void test_page_stream_read_bytes(void)
+{
+  String content("0123456789abcdefghijklmnopqrstuvwxyz");
+  WiFiClient client;
+  PageStream stream(content, client);
+  std::string read;
+  char buf[7];
+  size_t n;
+  while ((n = stream.readBytes(buf, sizeof(buf))))
+    read.append(buf, n);
+  TEST_ASSERT_EQUAL_STRING(content.c_str(), read.c_str());
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pages_per_second);
+  RUN_TEST(test_chunked_fill_send);
+  RUN_TEST(test_page_stream_read_bytes);
+  return UNITY_END();
+}
@@ -0,0 +1,429 @@
+/*
+  Heap soak of ResponseWriter against String concatenation.
+
+  Both variants produce the same /status style body for a few thousand
+  requests on a simulated 40 KB first-fit heap, the allocator model of
+  umm_malloc on the ESP8266. The concatenating handler grows its String
+  with an exact-size realloc on every +=, like the Arduino String, and
+  formats numbers through String temporaries. ResponseWriter runs for
+  real: every host allocation made while it builds the body is mirrored
+  on the simulated heap, so a String or buffer it allocated would show
+  up there. Meanwhile other blocks of the system come and go (client
+  objects, pbufs), each living for a few requests. The largest free block and the fragmentation percentage are
+  reported the way ESP.getMaxFreeBlockSize() and
+  ESP.getHeapFragmentation() compute them.
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include <map>
+#include <new>
+#include "ResponseWriter.cpp"
+
+namespace
+{
+
+const size_t HEAP_SIZE = 40 * 1024;
+const size_t HEAP_ALIGN = 8;
+const unsigned SOAK_REQUESTS = 5000;
+const unsigned CHURN_LIFETIME = 3; // requests a system block stays allocated
+
+class SimHeap
+{
+public:
+  SimHeap() : _allocations(0) {}
+
+  size_t malloc(size_t size)
+  {
+    size = _round(size);
+    size_t offset = 0;
+    for (auto &block : _used)
+    {
+      if (block.first - offset >= size)
+        break;
+      offset = block.first + block.second;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(offset + size <= HEAP_SIZE, "simulated heap exhausted");
+    _used[offset] = size;
+    _allocations++;
+    return offset;
+  }
+
+  // Grow in place when the following space is free, else move
+  size_t realloc(size_t offset, size_t size)
+  {
+    size = _round(size);
+    auto it = _used.find(offset);
+    auto next = std::next(it);
+    size_t limit = next == _used.end() ? HEAP_SIZE : next->first;
+    if (offset + size <= limit)
+    {
+      it->second = size;
+      return offset;
+    }
+    _used.erase(it);
+    return malloc(size);
+  }
+
+  void free(size_t offset) { _used.erase(offset); }
+
+  size_t maxFreeBlock() const
+  {
+    size_t best = 0;
+    _eachGap([&](size_t gap) { best = std::max(best, gap); });
+    return best;
+  }
+
+  // 100 - sqrt(sum(free^2)) * 100 / sum(free), as in the ESP8266 core
+  unsigned fragmentation() const
+  {
+    double total = 0, squares = 0;
+    _eachGap([&](size_t gap) {
+      total += gap;
+      squares += (double)gap * gap;
+    });
+    return total ? (unsigned)(100 - sqrt(squares) * 100 / total) : 0;
+  }
+
+  unsigned allocations() const { return _allocations; }
+
+private:
+  static size_t _round(size_t size) { return (size + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1); }
+
+  template <typename F>
+  void _eachGap(F f) const
+  {
+    size_t offset = 0;
+    for (auto &block : _used)
+    {
+      if (block.first > offset)
+        f(block.first - offset);
+      offset = block.first + block.second;
+    }
+    if (HEAP_SIZE > offset)
+      f(HEAP_SIZE - offset);
+  }
+
+  std::map<size_t, size_t> _used; // offset -> size
+  unsigned _allocations;
+};
+
+SimHeap heap;
+
+// Host allocations mirrored on the simulated heap while trackHeap is set.
+// The table is fixed so that recording a block allocates nothing.
+bool trackHeap = false;
+const size_t MIRROR_SLOTS = 256;
+struct Mirror
+{
+  void *ptr;
+  size_t block;
+} mirrors[MIRROR_SLOTS];
+
+void mirrorAllocation(void *ptr, size_t size)
+{
+  trackHeap = false; // SimHeap itself allocates
+  for (auto &m : mirrors)
+  {
+    if (!m.ptr)
+    {
+      m.ptr = ptr;
+      m.block = heap.malloc(size);
+      trackHeap = true;
+      return;
+    }
+  }
+  TEST_FAIL_MESSAGE("too many mirrored allocations");
+}
+
+void mirrorRelease(void *ptr)
+{
+  for (auto &m : mirrors)
+  {
+    if (m.ptr == ptr)
+    {
+      m.ptr = nullptr;
+      bool tracking = trackHeap;
+      trackHeap = false;
+      heap.free(m.block);
+      trackHeap = tracking;
+      return;
+    }
+  }
+}
+
+// Builds a body with host allocations mirrored on the simulated heap
+template <typename F>
+void tracked(F f)
+{
+  trackHeap = true;
+  f();
+  trackHeap = false;
+}
+
+// Arduino String growth on the simulated heap: every concat reallocates
+// the buffer to exactly the new length.
+class SimString
+{
+public:
+  SimString() : _block(0), _len(0), _allocated(false) {}
+  ~SimString()
+  {
+    if (_allocated)
+      heap.free(_block);
+  }
+
+  void concat(const char *s, size_t n)
+  {
+    size_t size = _len + n + 1;
+    _block = _allocated ? heap.realloc(_block, size) : heap.malloc(size);
+    _allocated = true;
+    _text.append(s, n);
+    _len += n;
+  }
+
+  const std::string &text() const { return _text; }
+
+private:
+  size_t _block;
+  size_t _len;
+  bool _allocated;
+  std::string _text;
+};
+
+// The two ways the handler emits its body
+struct ConcatOut
+{
+  SimString body;
+  void literal(const char *s) { body.concat(s, strlen(s)); }
+  void number(unsigned long v)
+  {
+    SimString temp; // String(v)
+    std::string digits = std::to_string(v);
+    temp.concat(digits.c_str(), digits.size());
+    body.concat(digits.c_str(), digits.size());
+  }
+};
+
+struct WriterOut
+{
+  ResponseWriter &writer;
+  void literal(const char *s)
+  {
+    tracked([&]() { writer.print(F(s)); });
+  }
+  void number(unsigned long v)
+  {
+    tracked([&]() { writer.print(v); });
+  }
+};
+
+// Blocks owned by the rest of the system, each released a few requests
+// after it was allocated
+class Churn
+{
+public:
+  Churn() : _next(0)
+  {
+    for (auto &slot : _slot)
+      slot.live = false;
+  }
+  ~Churn() { releaseAll(); }
+
+  void step(unsigned request)
+  {
+    Slot &slot = _slot[_next];
+    if (slot.live)
+      heap.free(slot.block);
+    slot.block = heap.malloc(96 + (request * 37) % 480);
+    slot.live = true;
+    _next = (_next + 1) % CHURN_LIFETIME;
+  }
+
+  void releaseAll()
+  {
+    for (auto &slot : _slot)
+    {
+      if (slot.live)
+        heap.free(slot.block);
+      slot.live = false;
+    }
+  }
+
+private:
+  struct Slot
+  {
+    size_t block;
+    bool live;
+  } _slot[CHURN_LIFETIME];
+  unsigned _next;
+};
+
+template <typename Out>
+void statusBody(Out &out, Churn &churn, unsigned request)
+{
+  out.literal("{\"type\":\"LittleFS\", \"isOk\":\"true\", \"totalBytes\":\"");
+  out.number(1024000);
+  out.literal("\", \"usedBytes\":\"");
+  out.number(81920 + request);
+  out.literal("\",\"unsupportedFiles\":\"\",\"freeHeap\":");
+  out.number(30000 - request % 1000);
+  // Something else allocates while the response is being built
+  churn.step(request);
+  out.literal(",\"maxFreeBlock\":");
+  out.number(20000 + request % 777);
+  out.literal(",\"heapFragmentation\":");
+  out.number(request % 50);
+  out.literal(",\"bootToConnected\":");
+  out.number(2150);
+  out.literal(",\"bootToFirstFrame\":");
+  out.number(840);
+  out.literal(",\"fastReconnect\":true,\"handleClientMaxUs\":");
+  out.number(1200 + request % 300);
+  out.literal(",\"otaFrames\":");
+  out.number(request);
+  out.literal("}");
+}
+
+struct SoakResult
+{
+  size_t maxFreeBefore;
+  size_t maxFreeAfter;
+  size_t maxFreeWorst;
+  unsigned fragmentationAfter;
+  unsigned fragmentationWorst;
+  unsigned bodyAllocations;
+  std::vector<std::string> bodies;
+};
+
+template <typename Request>
+SoakResult soak(Request request)
+{
+  SoakResult r;
+  Churn churn;
+  r.maxFreeBefore = r.maxFreeWorst = heap.maxFreeBlock();
+  r.fragmentationWorst = heap.fragmentation();
+  r.bodyAllocations = 0;
+  for (unsigned i = 0; i < SOAK_REQUESTS; i++)
+  {
+    unsigned before = heap.allocations();
+    r.bodies.push_back(request(churn, i));
+    r.bodyAllocations += heap.allocations() - before - 1; // minus the churn block
+    r.maxFreeWorst = std::min(r.maxFreeWorst, heap.maxFreeBlock());
+    r.fragmentationWorst = std::max(r.fragmentationWorst, heap.fragmentation());
+  }
+  r.maxFreeAfter = heap.maxFreeBlock();
+  r.fragmentationAfter = heap.fragmentation();
+  churn.releaseAll();
+  TEST_ASSERT_EQUAL(HEAP_SIZE, heap.maxFreeBlock());
+  return r;
+}
+
+void report(const char *name, const SoakResult &r)
+{
+  char line[160];
+  snprintf(line, sizeof(line), "%s: maxFreeBlock %zu before, %zu after, %zu worst; fragmentation %u%% after, %u%% worst; %u body allocations",
+           name, r.maxFreeBefore, r.maxFreeAfter, r.maxFreeWorst, r.fragmentationAfter, r.fragmentationWorst, r.bodyAllocations);
+  TEST_MESSAGE(line);
+}
+
+} // namespace
+
+void *operator new(size_t size)
+{
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  if (trackHeap)
+    mirrorAllocation(ptr, size);
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (ptr)
+    mirrorRelease(ptr);
+  free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_soak_fragmentation(void)
+{
+  ESP8266WebServer server;
+  // the stand-in server collects what would go to the socket, keep it off the heap being measured
+  server.body.reserve(4096);
+  server.chunks.reserve(64);
+
+  // a String made while tracking lands on the simulated heap
+  unsigned before = heap.allocations();
+  tracked([]() { String probe("mirrored on the simulated heap"); });
+  TEST_ASSERT_GREATER_THAN(before, heap.allocations());
+  TEST_ASSERT_EQUAL(HEAP_SIZE, heap.maxFreeBlock());
+
+  SoakResult concat = soak([](Churn &churn, unsigned i) {
+    ConcatOut out;
+    statusBody(out, churn, i);
+    return out.body.text();
+  });
+
+  SoakResult writer = soak([&](Churn &churn, unsigned i) {
+    server.reset();
+    {
+      ResponseWriter json(server);
+      json.begin(200, "application/json");
+      WriterOut out{json};
+      statusBody(out, churn, i);
+    }
+    TEST_ASSERT_TRUE(server.finalized);
+    TEST_ASSERT_EQUAL(CONTENT_LENGTH_UNKNOWN, server.contentLength);
+    for (size_t chunk : server.chunks)
+      TEST_ASSERT_LESS_OR_EQUAL(RESPONSE_ARENA_SIZE, chunk);
+    return server.body;
+  });
+
+  report("String +=", concat);
+  report("ResponseWriter", writer);
+
+  TEST_ASSERT_TRUE(concat.bodies == writer.bodies);
+  TEST_ASSERT_EQUAL(0, writer.bodyAllocations);
+  TEST_ASSERT_GREATER_THAN(0, concat.bodyAllocations);
+  TEST_ASSERT_GREATER_OR_EQUAL(concat.maxFreeWorst, writer.maxFreeWorst);
+  TEST_ASSERT_GREATER_OR_EQUAL(concat.maxFreeAfter, writer.maxFreeAfter);
+  TEST_ASSERT_LESS_OR_EQUAL(concat.fragmentationWorst, writer.fragmentationWorst);
+}
+
+void test_body_larger_than_arena(void)
+{
+  ESP8266WebServer server;
+  std::string expected;
+  {
+    ResponseWriter message(server);
+    message.begin(404, F("text/plain"));
+    for (int i = 0; i < 100; i++)
+    {
+      message.print(F("NAME:arg"));
+      message.print(i);
+      message.print('\n');
+      expected += "NAME:arg" + std::to_string(i) + "\n";
+    }
+  }
+  TEST_ASSERT_EQUAL(404, server.code);
+  TEST_ASSERT_TRUE(server.body == expected);
+  TEST_ASSERT_GREATER_THAN(1, server.chunks.size());
+  for (size_t i = 0; i + 1 < server.chunks.size(); i++)
+    TEST_ASSERT_EQUAL(RESPONSE_ARENA_SIZE, server.chunks[i]);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_soak_fragmentation);
+  RUN_TEST(test_body_larger_than_arena);
+  return UNITY_END();
+}
@@ -0,0 +1,95 @@
+/*
+  Two worker test of RowQueue_SM.
+
+  The dual core calc loads a frame buffer with two workers that pull
+  refresh rows from one queue. Two std::threads stand in for the
+  workers and claim rows until the queue is drained, for thousands of
+  random row masks and row counts. Every row in the mask must be
+  claimed exactly once, and no other row at all.
+*/
+#include <unity.h>
+#include <atomic>
+#include <stdlib.h>
+#include <thread>
+#include "RowQueue_SM.h"
+
+namespace
+{
+
+const int MAX_ROWS = 32;
+const int ITERATIONS = 20000;
+
+uint32_t randomMask(void)
+{
+  return (uint32_t)rand() ^ ((uint32_t)rand() << 16);
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_single_worker_order(void)
+{
+  RowQueue_SM rq;
+  rqInit(&rq, 8, 0xA5);
+
+  const int expected[] = {0, 2, 5, 7};
+  for (int row : expected)
+    TEST_ASSERT_EQUAL(row, rqClaim(&rq));
+  TEST_ASSERT_EQUAL(-1, rqClaim(&rq));
+  TEST_ASSERT_EQUAL(-1, rqClaim(&rq));
+
+  // rows past numRows are never handed out
+  rqInit(&rq, 3, 0xFFFFFFFF);
+  TEST_ASSERT_EQUAL(0, rqClaim(&rq));
+  TEST_ASSERT_EQUAL(1, rqClaim(&rq));
+  TEST_ASSERT_EQUAL(2, rqClaim(&rq));
+  TEST_ASSERT_EQUAL(-1, rqClaim(&rq));
+
+  rqInit(&rq, MAX_ROWS, 0);
+  TEST_ASSERT_EQUAL(-1, rqClaim(&rq));
+}
+
+void test_two_workers_claim_each_row_once(void)
+{
+  RowQueue_SM rq;
+  long mismatches = 0;
+  srand(1);
+
+  for (int i = 0; i < ITERATIONS; i++)
+  {
+    uint32_t mask = randomMask();
+    int numRows = 1 + rand() % MAX_ROWS;
+    std::atomic<int> claims[MAX_ROWS];
+    for (auto &c : claims)
+      c = 0;
+
+    rqInit(&rq, numRows, mask);
+    auto worker = [&rq, &claims]() {
+      int row;
+      while ((row = rqClaim(&rq)) >= 0)
+        claims[row]++;
+    };
+    std::thread a(worker), b(worker);
+    a.join();
+    b.join();
+
+    for (int row = 0; row < MAX_ROWS; row++)
+    {
+      int expected = row < numRows && (mask >> row) & 1;
+      if (claims[row] != expected)
+        mismatches++;
+    }
+  }
+
+  TEST_ASSERT_EQUAL(0, mismatches);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_single_worker_order);
+  RUN_TEST(test_two_workers_claim_each_row_once);
+  return UNITY_END();
+}
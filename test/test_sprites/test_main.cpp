@@ -0,0 +1,241 @@
+/*
+  Frame test of SMLayerSprites.
+
+  A few sprites are moved, resized, hidden and given new images at
+  random for 500 frames in each rotation. Every refresh row is compared
+  with a reference composition of the sprites in local coordinates, and
+  every row the layer reports as unchanged must be identical to the same
+  row of the previous frame. Changing atlas pixels with
+  markAtlasChanged() must mark the rows of the visible sprites on the
+  next frame, with or without a swap.
+*/
+// the layers are built as for the ESP32, whose calc skips the rows reported unchanged
+#define ESP32
+#include <Arduino.h>
+#include <unity.h>
+#include <assert.h>
+#include "Layer.cpp"
+#include "Layer_Sprites.h"
+
+namespace
+{
+
+const int WIDTH = 32;
+const int HEIGHT = 16;
+const int ATLAS_WIDTH = 24;
+const int ATLAS_HEIGHT = 12;
+const int SPRITES = 5;
+const int FRAMES = 500;
+
+const rgb24 BELOW(7, 7, 7);
+
+struct Sprite
+{
+  int x, y, atlasX, atlasY, width, height;
+  bool visible;
+};
+
+rgb24 atlas[ATLAS_WIDTH * ATLAS_HEIGHT];
+SM_SpriteSlot slots[SPRITES];
+
+bool sameColor(const rgb24 &a, const rgb24 &b)
+{
+  return a.red == b.red && a.green == b.green && a.blue == b.blue;
+}
+
+void fillAtlas(void)
+{
+  for (auto &p : atlas)
+  {
+    // a quarter of the pixels are transparent
+    if (rand() % 4 == 0)
+      p = rgb24(0, 0, 0);
+    else
+      p = rgb24((uint8_t)(rand() | 1), (uint8_t)rand(), (uint8_t)rand());
+  }
+}
+
+void hardwareToLocal(int rotation, int hardwareX, int hardwareY, int &localX, int &localY)
+{
+  switch (rotation)
+  {
+  case rotation180:
+    localX = WIDTH - 1 - hardwareX;
+    localY = HEIGHT - 1 - hardwareY;
+    break;
+  case rotation90:
+    localX = hardwareY;
+    localY = WIDTH - 1 - hardwareX;
+    break;
+  case rotation270:
+    localX = HEIGHT - 1 - hardwareY;
+    localY = hardwareX;
+    break;
+  default:
+    localX = hardwareX;
+    localY = hardwareY;
+    break;
+  }
+}
+
+// the pixel of the last visible sprite covering the local pixel, later sprites are on top
+rgb24 expectedPixel(const Sprite sprites[], int localX, int localY)
+{
+  rgb24 pixel = BELOW;
+  for (int i = 0; i < SPRITES; i++)
+  {
+    const Sprite &s = sprites[i];
+    if (!s.visible || localX < s.x || localY < s.y || localX >= s.x + s.width || localY >= s.y + s.height)
+      continue;
+    const rgb24 &p = atlas[(s.atlasY + localY - s.y) * ATLAS_WIDTH + s.atlasX + localX - s.x];
+    if (p.red || p.green || p.blue)
+      pixel = p;
+  }
+  return pixel;
+}
+
+struct FrameCheck
+{
+  long badPixels = 0;
+  long badUnchangedRows = 0;
+  long skippedRows = 0;
+  long rows = 0;
+};
+
+// refreshes every row of the frame, checking it against the sprites and the previous frame
+void checkFrame(SMLayerSprites<rgb24, 0> &layer, int rotation, const Sprite sprites[], bool first, rgb24 previous[HEIGHT][WIDTH], FrameCheck &check)
+{
+  for (int y = 0; y < HEIGHT; y++)
+  {
+    rgb24 row[WIDTH];
+    for (auto &p : row)
+      p = BELOW;
+    layer.fillRefreshRow(y, row);
+
+    for (int x = 0; x < WIDTH; x++)
+    {
+      int localX, localY;
+      hardwareToLocal(rotation, x, y, localX, localY);
+      if (!sameColor(row[x], expectedPixel(sprites, localX, localY)))
+        check.badPixels++;
+    }
+
+    check.rows++;
+    if (!first && !layer.isRowChanged(y))
+    {
+      check.skippedRows++;
+      if (memcmp(row, previous[y], sizeof(row)))
+        check.badUnchangedRows++;
+    }
+    for (int x = 0; x < WIDTH; x++)
+      previous[y][x] = row[x];
+  }
+}
+
+} // namespace
+
+void setUp(void)
+{
+  srand(1);
+  fillAtlas();
+}
+
+void tearDown(void) {}
+
+void test_random_sprites(void)
+{
+  FrameCheck check;
+
+  for (int rotation = 0; rotation < 4; rotation++)
+  {
+    SMLayerSprites<rgb24, 0> layer(slots, SPRITES, WIDTH, HEIGHT);
+    layer.setRotation((rotationDegrees)rotation);
+    layer.begin();
+    layer.enableColorCorrection(false);
+    layer.setAtlas(atlas, ATLAS_WIDTH, ATLAS_HEIGHT);
+
+    Sprite sprites[SPRITES] = {};
+    rgb24 previous[HEIGHT][WIDTH];
+    int localWidth = layer.getLocalWidth();
+    int localHeight = layer.getLocalHeight();
+
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+      for (int i = 0; i < SPRITES; i++)
+      {
+        if (rand() % 4)
+          continue;
+        Sprite &s = sprites[i];
+        s.atlasX = rand() % ATLAS_WIDTH;
+        s.atlasY = rand() % ATLAS_HEIGHT;
+        s.width = std::min(1 + rand() % 10, ATLAS_WIDTH - s.atlasX);
+        s.height = std::min(1 + rand() % 10, ATLAS_HEIGHT - s.atlasY);
+        // partly off screen now and then
+        s.x = rand() % (localWidth + 10) - 5;
+        s.y = rand() % (localHeight + 10) - 5;
+        s.visible = rand() % 4 != 0;
+        layer.setSpriteImage(i, s.atlasX, s.atlasY, s.width, s.height);
+        layer.moveSprite(i, s.x, s.y);
+        layer.showSprite(i, s.visible);
+      }
+      layer.swapBuffers(false);
+      layer.frameRefreshCallback();
+      checkFrame(layer, rotation, sprites, frame == 0, previous, check);
+    }
+  }
+
+  char line[160];
+  snprintf(line, sizeof(line), "%ld rows refreshed, %ld reported unchanged", check.rows, check.skippedRows);
+  TEST_MESSAGE(line);
+
+  TEST_ASSERT_EQUAL(0, check.badPixels);
+  TEST_ASSERT_EQUAL(0, check.badUnchangedRows);
+  // most rows of a frame are not covered by a changed sprite
+  TEST_ASSERT_GREATER_THAN(check.rows / 4, check.skippedRows);
+}
+
+void test_atlas_change_without_swap(void)
+{
+  SMLayerSprites<rgb24, 0> layer(slots, SPRITES, WIDTH, HEIGHT);
+  layer.setRotation(rotation0);
+  layer.begin();
+  layer.enableColorCorrection(false);
+  layer.setAtlas(atlas, ATLAS_WIDTH, ATLAS_HEIGHT);
+
+  Sprite sprites[SPRITES] = {};
+  sprites[0] = {4, 3, 0, 0, 8, 5, true};
+  layer.setSpriteImage(0, 0, 0, 8, 5);
+  layer.moveSprite(0, 4, 3);
+  layer.showSprite(0, true);
+  layer.swapBuffers(false);
+
+  FrameCheck check;
+  rgb24 previous[HEIGHT][WIDTH];
+  layer.frameRefreshCallback();
+  checkFrame(layer, rotation0, sprites, true, previous, check);
+
+  // nothing changed
+  layer.frameRefreshCallback();
+  for (int y = 0; y < HEIGHT; y++)
+    TEST_ASSERT_FALSE(layer.isRowChanged(y));
+
+  // new pixels under the sprite are shown on the next frame, with no swap
+  for (int x = 0; x < 8; x++)
+    atlas[2 * ATLAS_WIDTH + x] = rgb24(200, 100, (uint8_t)(50 + x));
+  layer.markAtlasChanged();
+  layer.frameRefreshCallback();
+  for (int y = 0; y < HEIGHT; y++)
+    TEST_ASSERT_EQUAL(y >= 3 && y < 8, layer.isRowChanged(y));
+  checkFrame(layer, rotation0, sprites, false, previous, check);
+
+  TEST_ASSERT_EQUAL(0, check.badPixels);
+  TEST_ASSERT_EQUAL(0, check.badUnchangedRows);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_random_sprites);
+  RUN_TEST(test_atlas_change_without_swap);
+  return UNITY_END();
+}
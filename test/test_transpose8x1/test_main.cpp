@@ -0,0 +1,116 @@
+/*
+  Host benchmark of transpose8x1 from FastLED's bitswap.h.
+
+  The block clockless controller transposes one byte of every lane per
+  colour channel of each pixel, so that each output word carries the
+  same bit of all lanes. The benchmark times that step for a frame of
+  the parallel topology against a bit-by-bit transpose, after checking
+  both variants of transpose8x1 against it.
+*/
+#include <Arduino.h>
+#include <unity.h>
+
+// bitswap.h only needs FastLED's namespace macros; the platform headers
+// pulled in by FastLED.h do not build on the host.
+#define __INC_FASTSPI_LED2_H
+#define FASTLED_NAMESPACE_BEGIN
+#define FASTLED_NAMESPACE_END
+#define FASTLED_ESP8266
+#include "bitswap.h"
+#include "bitswap.cpp"
+
+namespace
+{
+
+const int LANES = 6;
+const int LEDS_PER_LANE = 150;
+const int FRAMES = 2000;
+
+typedef union
+{
+  uint8_t bytes[8];
+  uint32_t raw[2];
+} Lines;
+
+// B[b] bit i = A[i] bit b
+void transposeBits(const uint8_t *A, uint8_t *B)
+{
+  for (int b = 0; b < 8; b++)
+  {
+    uint8_t v = 0;
+    for (int i = 0; i < 8; i++)
+      v |= ((A[i] >> b) & 1) << i;
+    B[b] = v;
+  }
+}
+
+uint8_t original[LANES][LEDS_PER_LANE * 3];
+uint8_t frame[LANES][LEDS_PER_LANE * 3];
+
+template <typename Transpose>
+double frameMicros(Transpose transpose, uint32_t &sink)
+{
+  memcpy(frame, original, sizeof(frame));
+  unsigned long start = micros();
+  for (int f = 0; f < FRAMES; f++)
+  {
+    frame[f % LANES][f % (LEDS_PER_LANE * 3)] ^= (uint8_t)f;
+    for (int k = 0; k < LEDS_PER_LANE * 3; k++)
+    {
+      Lines in, out;
+      in.raw[0] = in.raw[1] = 0;
+      for (int lane = 0; lane < LANES; lane++)
+        in.bytes[lane] = frame[lane][k];
+      transpose(in.bytes, out.bytes);
+      sink += out.raw[0] ^ out.raw[1];
+    }
+  }
+  return (double)(micros() - start) / FRAMES;
+}
+
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_transpose8x1_matches_bitwise(void)
+{
+  for (int n = 0; n < 100000; n++)
+  {
+    Lines in, fast, slow, ref;
+    for (auto &b : in.bytes)
+      b = rand();
+    transpose8x1(in.bytes, fast.bytes);
+    transpose8x1_noinline(in.bytes, slow.bytes);
+    transposeBits(in.bytes, ref.bytes);
+    TEST_ASSERT_EQUAL_MEMORY(ref.bytes, fast.bytes, 8);
+    TEST_ASSERT_EQUAL_MEMORY(ref.bytes, slow.bytes, 8);
+  }
+}
+
+void test_transpose8x1_frame_benchmark(void)
+{
+  for (auto &lane : original)
+    for (auto &b : lane)
+      b = rand();
+
+  uint32_t sinkBits = 0, sinkInline = 0, sinkCall = 0;
+  double bits = frameMicros([](uint8_t *A, uint8_t *B) { transposeBits(A, B); }, sinkBits);
+  double inlined = frameMicros([](uint8_t *A, uint8_t *B) { transpose8x1(A, B); }, sinkInline);
+  double called = frameMicros([](uint8_t *A, uint8_t *B) { transpose8x1_noinline(A, B); }, sinkCall);
+  TEST_ASSERT_EQUAL(sinkBits, sinkInline);
+  TEST_ASSERT_EQUAL(sinkBits, sinkCall);
+
+  char line[160];
+  snprintf(line, sizeof(line), "%d lanes x %d LEDs, us/frame: bitwise %.2f, transpose8x1 %.2f, transpose8x1_noinline %.2f",
+           LANES, LEDS_PER_LANE, bits, inlined, called);
+  TEST_MESSAGE(line);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_transpose8x1_matches_bitwise);
+  RUN_TEST(test_transpose8x1_frame_benchmark);
+  return UNITY_END();
+}